@@ -0,0 +1,15 @@
+/*******************************************************************************
+  Host simulation replacement for the XC32 <sys/attribs.h>
+
+  Summary:
+    Interrupt handlers are plain functions on the host; the simulator calls
+    them directly from its interrupt dispatcher (see sim/sim_cpu.c).
+ *******************************************************************************/
+
+#ifndef SIM_SYS_ATTRIBS_H
+#define SIM_SYS_ATTRIBS_H
+
+#define __ISR(...)
+#define __ISR_AT_VECTOR(...)
+
+#endif // SIM_SYS_ATTRIBS_H
@@ -0,0 +1,25 @@
+/*******************************************************************************
+  Host simulation replacement for the XC32 <sys/kmem.h>
+
+  Summary:
+    Virtual to physical address translation for DMA addresses.
+
+  Description:
+    On the host the firmware's variables have ordinary addresses. The
+    simulator is linked with -no-pie, so static buffers sit low enough that
+    masking them like a KSEG0/KSEG1 address leaves them unchanged, and the
+    DMA model (sim/sim_dma.c) can turn a physical address back into a
+    pointer. SFR addresses become 0x1F8xxxxx as on the target.
+ *******************************************************************************/
+
+#ifndef SIM_SYS_KMEM_H
+#define SIM_SYS_KMEM_H
+
+#include <stdint.h>
+
+typedef uint32_t _paddr_t;
+
+#define KVA_TO_PA(v)    ((_paddr_t)(v) & 0x1fffffffu)
+#define PA_TO_KVA1(pa)  ((uint32_t)(pa) | 0xa0000000u)
+
+#endif // SIM_SYS_KMEM_H
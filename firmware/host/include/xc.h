@@ -0,0 +1,448 @@
+/*******************************************************************************
+  Host simulation replacement for the XC32 <xc.h> device header
+
+  File Name:
+    xc.h
+
+  Summary:
+    Maps the PIC32MX250F128B SFRs used by the firmware onto simulated registers.
+
+  Description:
+    Every SFR expands to an lvalue returned by SIM_SFR_Access(), so ordinary
+    reads, writes, and the pointer arithmetic done by the EVIC and GPIO
+    PLIBs (&IEC0 + n, &LATA + port * 0x40) keep working as on the target.
+    The addresses match the device memory map, and the CLR/SET/INV aliases
+    sit at +0x4/+0x8/+0xC as on real hardware. Only registers and bits
+    referenced by the firmware are declared. Add new ones here when a PLIB
+    starts using them.
+ *******************************************************************************/
+
+#ifndef SIM_XC_H
+#define SIM_XC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// *****************************************************************************
+// Section: Simulator hooks
+// *****************************************************************************
+volatile uint32_t *SIM_SFR_Access(uint32_t address);
+uint32_t SIM_CP0_Read(unsigned reg, unsigned sel);
+void SIM_CP0_Write(unsigned reg, unsigned sel, uint32_t value);
+uint32_t SIM_InterruptsDisable(void);
+uint32_t SIM_InterruptsEnable(void);
+void SIM_SoftwareBreakpoint(void);
+
+#define SIM_SFR(addr)       (*SIM_SFR_Access(addr))
+#define SIM_SFR_BITS(t, addr) (*(volatile t *)SIM_SFR_Access(addr))
+
+// *****************************************************************************
+// Section: CP0 and builtins
+// *****************************************************************************
+#define _CP0_COUNT          9
+#define _CP0_COMPARE        11
+#define _CP0_STATUS         12
+#define _CP0_CAUSE          13
+#define _CP0_EPC            14
+#define _CP0_CONFIG         16
+
+#define _CP0_CAUSE_DC_MASK  0x08000000u
+
+#define _CP0_GET_COUNT()        SIM_CP0_Read(_CP0_COUNT, 0)
+#define _CP0_SET_COUNT(v)       SIM_CP0_Write(_CP0_COUNT, 0, (v))
+#define _CP0_GET_COMPARE()      SIM_CP0_Read(_CP0_COMPARE, 0)
+#define _CP0_SET_COMPARE(v)     SIM_CP0_Write(_CP0_COMPARE, 0, (v))
+#define _CP0_GET_STATUS()       SIM_CP0_Read(_CP0_STATUS, 0)
+#define _CP0_SET_STATUS(v)      SIM_CP0_Write(_CP0_STATUS, 0, (v))
+#define _CP0_GET_CAUSE()        SIM_CP0_Read(_CP0_CAUSE, 0)
+#define _CP0_SET_CAUSE(v)       SIM_CP0_Write(_CP0_CAUSE, 0, (v))
+#define _CP0_GET_EPC()          SIM_CP0_Read(_CP0_EPC, 0)
+
+#define __builtin_mfc0(reg, sel)        SIM_CP0_Read((reg), (sel))
+#define __builtin_mtc0(reg, sel, v)     SIM_CP0_Write((reg), (sel), (v))
+#define __builtin_disable_interrupts()  SIM_InterruptsDisable()
+#define __builtin_enable_interrupts()   SIM_InterruptsEnable()
+#define __builtin_software_breakpoint() SIM_SoftwareBreakpoint()
+
+// *****************************************************************************
+// Section: Register addresses
+// *****************************************************************************
+#define SIM_SFR_BASE        0xBF800000u
+#define SIM_SFR_END         0xBF890000u
+
+#define I2C1CON_ADDR        0xBF805000u
+#define I2C1STAT_ADDR       0xBF805010u
+#define I2C1BRG_ADDR        0xBF805040u
+#define I2C1TRN_ADDR        0xBF805050u
+#define I2C1RCV_ADDR        0xBF805060u
+
+#define U2MODE_ADDR         0xBF806200u
+#define U2STA_ADDR          0xBF806210u
+#define U2TXREG_ADDR        0xBF806220u
+#define U2RXREG_ADDR        0xBF806230u
+#define U2BRG_ADDR          0xBF806240u
+
+#define OSCCON_ADDR         0xBF80F000u
+#define PMD1_ADDR           0xBF80F240u
+#define PMD2_ADDR           0xBF80F250u
+#define PMD3_ADDR           0xBF80F260u
+#define PMD4_ADDR           0xBF80F270u
+#define PMD5_ADDR           0xBF80F280u
+#define PMD6_ADDR           0xBF80F290u
+#define U2RXR_ADDR          0xBF80FA58u
+#define RPB10R_ADDR         0xBF80FB54u
+
+#define INTCON_ADDR         0xBF881000u
+#define IFS0_ADDR           0xBF881030u
+#define IFS1_ADDR           0xBF881040u
+#define IEC0_ADDR           0xBF881060u
+#define IEC1_ADDR           0xBF881070u
+#define IPC0_ADDR           0xBF881090u
+#define IPC8_ADDR           0xBF881110u
+#define IPC9_ADDR           0xBF881120u
+#define IPC10_ADDR          0xBF881130u
+
+#define BMXCON_ADDR         0xBF882000u
+
+#define DMACON_ADDR         0xBF883000u
+#define DCH0CON_ADDR        0xBF883060u
+#define DCH0ECON_ADDR       0xBF883070u
+#define DCH0INT_ADDR        0xBF883080u
+#define DCH0SSA_ADDR        0xBF883090u
+#define DCH0DSA_ADDR        0xBF8830A0u
+#define DCH0SSIZ_ADDR       0xBF8830B0u
+#define DCH0DSIZ_ADDR       0xBF8830C0u
+#define DCH0SPTR_ADDR       0xBF8830D0u
+#define DCH0DPTR_ADDR       0xBF8830E0u
+#define DCH0CSIZ_ADDR       0xBF8830F0u
+#define DCH0CPTR_ADDR       0xBF883100u
+// channel n registers are at DCH0xxx_ADDR + n * SIM_DCH_STRIDE
+#define SIM_DCH_STRIDE      0xC0u
+#define SIM_DCH_COUNT       4u
+
+#define ANSELA_ADDR         0xBF886000u
+#define TRISA_ADDR          0xBF886010u
+#define PORTA_ADDR          0xBF886020u
+#define LATA_ADDR           0xBF886030u
+#define ANSELB_ADDR         0xBF886100u
+#define TRISB_ADDR          0xBF886110u
+#define PORTB_ADDR          0xBF886120u
+#define LATB_ADDR           0xBF886130u
+#define CNPUB_ADDR          0xBF886150u
+
+#define SIM_CLR_OFFSET      0x4u
+#define SIM_SET_OFFSET      0x8u
+#define SIM_INV_OFFSET      0xCu
+
+// *****************************************************************************
+// Section: Registers
+// *****************************************************************************
+#define I2C1CON             SIM_SFR(I2C1CON_ADDR)
+#define I2C1CONCLR          SIM_SFR(I2C1CON_ADDR + SIM_CLR_OFFSET)
+#define I2C1CONSET          SIM_SFR(I2C1CON_ADDR + SIM_SET_OFFSET)
+#define I2C1STAT            SIM_SFR(I2C1STAT_ADDR)
+#define I2C1STATCLR         SIM_SFR(I2C1STAT_ADDR + SIM_CLR_OFFSET)
+#define I2C1BRG             SIM_SFR(I2C1BRG_ADDR)
+#define I2C1TRN             SIM_SFR(I2C1TRN_ADDR)
+#define I2C1RCV             SIM_SFR(I2C1RCV_ADDR)
+
+#define U2MODE              SIM_SFR(U2MODE_ADDR)
+#define U2MODECLR           SIM_SFR(U2MODE_ADDR + SIM_CLR_OFFSET)
+#define U2MODESET           SIM_SFR(U2MODE_ADDR + SIM_SET_OFFSET)
+#define U2STA               SIM_SFR(U2STA_ADDR)
+#define U2STACLR            SIM_SFR(U2STA_ADDR + SIM_CLR_OFFSET)
+#define U2STASET            SIM_SFR(U2STA_ADDR + SIM_SET_OFFSET)
+#define U2TXREG             SIM_SFR(U2TXREG_ADDR)
+#define U2RXREG             SIM_SFR(U2RXREG_ADDR)
+#define U2BRG               SIM_SFR(U2BRG_ADDR)
+
+#define OSCCON              SIM_SFR(OSCCON_ADDR)
+#define PMD1                SIM_SFR(PMD1_ADDR)
+#define PMD2                SIM_SFR(PMD2_ADDR)
+#define PMD3                SIM_SFR(PMD3_ADDR)
+#define PMD4                SIM_SFR(PMD4_ADDR)
+#define PMD5                SIM_SFR(PMD5_ADDR)
+#define PMD6                SIM_SFR(PMD6_ADDR)
+#define U2RXR               SIM_SFR(U2RXR_ADDR)
+#define RPB10R              SIM_SFR(RPB10R_ADDR)
+
+#define INTCON              SIM_SFR(INTCON_ADDR)
+#define INTCONSET           SIM_SFR(INTCON_ADDR + SIM_SET_OFFSET)
+#define IFS0                SIM_SFR(IFS0_ADDR)
+#define IFS0CLR             SIM_SFR(IFS0_ADDR + SIM_CLR_OFFSET)
+#define IFS1                SIM_SFR(IFS1_ADDR)
+#define IFS1CLR             SIM_SFR(IFS1_ADDR + SIM_CLR_OFFSET)
+#define IEC0                SIM_SFR(IEC0_ADDR)
+#define IEC0CLR             SIM_SFR(IEC0_ADDR + SIM_CLR_OFFSET)
+#define IEC0SET             SIM_SFR(IEC0_ADDR + SIM_SET_OFFSET)
+#define IEC1                SIM_SFR(IEC1_ADDR)
+#define IEC1CLR             SIM_SFR(IEC1_ADDR + SIM_CLR_OFFSET)
+#define IEC1SET             SIM_SFR(IEC1_ADDR + SIM_SET_OFFSET)
+#define IPC0SET             SIM_SFR(IPC0_ADDR + SIM_SET_OFFSET)
+#define IPC8SET             SIM_SFR(IPC8_ADDR + SIM_SET_OFFSET)
+#define IPC9SET             SIM_SFR(IPC9_ADDR + SIM_SET_OFFSET)
+#define IPC10SET            SIM_SFR(IPC10_ADDR + SIM_SET_OFFSET)
+
+#define DMACONSET           SIM_SFR(DMACON_ADDR + SIM_SET_OFFSET)
+#define DCH0CON             SIM_SFR(DCH0CON_ADDR)
+#define DCH0CONCLR          SIM_SFR(DCH0CON_ADDR + SIM_CLR_OFFSET)
+#define DCH0CONSET          SIM_SFR(DCH0CON_ADDR + SIM_SET_OFFSET)
+#define DCH0ECON            SIM_SFR(DCH0ECON_ADDR)
+#define DCH0INT             SIM_SFR(DCH0INT_ADDR)
+#define DCH0INTCLR          SIM_SFR(DCH0INT_ADDR + SIM_CLR_OFFSET)
+#define DCH0SSA             SIM_SFR(DCH0SSA_ADDR)
+#define DCH0DSA             SIM_SFR(DCH0DSA_ADDR)
+#define DCH0SSIZ            SIM_SFR(DCH0SSIZ_ADDR)
+#define DCH0DSIZ            SIM_SFR(DCH0DSIZ_ADDR)
+#define DCH0SPTR            SIM_SFR(DCH0SPTR_ADDR)
+#define DCH0CSIZ            SIM_SFR(DCH0CSIZ_ADDR)
+
+#define ANSELA              SIM_SFR(ANSELA_ADDR)
+#define ANSELACLR           SIM_SFR(ANSELA_ADDR + SIM_CLR_OFFSET)
+#define TRISA               SIM_SFR(TRISA_ADDR)
+#define TRISACLR            SIM_SFR(TRISA_ADDR + SIM_CLR_OFFSET)
+#define TRISASET            SIM_SFR(TRISA_ADDR + SIM_SET_OFFSET)
+#define PORTA               SIM_SFR(PORTA_ADDR)
+#define LATA                SIM_SFR(LATA_ADDR)
+#define LATACLR             SIM_SFR(LATA_ADDR + SIM_CLR_OFFSET)
+#define LATASET             SIM_SFR(LATA_ADDR + SIM_SET_OFFSET)
+#define LATAINV             SIM_SFR(LATA_ADDR + SIM_INV_OFFSET)
+#define PORTB               SIM_SFR(PORTB_ADDR)
+#define CNPUBSET            SIM_SFR(CNPUB_ADDR + SIM_SET_OFFSET)
+
+// *****************************************************************************
+// Section: Bit fields
+// *****************************************************************************
+typedef struct {
+    uint32_t OSWEN:1;
+    uint32_t SOSCEN:1;
+    uint32_t UFRCEN:1;
+    uint32_t CF:1;
+    uint32_t SLPEN:1;
+    uint32_t SLOCK:1;
+    uint32_t ULOCK:1;
+    uint32_t CLKLOCK:1;
+    uint32_t NOSC:3;
+    uint32_t :1;
+    uint32_t COSC:3;
+    uint32_t :1;
+    uint32_t PLLMULT:3;
+    uint32_t PBDIV:2;
+    uint32_t PBDIVRDY:1;
+    uint32_t SOSCRDY:1;
+    uint32_t :1;
+    uint32_t FRCDIV:3;
+    uint32_t PLLODIV:3;
+    uint32_t :2;
+} __OSCCONbits_t;
+#define OSCCONbits          SIM_SFR_BITS(__OSCCONbits_t, OSCCON_ADDR)
+
+typedef struct {
+    uint32_t BMXARB:3;
+    uint32_t :3;
+    uint32_t BMXWSDRM:1;
+    uint32_t :9;
+    uint32_t BMXERRIS:1;
+    uint32_t BMXERRDS:1;
+    uint32_t BMXERRDMA:1;
+    uint32_t BMXERRICD:1;
+    uint32_t BMXERRIXI:1;
+    uint32_t :5;
+    uint32_t BMXCHEDMA:1;
+    uint32_t :5;
+} __BMXCONbits_t;
+#define BMXCONbits          SIM_SFR_BITS(__BMXCONbits_t, BMXCON_ADDR)
+
+typedef struct {
+    uint32_t CTIF:1;
+    uint32_t CS0IF:1;
+    uint32_t CS1IF:1;
+    uint32_t :29;
+} __IFS0bits_t;
+#define IFS0bits            SIM_SFR_BITS(__IFS0bits_t, IFS0_ADDR)
+
+// *****************************************************************************
+// Section: Masks
+// *****************************************************************************
+#define _I2C1CON_SEN_MASK       0x00000001u
+#define _I2C1CON_RSEN_MASK      0x00000002u
+#define _I2C1CON_PEN_MASK       0x00000004u
+#define _I2C1CON_RCEN_MASK      0x00000008u
+#define _I2C1CON_ACKEN_MASK     0x00000010u
+#define _I2C1CON_ACKDT_MASK     0x00000020u
+#define _I2C1CON_STREN_MASK     0x00000040u
+#define _I2C1CON_GCEN_MASK      0x00000080u
+#define _I2C1CON_SMEN_MASK      0x00000100u
+#define _I2C1CON_DISSLW_MASK    0x00000200u
+#define _I2C1CON_A10M_MASK      0x00000400u
+#define _I2C1CON_STRICT_MASK    0x00000800u
+#define _I2C1CON_SCLREL_MASK    0x00001000u
+#define _I2C1CON_SIDL_MASK      0x00002000u
+#define _I2C1CON_ON_MASK        0x00008000u
+
+#define _I2C1STAT_TBF_MASK      0x00000001u
+#define _I2C1STAT_RBF_MASK      0x00000002u
+#define _I2C1STAT_R_W_MASK      0x00000004u
+#define _I2C1STAT_S_MASK        0x00000008u
+#define _I2C1STAT_P_MASK        0x00000010u
+#define _I2C1STAT_D_A_MASK      0x00000020u
+#define _I2C1STAT_I2COV_MASK    0x00000040u
+#define _I2C1STAT_IWCOL_MASK    0x00000080u
+#define _I2C1STAT_BCL_MASK      0x00000400u
+#define _I2C1STAT_TRSTAT_MASK   0x00004000u
+#define _I2C1STAT_ACKSTAT_MASK  0x00008000u
+
+#define _U2MODE_STSEL_MASK      0x00000001u
+#define _U2MODE_PDSEL_MASK      0x00000006u
+#define _U2MODE_PDSEL0_MASK     0x00000002u
+#define _U2MODE_PDSEL1_MASK     0x00000004u
+#define _U2MODE_BRGH_MASK       0x00000008u
+#define _U2MODE_RXINV_MASK      0x00000010u
+#define _U2MODE_ABAUD_MASK      0x00000020u
+#define _U2MODE_LPBACK_MASK     0x00000040u
+#define _U2MODE_WAKE_MASK       0x00000080u
+#define _U2MODE_UEN_MASK        0x00000300u
+#define _U2MODE_ON_MASK         0x00008000u
+
+#define _U2STA_URXDA_MASK       0x00000001u
+#define _U2STA_OERR_MASK        0x00000002u
+#define _U2STA_FERR_MASK        0x00000004u
+#define _U2STA_PERR_MASK        0x00000008u
+#define _U2STA_RIDLE_MASK       0x00000010u
+#define _U2STA_URXISEL_MASK     0x000000C0u
+#define _U2STA_TRMT_MASK        0x00000100u
+#define _U2STA_UTXBF_MASK       0x00000200u
+#define _U2STA_UTXEN_MASK       0x00000400u
+#define _U2STA_UTXBRK_MASK      0x00000800u
+#define _U2STA_URXEN_MASK       0x00001000u
+#define _U2STA_UTXINV_MASK      0x00002000u
+#define _U2STA_UTXISEL_MASK     0x0000C000u
+#define _U2STA_UTXISEL0_MASK    0x00004000u
+#define _U2STA_UTXISEL1_MASK    0x00008000u
+
+#define _DMACON_ON_MASK         0x00008000u
+
+#define _DCH0CON_CHPRI_MASK     0x00000003u
+#define _DCH0CON_CHAEN_MASK     0x00000010u
+#define _DCH0CON_CHEN_MASK      0x00000080u
+#define _DCH0CON_CHBUSY_MASK    0x00008000u
+
+#define _DCH0ECON_SIRQEN_MASK   0x00000010u
+#define _DCH0ECON_CABORT_MASK   0x00000040u
+#define _DCH0ECON_CFORCE_MASK   0x00000080u
+#define _DCH0ECON_CHSIRQ_POSITION 8
+#define _DCH0ECON_CHSIRQ_MASK   0x0000FF00u
+
+#define _DCH0INT_CHERIF_MASK    0x00000001u
+#define _DCH0INT_CHTAIF_MASK    0x00000002u
+#define _DCH0INT_CHBCIF_MASK    0x00000008u
+#define _DCH0INT_CHSDIF_MASK    0x00000080u
+#define _DCH0INT_CHERIE_MASK    0x00010000u
+#define _DCH0INT_CHTAIE_MASK    0x00020000u
+#define _DCH0INT_CHBCIE_MASK    0x00080000u
+#define _DCH0INT_CHSDIE_MASK    0x00800000u
+
+#define _INTCON_MVEC_MASK       0x00001000u
+
+#define _IFS0_CTIF_MASK         0x00000001u
+#define _IEC0_CTIE_MASK         0x00000001u
+
+#define _IFS1_I2C1BIF_MASK      0x00000400u
+#define _IFS1_I2C1SIF_MASK      0x00000800u
+#define _IFS1_I2C1MIF_MASK      0x00001000u
+#define _IFS1_U2EIF_MASK        0x00200000u
+#define _IFS1_U2RXIF_MASK       0x00400000u
+#define _IFS1_U2TXIF_MASK       0x00800000u
+#define _IFS1_DMA0IF_MASK       0x10000000u
+
+#define _IEC1_I2C1BIE_MASK      0x00000400u
+#define _IEC1_I2C1SIE_MASK      0x00000800u
+#define _IEC1_I2C1MIE_MASK      0x00001000u
+#define _IEC1_U2EIE_MASK        0x00200000u
+#define _IEC1_U2RXIE_MASK       0x00400000u
+#define _IEC1_U2TXIE_MASK       0x00800000u
+#define _IEC1_DMA0IE_MASK       0x10000000u
+
+// *****************************************************************************
+// Section: Interrupt request and vector numbers
+// *****************************************************************************
+#define _CORE_TIMER_IRQ         0
+#define _CORE_SOFTWARE_0_IRQ    1
+#define _CORE_SOFTWARE_1_IRQ    2
+#define _EXTERNAL_0_IRQ         3
+#define _TIMER_1_IRQ            4
+#define _INPUT_CAPTURE_ERROR_1_IRQ 5
+#define _INPUT_CAPTURE_1_IRQ    6
+#define _OUTPUT_COMPARE_1_IRQ   7
+#define _EXTERNAL_1_IRQ         8
+#define _TIMER_2_IRQ            9
+#define _INPUT_CAPTURE_ERROR_2_IRQ 10
+#define _INPUT_CAPTURE_2_IRQ    11
+#define _OUTPUT_COMPARE_2_IRQ   12
+#define _EXTERNAL_2_IRQ         13
+#define _TIMER_3_IRQ            14
+#define _INPUT_CAPTURE_ERROR_3_IRQ 15
+#define _INPUT_CAPTURE_3_IRQ    16
+#define _OUTPUT_COMPARE_3_IRQ   17
+#define _EXTERNAL_3_IRQ         18
+#define _TIMER_4_IRQ            19
+#define _INPUT_CAPTURE_ERROR_4_IRQ 20
+#define _INPUT_CAPTURE_4_IRQ    21
+#define _OUTPUT_COMPARE_4_IRQ   22
+#define _EXTERNAL_4_IRQ         23
+#define _TIMER_5_IRQ            24
+#define _INPUT_CAPTURE_ERROR_5_IRQ 25
+#define _INPUT_CAPTURE_5_IRQ    26
+#define _OUTPUT_COMPARE_5_IRQ   27
+#define _ADC_IRQ                28
+#define _FAIL_SAFE_MONITOR_IRQ  29
+#define _RTCC_IRQ               30
+#define _FLASH_CONTROL_IRQ      31
+#define _COMPARATOR_1_IRQ       32
+#define _COMPARATOR_2_IRQ       33
+#define _COMPARATOR_3_IRQ       34
+#define _USB_IRQ                35
+#define _SPI1_ERR_IRQ           36
+#define _SPI1_RX_IRQ            37
+#define _SPI1_TX_IRQ            38
+#define _UART1_ERR_IRQ          39
+#define _UART1_RX_IRQ           40
+#define _UART1_TX_IRQ           41
+#define _I2C1_BUS_IRQ           42
+#define _I2C1_SLAVE_IRQ         43
+#define _I2C1_MASTER_IRQ        44
+#define _CHANGE_NOTICE_A_IRQ    45
+#define _CHANGE_NOTICE_B_IRQ    46
+#define _CHANGE_NOTICE_C_IRQ    47
+#define _PMP_IRQ                48
+#define _PMP_ERROR_IRQ          49
+#define _SPI2_ERR_IRQ           50
+#define _SPI2_RX_IRQ            51
+#define _SPI2_TX_IRQ            52
+#define _UART2_ERR_IRQ          53
+#define _UART2_RX_IRQ           54
+#define _UART2_TX_IRQ           55
+#define _I2C2_BUS_IRQ           56
+#define _I2C2_SLAVE_IRQ         57
+#define _I2C2_MASTER_IRQ        58
+#define _CTMU_IRQ               59
+#define _DMA0_IRQ               60
+#define _DMA1_IRQ               61
+#define _DMA2_IRQ               62
+#define _DMA3_IRQ               63
+
+#define _CORE_TIMER_VECTOR      0
+#define _I2C_1_VECTOR           33
+#define _UART_2_VECTOR          37
+#define _DMA_0_VECTOR           40
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_XC_H
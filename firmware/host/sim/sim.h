@@ -0,0 +1,228 @@
+/*******************************************************************************
+  PIC32MX host simulator
+
+  File Name:
+    sim.h
+
+  Summary:
+    Internal interface shared by the simulator modules.
+
+  Description:
+    Simulated time is the CPU cycle counter simCycles. The firmware is
+    compiled with -fsanitize-coverage=trace-pc, and every basic block it
+    executes charges SIM_CYCLES_PER_BLOCK. Each SFR access charges
+    SIM_CYCLES_PER_SFR. The same hook runs peripheral events that are due,
+    and it delivers pending interrupts when the firmware has them enabled.
+    Simulated time depends only on the code path taken, never on the host
+    machine, so two runs of the same binary report the same cycle counts.
+ *******************************************************************************/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// SYSCLK and PBCLK as configured by CLK_Initialize() (FRC + PLL, PBDIV=1)
+#define SIM_CPU_CLOCK_HZ        48000000u
+#define SIM_PB_CLOCK_HZ         48000000u
+// CP0 Count increments at half the SYSCLK rate
+#define SIM_CORE_TIMER_DIV      2u
+
+// Cost model (CPU cycles). M4K core: single issue, most instructions 1 cycle,
+// loads/stores to the peripheral bus stall for the bridge.
+#define SIM_CYCLES_PER_BLOCK    4u
+#define SIM_CYCLES_PER_SFR      3u
+// ipl1SOFT prologue/epilogue: saves/restores all caller-saved regs + EPC/Status
+#define SIM_CYCLES_PER_IRQ      52u
+
+#define SIM_TIME_NEVER          UINT64_MAX
+
+extern uint64_t simCycles;
+// cycles spent inside interrupt handlers (including entry/exit cost)
+extern uint64_t simIsrCycles;
+extern bool simInIsr;
+// the simulator itself is running (peripheral events), not the firmware
+extern bool simInPoll;
+// earliest cycle at which any peripheral has work to do
+extern uint64_t simNextEvent;
+// set by SIM_SFR_Access(), cleared when SFR side effects were applied
+extern bool simSfrDirty;
+extern bool simQuiet;
+// absolute path of the simulator binary, used to find <binary>.sym
+extern const char *simProgramName;
+
+#define SIM_US_TO_CYCLES(us)    ((uint64_t)(us) * (SIM_CPU_CLOCK_HZ / 1000000u))
+#define SIM_CYCLES_TO_US(c)     ((double)(c) / (SIM_CPU_CLOCK_HZ / 1000000u))
+
+// sim_sfr.c
+volatile uint32_t *SIM_SFR_Ptr(uint32_t address);
+// SFR address of a pointer into the register file (as &U2TXREG gives on the
+// host), 0 when it points elsewhere
+uint32_t SIM_SFR_AddressOf(const volatile void *p);
+void SIM_SFR_Reset(void);
+void SIM_SFR_Sync(void);
+uint64_t SIM_SFR_AccessCountGet(void);
+
+// sim_cpu.c
+void SIM_Reset(void);
+void SIM_Poll(void);
+void SIM_EventsReschedule(void);
+void SIM_CyclesCharge(uint32_t cycles);
+uint64_t SIM_IrqCountGet(unsigned vector);
+uint64_t SIM_IrqCyclesGet(unsigned vector);
+uint64_t SIM_IrqMaxCyclesGet(unsigned vector);
+void SIM_IrqReport(FILE *out);
+// an extra interrupt below all vectors, requested at random every 1 ..
+// 2 * meanCycles cycles, NULL to stop it
+void SIM_IrqInjectSet(void (*handler)(void), uint32_t meanCycles);
+// called on entry of every vector, before its handler, NULL for none
+void SIM_IrqHookSet(void (*hook)(unsigned vector));
+
+// sim_profile.c
+void SIM_ProfileReset(void);
+void SIM_ProfileReport(FILE *out);
+
+// sim_coretimer (in sim_cpu.c)
+uint64_t SIM_CoreTimerNextEvent(void);
+// CP0 Count now
+uint32_t SIM_CoreTimerCountGet(void);
+void SIM_CoreTimerEvent(void);
+
+// sim_i2c.c
+typedef struct SIM_I2C_SLAVE
+{
+    uint8_t address;                        // 7-bit address
+    void *context;
+    // clock stretching the slave adds to every byte it ACKs or sends
+    uint64_t stretchCycles;
+    // address phase after START/RESTART, return true to ACK
+    bool (*start)(void *context, bool read);
+    // master sent a data byte, return true to ACK
+    bool (*write)(void *context, uint8_t data);
+    // master clocks in a data byte
+    uint8_t (*read)(void *context);
+    // master ACK/NACK after a read byte (true = ACK, more bytes follow)
+    void (*ack)(void *context, bool ack);
+    void (*stop)(void *context);
+    struct SIM_I2C_SLAVE *next;
+} SIM_I2C_SLAVE;
+
+void SIM_I2C_Reset(void);
+void SIM_I2C_Sync(void);
+void SIM_I2C_ReadHook(uint32_t address);
+uint64_t SIM_I2C_NextEvent(void);
+void SIM_I2C_Event(void);
+void SIM_I2C_SlaveAttach(SIM_I2C_SLAVE *slave);
+SIM_I2C_SLAVE *SIM_I2C_SlaveFind(uint8_t address);
+uint64_t SIM_I2C_BitCycles(void);
+// cycles the bus was busy (START to STOP) so far
+uint64_t SIM_I2C_BusCyclesGet(void);
+// fault injection: a bus collision on every n-th START (0 = never)
+void SIM_I2C_BusErrorEverySet(uint32_t n);
+bool SIM_I2C_BusErrorInject(void);
+// bus statistics shared by the register and the PLIB level model
+void SIM_I2C_Account(uint32_t starts, uint32_t bytesTx, uint32_t bytesRx,
+                     uint32_t nacks, uint64_t busCycles);
+void SIM_I2C_Report(FILE *out);
+
+// sim_i2c_plib.c
+// when enabled, drvI2C0PLibAPI is served by a transaction level model
+// instead of the I2C1 PLIB + register model (no I2C1 ISR cost)
+extern bool simI2cPlibModel;
+bool SIM_I2C_PLIB_IrqPending(void);
+void SIM_I2C_PLIB_InterruptHandler(void);
+uint64_t SIM_I2C_PLIB_NextEvent(void);
+void SIM_I2C_PLIB_Event(void);
+
+// sim_uart.c
+void SIM_UART_Reset(void);
+void SIM_UART_Sync(void);
+void SIM_UART_ReadHook(uint32_t address);
+uint64_t SIM_UART_NextEvent(void);
+void SIM_UART_Event(void);
+void SIM_UART_RxInject(const uint8_t *data, size_t size);
+void SIM_UART_Report(FILE *out);
+// U2TXREG write by a DMA channel
+void SIM_UART_TxWrite(uint16_t data);
+// TX interrupt request line as selected by UTXISEL (DMA start trigger)
+bool SIM_UART_TxRequest(void);
+// host adapter rate in Bd, 0 = always the rate UART2 is set to
+void SIM_UART_HostBaudSet(uint32_t baud);
+uint32_t SIM_UART_HostBaudGet(void);
+
+typedef struct
+{
+    uint64_t bytesTx;
+    uint64_t bytesRx;
+    uint64_t overruns;
+    uint64_t hostErrors;        // characters the host could not receive
+    uint64_t framingErrors;     // characters UART2 received with FERR
+    uint64_t autobauds;         // U2MODE.ABAUD measurements
+} SIM_UART_STATS;
+
+void SIM_UART_StatsGet(SIM_UART_STATS *stats);
+
+// sim_host.c
+// scripted host on the other end of UART2, see there
+void SIM_HOST_BaudSwitchSet(uint32_t baud);
+void SIM_HOST_TypeSet(const char *commands);
+void SIM_HOST_Poll(void);
+// every character UART2 sent, ok is false when the host could not read it
+void SIM_HOST_Receive(uint8_t c, bool ok);
+bool SIM_HOST_Report(FILE *out);
+
+// sim_dma.c
+void SIM_DMA_Reset(void);
+// runs the cell transfers whose start IRQ is asserted
+void SIM_DMA_Sync(void);
+void SIM_DMA_Report(FILE *out);
+
+// sim_tc74.c
+typedef enum
+{
+    SIM_TC74_WAVE_CONST = 0,    // base
+    SIM_TC74_WAVE_RAMP,         // base .. base + amplitude, sawtooth
+    SIM_TC74_WAVE_SINE,         // base +- amplitude
+    SIM_TC74_WAVE_WALK,         // random walk within base +- amplitude
+} SIM_TC74_WAVE;
+
+typedef struct
+{
+    uint8_t address;
+    SIM_TC74_WAVE wave;
+    double base;
+    double amplitude;
+    uint32_t periodMs;
+    // DATA_RDY is low this long after power-up or wake-up (TC74: <= 250 ms)
+    uint32_t conversionMs;
+    // power up in standby (SHDN=1)
+    bool standby;
+    // NACK every n-th address phase (0 = never)
+    uint32_t nackEvery;
+    // clock stretching per byte
+    uint32_t stretchUs;
+} SIM_TC74_CONFIG;
+
+void SIM_TC74_ConfigDefault(SIM_TC74_CONFIG *cfg);
+void SIM_TC74_Attach(const SIM_TC74_CONFIG *cfg);
+void SIM_TC74_Report(FILE *out);
+
+// sim_bench.c
+// DRV_I2C cost per transfer at queue depth 1, 2, 4 .. maxDepth
+int SIM_BenchI2cQueue(FILE *out, uint8_t address, uint32_t maxDepth);
+// cycles and stack of vsnprintf() against SYS_CONSOLE_Vsnprintf()
+int SIM_BenchConsoleFormat(FILE *out);
+// cycles of UART2_Write() and UART2_Read() for a few transfer sizes
+int SIM_BenchUartRing(FILE *out);
+// UART2 at the standard rates: rate error, throughput and interrupt load
+int SIM_BenchUartRate(FILE *out);
+// SYS_TIME start and expiry cost with count periodic timers running
+int SIM_BenchTimers(FILE *out, uint32_t count);
+// SYS_TIME_TimestampGet() and SYS_TIME_Counter64Get() checked against CP0
+// Count from tasks and handlers, reads times in the task, and their cycles
+int SIM_BenchTimestamp(FILE *out, uint8_t address, uint32_t reads);
+
+#endif // SIM_H
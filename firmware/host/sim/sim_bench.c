@@ -0,0 +1,943 @@
+/*******************************************************************************
+  PIC32MX host simulator - DRV_I2C queue benchmark
+
+  File Name:
+    sim_bench.c
+
+  Summary:
+    Per-transfer cost of the DRV_I2C transfer queue at growing queue depth
+    (simulator option -Q), console formatter cost (option -F), UART2 ring
+    buffer throughput (option -U), UART2 at the standard rates (option -R),
+    SYS_TIME timers (option -X) and SYS_TIME timestamps (option -Y).
+
+  Description:
+    Runs instead of the application, right after SYS_Initialize(). For each
+    power of two depth up to the -Q argument, a private DRV_I2C client
+    queues that many 1 byte reads of the first TC74 with interrupts
+    disabled, so that the queue really fills up behind the first transfer. Then interrupts are enabled
+    and the transfers complete one by one. The transaction level PLIB model
+    (-f) is used, so the completion cost is the driver ISR path only.
+
+    Reported per transfer: cycles of DRV_I2C_ReadTransferAdd() on average
+    and for the last (deepest) add, and interrupt cycles of the completion.
+
+    With option -F the console messages of app.c are formatted once with
+    vsnprintf() (cycles from the cost model in sim_libc.c) and once with the
+    instrumented SYS_CONSOLE_Vsnprintf(), and both outputs are compared. The
+    stack use of both is measured on the host by running them on a painted
+    stack. It is x86-64 stack, the XC32 numbers differ, but the ratio shows.
+
+    With option -U UART2_Write() and UART2_Read() are timed with interrupts
+    disabled, so that only the copy into or out of the ring is counted. The
+    ring is drained (or filled at line rate) between calls and the indices
+    are left where they are, so some calls wrap around the end of the ring.
+    memcpy() is charged by the cost model in sim_libc.c.
+
+    With option -R UART2 is set to each rate of the list twice: once with
+    the divider the PLIB computed before BRGH support (16 clocks per bit,
+    written straight to U2BRG) and once by UART2_SerialSetup(). The host
+    adapter stays at the nominal rate. A block is sent and one received,
+    the interrupts (TX or DMA, RX) are counted against the time the block
+    takes on the line.
+
+    With option -X that many periodic SYS_TIME timers with periods from 1
+    to 10 ms are created, started and run for 200 ms. Reported are the
+    cycles of each create (the search for a free timer object) and start
+    (the insert into the active timers), and the core timer interrupt
+    cycles per expiry, which include re-arming the periodic timer.
+    Then the timers run for another 200 ms while SYS_TIME_CounterSet()
+    moves the counter back by 1000000 counts and forward by 0x80000000
+    counts in turn, every 10 ms. Each timer must still expire once per
+    period, the run fails when the intervals between expiries are off by
+    more than 500 us beyond the run without the steps.
+
+    With option -Y the task reads SYS_TIME_TimestampGet() and
+    SYS_TIME_Counter64Get() that many times each, and so does every entry of
+    the core timer, I2C1 and UART2 vectors and of an interrupt injected at
+    random cycles. Three periodic timers of 31 to 73 us keep the core timer
+    interrupt publishing, the task restarts a fourth timer every 16 reads,
+    I2C1 reads the TC74 and UART2 sends without pause. A read is wrong when
+    it is not between CP0 Count before and after the call. Reported per
+    context are the reads, the wrong ones and the cycles of a read.
+ *******************************************************************************/
+
+#include <stdarg.h>
+#include <string.h>
+#include <ucontext.h>
+#include "sim.h"
+#include "definitions.h"
+
+typedef struct
+{
+    uint32_t completed;
+    uint32_t errors;
+} SIM_BENCH_I2C;
+
+static SIM_BENCH_I2C benchI2c;
+
+static void SIM_BenchI2cHandler(DRV_I2C_TRANSFER_EVENT event,
+                                DRV_I2C_TRANSFER_HANDLE transferHandle,
+                                uintptr_t context)
+{
+    (void)transferHandle;
+    (void)context;
+    benchI2c.completed++;
+    if (event != DRV_I2C_TRANSFER_EVENT_COMPLETE)
+    {
+        benchI2c.errors++;
+    }
+}
+
+int SIM_BenchI2cQueue(FILE *out, uint8_t address, uint32_t maxDepth)
+{
+    static uint8_t rx[DRV_I2C_QUEUE_SIZE_IDX0];
+    DRV_I2C_TRANSFER_HANDLE th;
+    DRV_HANDLE h;
+    uint32_t depth;
+    uint32_t i;
+
+    if (maxDepth > DRV_I2C_QUEUE_SIZE_IDX0)
+    {
+        fprintf(stderr, "sim: -Q %u exceeds DRV_I2C_QUEUE_SIZE_IDX0 (%u), "
+                "rebuild with I2C_QUEUE_SIZE=%u\n", maxDepth,
+                (unsigned)DRV_I2C_QUEUE_SIZE_IDX0, maxDepth);
+        return -1;
+    }
+    simI2cPlibModel = true;
+    h = DRV_I2C_Open(DRV_I2C_INDEX_0, DRV_IO_INTENT_READWRITE);
+    if (h == DRV_HANDLE_INVALID)
+    {
+        fprintf(stderr, "sim: DRV_I2C_Open failed\n");
+        return -1;
+    }
+    DRV_I2C_TransferEventHandlerSet(h, SIM_BenchI2cHandler, 0);
+
+    fprintf(out, "drv_i2c queue size %u, cycles per transfer:\n"
+            "  depth    add avg   add last   complete\n",
+            (unsigned)DRV_I2C_QUEUE_SIZE_IDX0);
+    for (depth = 1; depth <= maxDepth; depth *= 2u)
+    {
+        uint64_t addSum = 0;
+        uint64_t addLast = 0;
+        uint64_t isrStart;
+        bool intStatus;
+
+        benchI2c = (SIM_BENCH_I2C){ 0 };
+        intStatus = SYS_INT_Disable();
+        for (i = 0; i < depth; i++)
+        {
+            uint64_t start = simCycles;
+
+            DRV_I2C_ReadTransferAdd(h, address, &rx[i], 1, &th);
+            addLast = simCycles - start;
+            addSum += addLast;
+            if (th == DRV_I2C_TRANSFER_HANDLE_INVALID)
+            {
+                fprintf(stderr, "sim: transfer %u of %u refused\n", i + 1u, depth);
+                SYS_INT_Restore(intStatus);
+                return -1;
+            }
+        }
+        isrStart = simIsrCycles;
+        SYS_INT_Restore(intStatus);
+        while (benchI2c.completed < depth)
+        {
+            SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+        }
+        fprintf(out, "  %5u  %9llu  %9llu  %9llu%s\n", depth,
+                (unsigned long long)(addSum / depth), (unsigned long long)addLast,
+                (unsigned long long)((simIsrCycles - isrStart) / depth),
+                (benchI2c.errors != 0u) ? "  (errors)" : "");
+    }
+    DRV_I2C_Close(h);
+    return 0;
+}
+
+// Console formatter benchmark (option -F)
+typedef int (*SIM_BENCH_FORMATTER)(char *buf, size_t size, const char *format, va_list args);
+
+// copy of sys_console_format.c built without instrumentation, the hooks
+// would add their frames (and interrupts) to the stack measurement
+int SIM_ConsoleVsnprintfPlain(char *buf, size_t size, const char *format, va_list args);
+int __real_vsnprintf(char *str, size_t size, const char *format, va_list ap);
+
+#define SIM_BENCH_MESSAGES      4u
+#define SIM_BENCH_STACK_SIZE    65536u
+#define SIM_BENCH_STACK_PAINT   0xA5u
+
+static char benchLine[SYS_CONSOLE_PRINT_BUFFER_SIZE];
+static SIM_BENCH_FORMATTER benchFormatter;
+static uint8_t benchStack[SIM_BENCH_STACK_SIZE] __attribute__((aligned(16)));
+static ucontext_t benchMainContext;
+static ucontext_t benchStackContext;
+
+static int SIM_BenchFormatterNone(char *buf, size_t size, const char *format, va_list args)
+{
+    (void)format;
+    (void)args;
+    if (size != 0u)
+    {
+        buf[0] = '\0';
+    }
+    return 0;
+}
+
+static int SIM_BenchFormatCall(SIM_BENCH_FORMATTER formatter, char *buf, const char *format, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, format);
+    len = formatter(buf, sizeof(benchLine), format, args);
+    va_end(args);
+    return len;
+}
+
+// the app.c messages (after APP_CONSOLE_PRINT() added file and line) with
+// typical arguments
+static int SIM_BenchFormat(SIM_BENCH_FORMATTER formatter, char *buf, unsigned message)
+{
+    switch (message)
+    {
+        case 0:
+            return SIM_BenchFormatCall(formatter, buf,
+                    "%s:%d #%u ADDR=0x%x Temp=%d Celsius (raw=0x%X)\r\n",
+                    "app.c", 595, 1234u, 0x48u, -5, 0xfbu);
+        case 1:
+            return SIM_BenchFormatCall(formatter, buf, "%s:%d Starting app v%d.%02d\r\n",
+                    "app.c", 731, 1, 4);
+        case 2:
+            return SIM_BenchFormatCall(formatter, buf,
+                    "%s:%d Data from TC74 at ADDR=0x%x: CONFIG=0x%x %s %s zero mask: 0x%x\r\n",
+                    "app.c", 546, 0x48u, 0x40u, "UP", "READY", 0u);
+        default:
+            return SIM_BenchFormatCall(formatter, buf,
+                    "ERROR: %s:%d I2C Read from ADDR=0x%x..0x%x failed. Is TC74 connected?\r\n",
+                    "app.c", 782, 0x48u, 0x4fu);
+    }
+}
+
+static void SIM_BenchStackRun(void)
+{
+    unsigned m;
+
+    for (m = 0; m < SIM_BENCH_MESSAGES; m++)
+    {
+        SIM_BenchFormat(benchFormatter, benchLine, m);
+    }
+}
+
+// deepest stack use of formatting all messages, by painting a private stack
+static size_t SIM_BenchStackUsed(SIM_BENCH_FORMATTER formatter)
+{
+    size_t i;
+
+    memset(benchStack, SIM_BENCH_STACK_PAINT, sizeof(benchStack));
+    benchFormatter = formatter;
+    getcontext(&benchStackContext);
+    benchStackContext.uc_stack.ss_sp = benchStack;
+    benchStackContext.uc_stack.ss_size = sizeof(benchStack);
+    benchStackContext.uc_link = &benchMainContext;
+    makecontext(&benchStackContext, SIM_BenchStackRun, 0);
+    swapcontext(&benchMainContext, &benchStackContext);
+    for (i = 0; (i < sizeof(benchStack)) && (benchStack[i] == SIM_BENCH_STACK_PAINT); i++)
+    {
+    }
+    return sizeof(benchStack) - i;
+}
+
+int SIM_BenchConsoleFormat(FILE *out)
+{
+    static char reference[SYS_CONSOLE_PRINT_BUFFER_SIZE];
+    uint64_t sumLibc = 0;
+    uint64_t sumLite = 0;
+    size_t stackBase;
+    unsigned m;
+
+    fprintf(out, "console formatter, cycles per message:\n"
+            "  msg  chars  vsnprintf  SYS_CONSOLE_Vsnprintf\n");
+    for (m = 0; m < SIM_BENCH_MESSAGES; m++)
+    {
+        uint64_t start = simCycles;
+        uint64_t libc;
+        uint64_t lite;
+        int len;
+
+        len = SIM_BenchFormat(vsnprintf, reference, m);
+        libc = simCycles - start;
+        start = simCycles;
+        SIM_BenchFormat(SYS_CONSOLE_Vsnprintf, benchLine, m);
+        lite = simCycles - start;
+        if (strcmp(reference, benchLine) != 0)
+        {
+            fprintf(stderr, "sim: formatter output differs:\n  %s  %s", reference, benchLine);
+            return -1;
+        }
+        fprintf(out, "  %3u  %5d  %9llu  %21llu\n", m, len,
+                (unsigned long long)libc, (unsigned long long)lite);
+        sumLibc += libc;
+        sumLite += lite;
+    }
+    fprintf(out, "  avg         %9llu  %21llu\n", (unsigned long long)(sumLibc / SIM_BENCH_MESSAGES),
+            (unsigned long long)(sumLite / SIM_BENCH_MESSAGES));
+
+    // host stack, the same messages; the call wrapper is subtracted
+    stackBase = SIM_BenchStackUsed(SIM_BenchFormatterNone);
+    fprintf(out, "host stack bytes: vsnprintf %zu, SYS_CONSOLE_Vsnprintf %zu\n",
+            SIM_BenchStackUsed(__real_vsnprintf) - stackBase,
+            SIM_BenchStackUsed(SIM_ConsoleVsnprintfPlain) - stackBase);
+    return 0;
+}
+
+// UART2 ring benchmark (option -U)
+#define SIM_BENCH_UART_RUNS     16u
+
+static const uint16_t benchUartWriteSizes[] = { 16u, 64u, 512u };
+static const uint16_t benchUartReadSizes[] = { 16u, 64u, 120u };
+// bytes sent per message size for the TX CPU load
+#define SIM_BENCH_UART_STREAM   16384u
+
+// runs the TX interrupt until the ring and the FIFO are empty
+static void SIM_BenchUartDrain(void)
+{
+    while ((UART2_WriteCountGet() != 0u) || !UART2_TransmitComplete())
+    {
+        SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+    }
+}
+
+int SIM_BenchUartRing(FILE *out)
+{
+    static uint8_t data[512];
+    static uint8_t rx[128];
+    size_t i;
+    unsigned run;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 7u + 1u);
+    }
+    simQuiet = true;
+    fprintf(out, "uart2 ring, cycles per call (average of %u, ring indices wrap):\n"
+            "  call          bytes   cycles  bytes/cycle\n", SIM_BENCH_UART_RUNS);
+    for (i = 0; i < sizeof(benchUartWriteSizes) / sizeof(benchUartWriteSizes[0]); i++)
+    {
+        size_t size = benchUartWriteSizes[i];
+        uint64_t sum = 0;
+
+        for (run = 0; run < SIM_BENCH_UART_RUNS; run++)
+        {
+            // with interrupts disabled the TX ISR cannot run during the call
+            bool intStatus = SYS_INT_Disable();
+            uint64_t start = simCycles;
+            size_t n = UART2_Write(data, size);
+
+            sum += simCycles - start;
+            SYS_INT_Restore(intStatus);
+            if (n != size)
+            {
+                fprintf(stderr, "sim: UART2_Write took %zu of %zu bytes\n", n, size);
+                return -1;
+            }
+            SIM_BenchUartDrain();
+        }
+        fprintf(out, "  UART2_Write  %5zu  %7llu  %11.3f\n", size,
+                (unsigned long long)(sum / SIM_BENCH_UART_RUNS),
+                (double)size * SIM_BENCH_UART_RUNS / (double)sum);
+    }
+    for (i = 0; i < sizeof(benchUartReadSizes) / sizeof(benchUartReadSizes[0]); i++)
+    {
+        size_t size = benchUartReadSizes[i];
+        uint64_t sum = 0;
+
+        for (run = 0; run < SIM_BENCH_UART_RUNS; run++)
+        {
+            bool intStatus;
+            uint64_t start;
+            size_t n;
+
+            // the bytes arrive at line rate through the RX interrupt
+            SIM_UART_RxInject(&data[run], size);
+            while (UART2_ReadCountGet() < size)
+            {
+                SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+            }
+            intStatus = SYS_INT_Disable();
+            start = simCycles;
+            n = UART2_Read(rx, size);
+            sum += simCycles - start;
+            SYS_INT_Restore(intStatus);
+            if ((n != size) || (memcmp(rx, &data[run], size) != 0))
+            {
+                fprintf(stderr, "sim: UART2_Read returned wrong data (%zu of %zu bytes)\n",
+                        n, size);
+                return -1;
+            }
+        }
+        fprintf(out, "  UART2_Read   %5zu  %7llu  %11.3f\n", size,
+                (unsigned long long)(sum / SIM_BENCH_UART_RUNS),
+                (double)size * SIM_BENCH_UART_RUNS / (double)sum);
+    }
+
+    // TX CPU load: UART2_Write() plus every interrupt (TX or DMA) taken while
+    // the stream goes out. Waiting for ring space is not counted.
+    fprintf(out, "uart2 tx stream, %u bytes per message size (%s):\n"
+            "  message  write cyc/KB  isr cyc/KB  total cyc/KB  irqs/KB\n",
+            SIM_BENCH_UART_STREAM, (UART2_TX_DMA != 0) ? "DMA" : "TX interrupt");
+    for (i = 0; i < sizeof(benchUartWriteSizes) / sizeof(benchUartWriteSizes[0]); i++)
+    {
+        size_t size = benchUartWriteSizes[i];
+        uint64_t writeCycles = 0;
+        uint64_t isrStart = simIsrCycles;
+        uint64_t isrCycles;
+        UART2_TX_STATS before;
+        UART2_TX_STATS after;
+        size_t sent;
+
+        UART2_TxStatsGet(&before);
+        for (sent = 0; sent < SIM_BENCH_UART_STREAM; sent += size)
+        {
+            bool intStatus;
+            uint64_t start;
+
+            while (UART2_WriteFreeBufferCountGet() < size)
+            {
+                SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+            }
+            intStatus = SYS_INT_Disable();
+            start = simCycles;
+            (void)UART2_Write(&data[sent % (sizeof(data) - size + 1u)], size);
+            writeCycles += simCycles - start;
+            SYS_INT_Restore(intStatus);
+        }
+        SIM_BenchUartDrain();
+        isrCycles = simIsrCycles - isrStart;
+        UART2_TxStatsGet(&after);
+        if (after.bytes - before.bytes != SIM_BENCH_UART_STREAM)
+        {
+            fprintf(stderr, "sim: %u bytes of %u left the TX ring\n",
+                    (unsigned)(after.bytes - before.bytes), SIM_BENCH_UART_STREAM);
+            return -1;
+        }
+        fprintf(out, "  %7zu  %12.0f  %10.0f  %12.0f  %7.1f\n", size,
+                1024.0 * writeCycles / SIM_BENCH_UART_STREAM,
+                1024.0 * isrCycles / SIM_BENCH_UART_STREAM,
+                1024.0 * (writeCycles + isrCycles) / SIM_BENCH_UART_STREAM,
+                1024.0 * (after.interrupts - before.interrupts) / SIM_BENCH_UART_STREAM);
+    }
+    return 0;
+}
+
+// UART2 rate benchmark (option -R)
+static const uint32_t benchUartRates[] =
+{
+    9600u, 115200u, 230400u, 460800u, 921600u, 1000000u, 1500000u, 2000000u, 3000000u
+};
+#define SIM_BENCH_RATE_BYTES    1024u
+#define SIM_BENCH_RATE_MESSAGE  64u
+
+typedef struct
+{
+    uint64_t cycles;        // first byte written or sent .. last one on the line
+    uint64_t isrCycles;
+    uint32_t bytes;         // bytes that arrived intact
+    uint64_t errors;        // characters lost: host errors, FERR, overruns
+} SIM_BENCH_RATE;
+
+static void SIM_BenchRateSet(uint32_t baud, bool legacy)
+{
+    UART_SERIAL_SETUP setup =
+    {
+        .baudRate = baud,
+        .parity = UART_PARITY_NONE,
+        .dataWidth = UART_DATA_8_BIT,
+        .stopBits = UART_STOP_1_BIT,
+    };
+
+    (void)UART2_SerialSetup(&setup, 0u);
+    if (legacy)
+    {
+        uint32_t brg = ((SIM_PB_CLOCK_HZ >> 4) + (baud >> 1)) / baud;
+
+        U2MODECLR = _U2MODE_BRGH_MASK;
+        U2BRG = (brg != 0u) ? (brg - 1u) : 0u;
+    }
+    (void)UART2_ErrorGet();
+}
+
+static void SIM_BenchRateTx(const uint8_t *data, SIM_BENCH_RATE *result)
+{
+    SIM_UART_STATS before;
+    SIM_UART_STATS after;
+    uint64_t start = simCycles;
+    uint64_t isrStart = simIsrCycles;
+    size_t sent;
+
+    SIM_UART_StatsGet(&before);
+    for (sent = 0; sent < SIM_BENCH_RATE_BYTES; sent += SIM_BENCH_RATE_MESSAGE)
+    {
+        while (UART2_WriteFreeBufferCountGet() < SIM_BENCH_RATE_MESSAGE)
+        {
+            SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+        }
+        (void)UART2_Write((uint8_t *)&data[sent], SIM_BENCH_RATE_MESSAGE);
+    }
+    SIM_BenchUartDrain();
+    SIM_UART_StatsGet(&after);
+    result->cycles = simCycles - start;
+    result->isrCycles = simIsrCycles - isrStart;
+    result->errors = after.hostErrors - before.hostErrors;
+    result->bytes = (uint32_t)(after.bytesTx - before.bytesTx - result->errors);
+}
+
+static void SIM_BenchRateRx(const uint8_t *data, SIM_BENCH_RATE *result)
+{
+    static uint8_t rx[SIM_BENCH_RATE_BYTES];
+    SIM_UART_STATS before;
+    SIM_UART_STATS after;
+    // a few characters of slack for the host rate being rounded
+    uint64_t charCycles = SIM_CPU_CLOCK_HZ * 10ull / SIM_UART_HostBaudGet();
+    uint64_t start = simCycles;
+    uint64_t end = start + (SIM_BENCH_RATE_BYTES + 4u) * charCycles;
+    uint64_t isrStart = simIsrCycles;
+    size_t received = 0;
+    size_t i;
+
+    SIM_UART_StatsGet(&before);
+    SIM_UART_RxInject(data, SIM_BENCH_RATE_BYTES);
+    while (simCycles < end)
+    {
+        received += UART2_Read(&rx[received], SIM_BENCH_RATE_BYTES - received);
+        SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+    }
+    // nothing may be left over for the next rate
+    while ((received < SIM_BENCH_RATE_BYTES) && (UART2_ReadCountGet() != 0u))
+    {
+        received += UART2_Read(&rx[received], SIM_BENCH_RATE_BYTES - received);
+    }
+    while (UART2_Read(rx, 1u) != 0u)
+    {
+    }
+    (void)UART2_ErrorGet();
+    SIM_UART_StatsGet(&after);
+    result->cycles = end - start;
+    result->isrCycles = simIsrCycles - isrStart;
+    result->errors = (after.framingErrors - before.framingErrors)
+        + (after.overruns - before.overruns);
+    // a framing error flushes the FIFO, count the bytes still in order
+    for (i = 0; (i < received) && (rx[i] == data[i]); i++)
+    {
+    }
+    result->bytes = (uint32_t)i;
+}
+
+static void SIM_BenchRatePrint(FILE *out, const char *dir, const SIM_BENCH_RATE *r)
+{
+    fprintf(out, "  %s %8.0f %6.1f%% %6llu", dir,
+            (double)r->bytes * SIM_CPU_CLOCK_HZ / (double)r->cycles,
+            100.0 * (double)r->isrCycles / (double)r->cycles, (unsigned long long)r->errors);
+}
+
+int SIM_BenchUartRate(FILE *out)
+{
+    static uint8_t data[SIM_BENCH_RATE_BYTES];
+    size_t i;
+    unsigned legacy;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 7u + 1u);
+    }
+    simQuiet = true;
+    fprintf(out, "uart2 rates, %u bytes each way, host at the nominal rate (%s):\n"
+            "  nominal  divider   brg   actual  error |  tx  bytes/s   cpu   lost |"
+            "  rx  bytes/s   cpu   lost\n", SIM_BENCH_RATE_BYTES,
+            (UART2_TX_DMA != 0) ? "TX by DMA" : "TX interrupt");
+    for (i = 0; i < sizeof(benchUartRates) / sizeof(benchUartRates[0]); i++)
+    {
+        uint32_t baud = benchUartRates[i];
+
+        for (legacy = 1; legacy < 3u; legacy++)
+        {
+            SIM_BENCH_RATE tx;
+            SIM_BENCH_RATE rx;
+            uint32_t actual;
+
+            SIM_BenchRateSet(baud, legacy == 1u);
+            SIM_UART_HostBaudSet(baud);
+            actual = UART2_BaudRateGet();
+            SIM_BenchRateTx(data, &tx);
+            SIM_BenchRateRx(data, &rx);
+            fprintf(out, "  %7u  %-7s %5u %8u %5.1f%% |", (unsigned)baud,
+                    (legacy == 1u) ? "old /16" : ((U2MODE & _U2MODE_BRGH_MASK) ? "new /4" : "new /16"),
+                    (unsigned)(U2BRG & 0xFFFFu), (unsigned)actual,
+                    100.0 * ((double)actual - baud) / baud);
+            SIM_BenchRatePrint(out, "", &tx);
+            fputs(" |", out);
+            SIM_BenchRatePrint(out, "", &rx);
+            fputc('\n', out);
+        }
+    }
+    return 0;
+}
+
+// SYS_TIME timer benchmark (option -X)
+
+// simulated time the timers run
+#define SIM_BENCH_TIME_RUN_US   200000u
+
+// SYS_TIME_CounterSet() steps during the second run, counts of each step
+#define SIM_BENCH_TIME_SET_US   10000u
+#define SIM_BENCH_TIME_SET_BACK 1000000u
+#define SIM_BENCH_TIME_SET_FWD  0x80000000u
+// half the shortest period, a timer that fires on a step or misses one is
+// off by more than this
+#define SIM_BENCH_TIME_SET_SLACK_US 500u
+
+static uint32_t benchTimeExpiries;
+// per timer: period and last expiry in cycles, largest difference of two
+// expiries from the period
+static uint64_t benchTimePeriod[SYS_TIME_MAX_TIMERS];
+static uint64_t benchTimeLast[SYS_TIME_MAX_TIMERS];
+static uint64_t benchTimeError;
+
+static void SIM_BenchTimeCallback(uintptr_t context)
+{
+    uint64_t interval = simCycles - benchTimeLast[context];
+    uint64_t error = (interval > benchTimePeriod[context])
+                     ? interval - benchTimePeriod[context]
+                     : benchTimePeriod[context] - interval;
+
+    if ((benchTimeLast[context] != 0u) && (error > benchTimeError))
+    {
+        benchTimeError = error;
+    }
+    benchTimeLast[context] = simCycles;
+    benchTimeExpiries++;
+}
+
+// runs the timers for SIM_BENCH_TIME_RUN_US, moving SYS_TIME_CounterSet()
+// back and forth every SIM_BENCH_TIME_SET_US when counterSet is true.
+// Returns the largest time since the last expiry of a timer at the end
+// beyond its period, in cycles.
+static uint64_t SIM_BenchTimeRun(uint32_t count, bool counterSet)
+{
+    uint64_t end = simCycles + SIM_US_TO_CYCLES(SIM_BENCH_TIME_RUN_US);
+    uint64_t next = simCycles + SIM_US_TO_CYCLES(SIM_BENCH_TIME_SET_US);
+    uint64_t late = 0;
+    bool back = true;
+    uint32_t i;
+
+    benchTimeExpiries = 0;
+    benchTimeError = 0;
+    while (simCycles < end)
+    {
+        SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+        if (counterSet && (simCycles >= next))
+        {
+            uint32_t now = SYS_TIME_CounterGet();
+
+            SYS_TIME_CounterSet(back ? now - SIM_BENCH_TIME_SET_BACK : now + SIM_BENCH_TIME_SET_FWD);
+            back = !back;
+            next += SIM_US_TO_CYCLES(SIM_BENCH_TIME_SET_US);
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (simCycles - benchTimeLast[i] > benchTimePeriod[i] + late)
+        {
+            late = simCycles - benchTimeLast[i] - benchTimePeriod[i];
+        }
+    }
+    return late;
+}
+
+int SIM_BenchTimers(FILE *out, uint32_t count)
+{
+    uint64_t createSum = 0;
+    uint64_t startSum = 0;
+    uint64_t startMax = 0;
+    uint64_t isrCycles;
+    uint64_t isrCount;
+    uint64_t error;
+    uint64_t late;
+    uint64_t lateWithout;
+    uint32_t expiries;
+    uint32_t seed = 1u;
+    uint32_t i;
+
+    if (count > SYS_TIME_MAX_TIMERS)
+    {
+        fprintf(stderr, "sim: -X %u exceeds SYS_TIME_MAX_TIMERS (%u), "
+                "rebuild with TIME_TIMERS=%u\n", count,
+                (unsigned)SYS_TIME_MAX_TIMERS, count);
+        return -1;
+    }
+    simQuiet = true;
+    for (i = 0; i < count; i++)
+    {
+        uint64_t start = simCycles;
+        uint64_t isrStart = simIsrCycles;
+        uint64_t cycles;
+        SYS_TIME_HANDLE h;
+        uint32_t us;
+
+        // periods spread over 1 .. 10 ms, so expiries rarely coincide
+        seed = seed * 1103515245u + 12345u;
+        us = 1000u + (seed >> 8) % 9000u;
+        h = SYS_TIME_TimerCreate(0, SYS_TIME_USToCount(us), SIM_BenchTimeCallback, i,
+                                 SYS_TIME_PERIODIC);
+        benchTimePeriod[i] = (uint64_t)SYS_TIME_USToCount(us) * SIM_CORE_TIMER_DIV;
+        benchTimeLast[i] = 0;
+        if (h == SYS_TIME_HANDLE_INVALID)
+        {
+            fprintf(stderr, "sim: timer %u of %u refused\n", i + 1u, count);
+            return -1;
+        }
+        // an expiry during the call is not its cost
+        createSum += (simCycles - start) - (simIsrCycles - isrStart);
+        start = simCycles;
+        isrStart = simIsrCycles;
+        (void)SYS_TIME_TimerStart(h);
+        cycles = (simCycles - start) - (simIsrCycles - isrStart);
+        startSum += cycles;
+        if (cycles > startMax)
+        {
+            startMax = cycles;
+        }
+    }
+    isrCycles = SIM_IrqCyclesGet(_CORE_TIMER_VECTOR);
+    isrCount = SIM_IrqCountGet(_CORE_TIMER_VECTOR);
+    lateWithout = SIM_BenchTimeRun(count, false);
+    isrCycles = SIM_IrqCyclesGet(_CORE_TIMER_VECTOR) - isrCycles;
+    isrCount = SIM_IrqCountGet(_CORE_TIMER_VECTOR) - isrCount;
+    fprintf(out, "sys_time %s, %3u timers: create %5llu, start %5llu avg %5llu max, "
+            "%5llu ISR cycles per expiry, %u expiries in %llu interrupts, max %llu cycles\n",
+            SYS_TIME_TIMER_HEAP ? "heap" : "list", count, (unsigned long long)(createSum / count),
+            (unsigned long long)(startSum / count), (unsigned long long)startMax,
+            (unsigned long long)(isrCycles / (benchTimeExpiries ? benchTimeExpiries : 1u)),
+            (unsigned)benchTimeExpiries, (unsigned long long)isrCount,
+            (unsigned long long)SIM_IrqMaxCyclesGet(_CORE_TIMER_VECTOR));
+
+    // the same with SYS_TIME_CounterSet() stepping the counter, the timers
+    // must keep their periods
+    error = benchTimeError;
+    expiries = benchTimeExpiries;
+    late = SIM_BenchTimeRun(count, true);
+    fprintf(out, "sys_time %s, %3u timers: CounterSet every %u us: %u expiries (%u without), "
+            "period error %llu cycles (%llu without), %llu cycles late at the end (%llu without)\n",
+            SYS_TIME_TIMER_HEAP ? "heap" : "list", count, SIM_BENCH_TIME_SET_US,
+            (unsigned)benchTimeExpiries, (unsigned)expiries,
+            (unsigned long long)benchTimeError, (unsigned long long)error,
+            (unsigned long long)late, (unsigned long long)lateWithout);
+    if ((benchTimeError > error + SIM_US_TO_CYCLES(SIM_BENCH_TIME_SET_SLACK_US))
+        || (late > lateWithout + SIM_US_TO_CYCLES(SIM_BENCH_TIME_SET_SLACK_US)))
+    {
+        fprintf(stderr, "sim: SYS_TIME_CounterSet() moved the timers\n");
+        return -1;
+    }
+    return 0;
+}
+
+// *****************************************************************************
+// Section: SYS_TIME timestamps (-Y)
+// *****************************************************************************
+// injected interrupt, on average every this many cycles
+#define SIM_BENCH_STAMP_INJECT  200u
+// periodic timers that keep the core timer interrupt publishing
+#define SIM_BENCH_STAMP_TIMERS  3u
+// task reads between two timer starts, which publish from the task
+#define SIM_BENCH_STAMP_RESTART 16u
+#define SIM_BENCH_STAMP_CONTEXTS 5u
+#define SIM_BENCH_STAMP_APIS    2u
+
+typedef struct
+{
+    uint64_t reads;
+    uint64_t wrong;
+    uint64_t cycles;
+    uint64_t maxCycles;
+} SIM_BENCH_STAMP;
+
+typedef uint64_t (*SIM_BENCH_COUNTER)(void);
+
+static const char *const benchStampContexts[SIM_BENCH_STAMP_CONTEXTS] =
+{
+    "task", "CORE_TIMER", "I2C_1", "UART_2", "injected"
+};
+static const SIM_BENCH_COUNTER benchStampApis[SIM_BENCH_STAMP_APIS] =
+{
+    SYS_TIME_TimestampGet, SYS_TIME_Counter64Get
+};
+static SIM_BENCH_STAMP benchStamp[SIM_BENCH_STAMP_CONTEXTS][SIM_BENCH_STAMP_APIS];
+static volatile bool benchStampI2cBusy;
+
+// one read, wrong unless it lies between Count at the call and Count at the
+// return. Cycles of the call, without the handlers that preempted it.
+static void SIM_BenchStampRead(unsigned context, unsigned api)
+{
+    SIM_BENCH_STAMP *s = &benchStamp[context][api];
+    uint64_t start = simCycles;
+    uint64_t isrStart = simIsrCycles;
+    uint32_t before = SIM_CoreTimerCountGet();
+    uint64_t stamp = benchStampApis[api]();
+    uint32_t after = SIM_CoreTimerCountGet();
+    uint64_t cycles = (simCycles - start) - (simIsrCycles - isrStart);
+
+    // the run is far shorter than one wrap of Count, so the 64-bit counter
+    // is Count itself
+    s->reads++;
+    if ((stamp > after) || (stamp < before))
+    {
+        s->wrong++;
+    }
+    s->cycles += cycles;
+    if (cycles > s->maxCycles)
+    {
+        s->maxCycles = cycles;
+    }
+}
+
+static void SIM_BenchStampHook(unsigned vector)
+{
+    unsigned context;
+    unsigned api;
+
+    switch (vector)
+    {
+        case _CORE_TIMER_VECTOR:
+            context = 1u;
+            break;
+        case _I2C_1_VECTOR:
+            context = 2u;
+            break;
+        case _UART_2_VECTOR:
+            context = 3u;
+            break;
+        default:
+            return;
+    }
+    for (api = 0; api < SIM_BENCH_STAMP_APIS; api++)
+    {
+        SIM_BenchStampRead(context, api);
+    }
+}
+
+static void SIM_BenchStampInjected(void)
+{
+    unsigned api;
+
+    for (api = 0; api < SIM_BENCH_STAMP_APIS; api++)
+    {
+        SIM_BenchStampRead(4u, api);
+    }
+}
+
+static void SIM_BenchStampI2cHandler(DRV_I2C_TRANSFER_EVENT event,
+                                     DRV_I2C_TRANSFER_HANDLE transferHandle,
+                                     uintptr_t context)
+{
+    (void)event;
+    (void)transferHandle;
+    (void)context;
+    benchStampI2cBusy = false;
+}
+
+static void SIM_BenchStampTimer(uintptr_t context)
+{
+    (void)context;
+}
+
+int SIM_BenchTimestamp(FILE *out, uint8_t address, uint32_t reads)
+{
+    static const uint32_t periodsUs[SIM_BENCH_STAMP_TIMERS] = { 31u, 47u, 73u };
+    static uint8_t line[32];
+    static uint8_t rx;
+    SYS_TIME_HANDLE restart;
+    DRV_I2C_TRANSFER_HANDLE th;
+    DRV_HANDLE h;
+    uint64_t wrong = 0;
+    uint64_t start;
+    uint32_t i;
+    unsigned c;
+    unsigned api;
+
+    if (SYS_TIME_MAX_TIMERS < SIM_BENCH_STAMP_TIMERS + 1u)
+    {
+        fprintf(stderr, "sim: -Y needs %u SYS_TIME timers\n", SIM_BENCH_STAMP_TIMERS + 1u);
+        return -1;
+    }
+    simQuiet = true;
+    h = DRV_I2C_Open(DRV_I2C_INDEX_0, DRV_IO_INTENT_READWRITE);
+    if (h == DRV_HANDLE_INVALID)
+    {
+        fprintf(stderr, "sim: DRV_I2C_Open failed\n");
+        return -1;
+    }
+    DRV_I2C_TransferEventHandlerSet(h, SIM_BenchStampI2cHandler, 0);
+    for (i = 0; i < SIM_BENCH_STAMP_TIMERS; i++)
+    {
+        if (SYS_TIME_CallbackRegisterUS(SIM_BenchStampTimer, i, periodsUs[i],
+                                        SYS_TIME_PERIODIC) == SYS_TIME_HANDLE_INVALID)
+        {
+            fprintf(stderr, "sim: timer %u refused\n", i + 1u);
+            return -1;
+        }
+    }
+    restart = SYS_TIME_TimerCreate(0, SYS_TIME_MSToCount(10u), SIM_BenchStampTimer, 0,
+                                   SYS_TIME_PERIODIC);
+    memset(line, 'x', sizeof(line));
+    memset(benchStamp, 0, sizeof(benchStamp));
+    start = simCycles;
+    SIM_IrqHookSet(SIM_BenchStampHook);
+    SIM_IrqInjectSet(SIM_BenchStampInjected, SIM_BENCH_STAMP_INJECT);
+    for (i = 0; i < reads; i++)
+    {
+        for (api = 0; api < SIM_BENCH_STAMP_APIS; api++)
+        {
+            SIM_BenchStampRead(0u, api);
+        }
+        if ((i % SIM_BENCH_STAMP_RESTART) == 0u)
+        {
+            (void)SYS_TIME_TimerStop(restart);
+            (void)SYS_TIME_TimerStart(restart);
+        }
+        if (!benchStampI2cBusy)
+        {
+            benchStampI2cBusy = true;
+            DRV_I2C_ReadTransferAdd(h, address, &rx, 1, &th);
+            if (th == DRV_I2C_TRANSFER_HANDLE_INVALID)
+            {
+                benchStampI2cBusy = false;
+            }
+        }
+        if (UART2_WriteFreeBufferCountGet() >= sizeof(line))
+        {
+            (void)UART2_Write(line, sizeof(line));
+        }
+    }
+    SIM_IrqInjectSet(NULL, 0);
+    SIM_IrqHookSet(NULL);
+
+    fprintf(out, "sys_time reads in %.1f ms, checked against CP0 Count, interrupt injected "
+            "every %u cycles on average:\n"
+            "  context        TimestampGet: reads  wrong  cycles avg  max"
+            "   Counter64Get: reads  wrong  cycles avg  max\n",
+            SIM_CYCLES_TO_US(simCycles - start) / 1000.0, SIM_BENCH_STAMP_INJECT);
+    for (c = 0; c < SIM_BENCH_STAMP_CONTEXTS; c++)
+    {
+        fprintf(out, "  %-10s", benchStampContexts[c]);
+        for (api = 0; api < SIM_BENCH_STAMP_APIS; api++)
+        {
+            const SIM_BENCH_STAMP *s = &benchStamp[c][api];
+
+            fprintf(out, "  %19llu %6llu %11.1f %4llu", (unsigned long long)s->reads,
+                    (unsigned long long)s->wrong,
+                    s->reads ? (double)s->cycles / s->reads : 0.0,
+                    (unsigned long long)s->maxCycles);
+        }
+        fputc('\n', out);
+        wrong += benchStamp[c][0].wrong;
+    }
+    return (wrong == 0u) ? 0 : -1;
+}
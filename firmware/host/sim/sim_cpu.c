@@ -0,0 +1,531 @@
+/*******************************************************************************
+  PIC32MX host simulator - CPU
+
+  File Name:
+    sim_cpu.c
+
+  Summary:
+    Cycle counter, CP0 registers, core timer and interrupt controller.
+
+  Description:
+    __sanitizer_cov_trace_pc() is called by every instrumented basic block of
+    the firmware and is the heartbeat of the simulation. Interrupts are taken
+    only between basic blocks (or SFR accesses), when Status.IE is set and no
+    other handler is running. All vectors are configured as ipl1SOFT by MCC,
+    so there is no nesting. Each vector also counts how long its requests
+    waited for the handler.
+
+    For the tests of code shared with handlers, SIM_IrqInjectSet() adds an
+    interrupt that is requested at random cycles, and SIM_IrqHookSet() a
+    function run on entry of every vector, before its handler.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "xc.h"
+
+// handlers from config/default/interrupts.c
+void CORE_TIMER_Handler(void);
+void I2C_1_Handler(void);
+void UART_2_Handler(void);
+void DMA_0_Handler(void);
+
+typedef struct
+{
+    const char *name;
+    unsigned vector;
+    uint32_t ifsAddress;
+    uint32_t iecAddress;
+    uint32_t mask;
+    uint32_t ipcAddress;
+    uint32_t ipcPriorityMask;
+    void (*handler)(void);
+    // request line of a simulator model, used instead of IFS & IEC when set
+    bool (*pending)(void);
+} SIM_VECTOR;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t cycles;
+    uint64_t maxCycles;
+    // from the request to the handler, behind another handler or IE clear
+    uint64_t waitCycles;
+    uint64_t maxWaitCycles;
+} SIM_VECTOR_STATS;
+
+// ordered by natural priority (lower vector number wins)
+static const SIM_VECTOR simVectors[] = {
+    { "CORE_TIMER", _CORE_TIMER_VECTOR, IFS0_ADDR, IEC0_ADDR, _IFS0_CTIF_MASK,
+      IPC0_ADDR, 0x0000001Cu, CORE_TIMER_Handler },
+    { "I2C_1", _I2C_1_VECTOR, IFS1_ADDR, IEC1_ADDR,
+      _IFS1_I2C1BIF_MASK | _IFS1_I2C1SIF_MASK | _IFS1_I2C1MIF_MASK,
+      IPC8_ADDR, 0x00001C00u, I2C_1_Handler },
+    { "UART_2", _UART_2_VECTOR, IFS1_ADDR, IEC1_ADDR,
+      _IFS1_U2EIF_MASK | _IFS1_U2RXIF_MASK | _IFS1_U2TXIF_MASK,
+      IPC9_ADDR, 0x00001C00u, UART_2_Handler },
+    { "DMA_0", _DMA_0_VECTOR, IFS1_ADDR, IEC1_ADDR, _IFS1_DMA0IF_MASK,
+      IPC10_ADDR, 0x0000001Cu, DMA_0_Handler },
+    // I2C1 interrupt as raised by the transaction level PLIB model (-f)
+    { "I2C_1 model", _I2C_1_VECTOR, 0u, 0u, 0u,
+      IPC8_ADDR, 0x00001C00u, SIM_I2C_PLIB_InterruptHandler, SIM_I2C_PLIB_IrqPending },
+};
+#define SIM_VECTOR_COUNT (sizeof(simVectors) / sizeof(simVectors[0]))
+
+static SIM_VECTOR_STATS vectorStats[SIM_VECTOR_COUNT];
+// simCycles + 1 when the request of a vector was first seen, 0 when none
+static uint64_t vectorRequestCycles[SIM_VECTOR_COUNT];
+
+uint64_t simCycles;
+uint64_t simIsrCycles;
+bool simInIsr;
+uint64_t simNextEvent = SIM_TIME_NEVER;
+bool simInPoll;
+
+static uint32_t cp0Status;
+static uint32_t cp0Cause;
+static uint32_t cp0Config;
+static uint32_t cp0Compare;
+// Count = countBase + (simCycles - countBaseCycles) / SIM_CORE_TIMER_DIV
+static uint32_t countBase;
+static uint64_t countBaseCycles;
+static uint64_t coreTimerMatch = SIM_TIME_NEVER;
+
+// injected interrupt, requested every 1 .. 2 * injectMean cycles
+static void (*injectHandler)(void);
+static uint32_t injectMean;
+static uint32_t injectSeed = 1u;
+static uint64_t injectAt = SIM_TIME_NEVER;
+static bool injectPending;
+static void (*irqHook)(unsigned vector);
+
+#define SIM_CP0_STATUS_IE   0x00000001u
+
+// *****************************************************************************
+// Section: Core timer
+// *****************************************************************************
+static bool SIM_CoreTimerRunning(void)
+{
+    return (cp0Cause & _CP0_CAUSE_DC_MASK) == 0u;
+}
+
+static uint32_t SIM_CoreTimerCount(void)
+{
+    if (!SIM_CoreTimerRunning())
+    {
+        return countBase;
+    }
+    return countBase + (uint32_t)((simCycles - countBaseCycles) / SIM_CORE_TIMER_DIV);
+}
+
+uint32_t SIM_CoreTimerCountGet(void)
+{
+    return SIM_CoreTimerCount();
+}
+
+static void SIM_CoreTimerRebase(void)
+{
+    countBase = SIM_CoreTimerCount();
+    countBaseCycles = simCycles;
+}
+
+static void SIM_CoreTimerSchedule(void)
+{
+    if (!SIM_CoreTimerRunning())
+    {
+        coreTimerMatch = SIM_TIME_NEVER;
+    }
+    else
+    {
+        uint64_t ticks = (uint64_t)(uint32_t)(cp0Compare - countBase);
+        uint64_t elapsed = (simCycles - countBaseCycles) / SIM_CORE_TIMER_DIV;
+
+        // Count == Compare happens once per 2^32 ticks
+        while (ticks <= elapsed)
+        {
+            ticks += 0x100000000ull;
+        }
+        coreTimerMatch = countBaseCycles + ticks * SIM_CORE_TIMER_DIV;
+    }
+    SIM_EventsReschedule();
+}
+
+uint64_t SIM_CoreTimerNextEvent(void)
+{
+    return coreTimerMatch;
+}
+
+void SIM_CoreTimerEvent(void)
+{
+    *SIM_SFR_Ptr(IFS0_ADDR) |= _IFS0_CTIF_MASK;
+    SIM_CoreTimerSchedule();
+}
+
+// *****************************************************************************
+// Section: CP0 access
+// *****************************************************************************
+uint32_t SIM_CP0_Read(unsigned reg, unsigned sel)
+{
+    (void)sel;
+    switch (reg)
+    {
+        case _CP0_COUNT:
+            return SIM_CoreTimerCount();
+        case _CP0_COMPARE:
+            return cp0Compare;
+        case _CP0_STATUS:
+            return cp0Status;
+        case _CP0_CAUSE:
+            return cp0Cause;
+        case _CP0_CONFIG:
+            return cp0Config;
+        default:
+            return 0u;
+    }
+}
+
+void SIM_CP0_Write(unsigned reg, unsigned sel, uint32_t value)
+{
+    (void)sel;
+    simCycles += 1u;
+    switch (reg)
+    {
+        case _CP0_COUNT:
+            countBase = value;
+            countBaseCycles = simCycles;
+            SIM_CoreTimerSchedule();
+            break;
+        case _CP0_COMPARE:
+            SIM_CoreTimerRebase();
+            cp0Compare = value;
+            SIM_CoreTimerSchedule();
+            break;
+        case _CP0_STATUS:
+            cp0Status = value;
+            SIM_Poll();
+            break;
+        case _CP0_CAUSE:
+            SIM_CoreTimerRebase();
+            cp0Cause = value;
+            SIM_CoreTimerSchedule();
+            break;
+        case _CP0_CONFIG:
+            cp0Config = value;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t SIM_InterruptsDisable(void)
+{
+    uint32_t status = cp0Status;
+
+    simCycles += 1u;
+    cp0Status &= ~SIM_CP0_STATUS_IE;
+    return status;
+}
+
+uint32_t SIM_InterruptsEnable(void)
+{
+    uint32_t status = cp0Status;
+
+    simCycles += 1u;
+    cp0Status |= SIM_CP0_STATUS_IE;
+    SIM_Poll();
+    return status;
+}
+
+void SIM_SoftwareBreakpoint(void)
+{
+    fprintf(stderr, "sim: software breakpoint at cycle %llu\n",
+            (unsigned long long)simCycles);
+    exit(EXIT_FAILURE);
+}
+
+// *****************************************************************************
+// Section: Scheduler
+// *****************************************************************************
+void SIM_EventsReschedule(void)
+{
+    uint64_t next = coreTimerMatch;
+    uint64_t t = SIM_I2C_NextEvent();
+
+    if (t < next)
+    {
+        next = t;
+    }
+    t = SIM_UART_NextEvent();
+    if (t < next)
+    {
+        next = t;
+    }
+    t = SIM_I2C_PLIB_NextEvent();
+    if (t < next)
+    {
+        next = t;
+    }
+    if (injectAt < next)
+    {
+        next = injectAt;
+    }
+    simNextEvent = next;
+}
+
+static void SIM_PeripheralsPoll(void)
+{
+    if (simInPoll)
+    {
+        return;
+    }
+    simInPoll = true;
+    do
+    {
+        if (simSfrDirty)
+        {
+            SIM_SFR_Sync();
+        }
+        while (simCycles >= simNextEvent)
+        {
+            if (simCycles >= coreTimerMatch)
+            {
+                SIM_CoreTimerEvent();
+            }
+            if (simCycles >= SIM_I2C_NextEvent())
+            {
+                SIM_I2C_Event();
+            }
+            if (simCycles >= SIM_UART_NextEvent())
+            {
+                SIM_UART_Event();
+                // the TX request is a DMA start IRQ
+                SIM_DMA_Sync();
+            }
+            if (simCycles >= SIM_I2C_PLIB_NextEvent())
+            {
+                SIM_I2C_PLIB_Event();
+            }
+            if (simCycles >= injectAt)
+            {
+                injectPending = true;
+                injectSeed = injectSeed * 1103515245u + 12345u;
+                injectAt = simCycles + 1u + (injectSeed >> 8) % (2u * injectMean);
+            }
+            SIM_EventsReschedule();
+        }
+    } while (simSfrDirty);
+    simInPoll = false;
+}
+
+static bool SIM_IrqRequested(const SIM_VECTOR *v)
+{
+    bool request = (v->pending != NULL) ? v->pending() :
+        ((*SIM_SFR_Ptr(v->ifsAddress) & *SIM_SFR_Ptr(v->iecAddress) & v->mask) != 0u);
+
+    return request && ((*SIM_SFR_Ptr(v->ipcAddress) & v->ipcPriorityMask) != 0u);
+}
+
+static const SIM_VECTOR *SIM_IrqPending(size_t *index)
+{
+    size_t i;
+
+    for (i = 0; i < SIM_VECTOR_COUNT; i++)
+    {
+        if (SIM_IrqRequested(&simVectors[i]))
+        {
+            *index = i;
+            return &simVectors[i];
+        }
+    }
+    return NULL;
+}
+
+// notes when each request was raised, a request withdrawn before it was
+// taken is forgotten
+static void SIM_IrqRequestsNote(void)
+{
+    size_t i;
+
+    for (i = 0; i < SIM_VECTOR_COUNT; i++)
+    {
+        if (!SIM_IrqRequested(&simVectors[i]))
+        {
+            vectorRequestCycles[i] = 0;
+        }
+        else if (vectorRequestCycles[i] == 0u)
+        {
+            vectorRequestCycles[i] = simCycles + 1u;
+        }
+    }
+}
+
+static void SIM_IrqDispatch(void)
+{
+    while (((cp0Status & SIM_CP0_STATUS_IE) != 0u) && !simInIsr)
+    {
+        size_t index;
+        const SIM_VECTOR *v = SIM_IrqPending(&index);
+        uint64_t start = simCycles;
+        uint64_t cycles;
+        uint64_t wait;
+
+        if (v == NULL)
+        {
+            if (!injectPending)
+            {
+                break;
+            }
+            // the lowest priority, taken when no vector is requested
+            injectPending = false;
+            simInIsr = true;
+            simCycles += SIM_CYCLES_PER_IRQ;
+            injectHandler();
+            simInIsr = false;
+            simIsrCycles += simCycles - start;
+            SIM_PeripheralsPoll();
+            continue;
+        }
+        wait = (vectorRequestCycles[index] != 0u) ? start - (vectorRequestCycles[index] - 1u) : 0u;
+        vectorRequestCycles[index] = 0;
+        vectorStats[index].waitCycles += wait;
+        if (wait > vectorStats[index].maxWaitCycles)
+        {
+            vectorStats[index].maxWaitCycles = wait;
+        }
+        simInIsr = true;
+        simCycles += SIM_CYCLES_PER_IRQ;
+        if (irqHook != NULL)
+        {
+            irqHook(v->vector);
+        }
+        v->handler();
+        simInIsr = false;
+        cycles = simCycles - start;
+        simIsrCycles += cycles;
+        vectorStats[index].count++;
+        vectorStats[index].cycles += cycles;
+        if (cycles > vectorStats[index].maxCycles)
+        {
+            vectorStats[index].maxCycles = cycles;
+        }
+        // writes done by the handler (IFSxCLR etc.) take effect before
+        // we decide whether to re-enter
+        SIM_PeripheralsPoll();
+    }
+}
+
+void SIM_Poll(void)
+{
+    SIM_PeripheralsPoll();
+    SIM_IrqRequestsNote();
+    SIM_IrqDispatch();
+}
+
+void SIM_IrqInjectSet(void (*handler)(void), uint32_t meanCycles)
+{
+    injectHandler = handler;
+    injectMean = meanCycles;
+    injectPending = false;
+    injectAt = ((handler != NULL) && (meanCycles != 0u)) ? simCycles + meanCycles : SIM_TIME_NEVER;
+    SIM_EventsReschedule();
+}
+
+void SIM_IrqHookSet(void (*hook)(unsigned vector))
+{
+    irqHook = hook;
+}
+
+void SIM_CyclesCharge(uint32_t cycles)
+{
+    simCycles += cycles;
+    if (simCycles >= simNextEvent)
+    {
+        SIM_Poll();
+    }
+}
+
+// basic block hook inserted by -fsanitize-coverage=trace-pc
+void __sanitizer_cov_trace_pc(void)
+{
+    simCycles += SIM_CYCLES_PER_BLOCK;
+    if (simSfrDirty || (simCycles >= simNextEvent))
+    {
+        SIM_Poll();
+    }
+}
+
+void SIM_Reset(void)
+{
+    simCycles = 0;
+    simIsrCycles = 0;
+    simInIsr = false;
+    simInPoll = false;
+    cp0Status = 0;
+    cp0Cause = 0;
+    cp0Config = 0;
+    cp0Compare = 0;
+    countBase = 0;
+    countBaseCycles = 0;
+    memset(vectorStats, 0, sizeof(vectorStats));
+    memset(vectorRequestCycles, 0, sizeof(vectorRequestCycles));
+    SIM_SFR_Reset();
+    SIM_I2C_Reset();
+    SIM_UART_Reset();
+    SIM_DMA_Reset();
+    SIM_CoreTimerSchedule();
+}
+
+// *****************************************************************************
+// Section: Statistics
+// *****************************************************************************
+static size_t SIM_VectorIndex(unsigned vector)
+{
+    size_t i;
+
+    for (i = 0; i < SIM_VECTOR_COUNT; i++)
+    {
+        if (simVectors[i].vector == vector)
+        {
+            return i;
+        }
+    }
+    return SIM_VECTOR_COUNT;
+}
+
+uint64_t SIM_IrqCountGet(unsigned vector)
+{
+    size_t i = SIM_VectorIndex(vector);
+    return (i < SIM_VECTOR_COUNT) ? vectorStats[i].count : 0u;
+}
+
+uint64_t SIM_IrqCyclesGet(unsigned vector)
+{
+    size_t i = SIM_VectorIndex(vector);
+    return (i < SIM_VECTOR_COUNT) ? vectorStats[i].cycles : 0u;
+}
+
+uint64_t SIM_IrqMaxCyclesGet(unsigned vector)
+{
+    size_t i = SIM_VectorIndex(vector);
+    return (i < SIM_VECTOR_COUNT) ? vectorStats[i].maxCycles : 0u;
+}
+
+void SIM_IrqReport(FILE *out)
+{
+    size_t i;
+
+    fprintf(out, "%-12s %10s %14s %10s %10s %10s %10s\n",
+            "interrupt", "count", "cycles", "avg", "max", "wait avg", "wait max");
+    for (i = 0; i < SIM_VECTOR_COUNT; i++)
+    {
+        const SIM_VECTOR_STATS *s = &vectorStats[i];
+
+        fprintf(out, "%-12s %10llu %14llu %10llu %10llu %10llu %10llu\n", simVectors[i].name,
+                (unsigned long long)s->count, (unsigned long long)s->cycles,
+                (unsigned long long)(s->count ? s->cycles / s->count : 0u),
+                (unsigned long long)s->maxCycles,
+                (unsigned long long)(s->count ? s->waitCycles / s->count : 0u),
+                (unsigned long long)s->maxWaitCycles);
+    }
+}
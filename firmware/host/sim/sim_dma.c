@@ -0,0 +1,213 @@
+/*******************************************************************************
+  PIC32MX host simulator - DMA controller
+
+  File Name:
+    sim_dma.c
+
+  Summary:
+    Model of the four DMA channels: start IRQ, cell and block transfers and
+    the block complete interrupt.
+
+  Description:
+    A channel that is enabled (CHEN) moves one cell (DCHxCSIZ bytes) each
+    time its start IRQ is asserted, or once on CFORCE. The only start IRQ
+    the model knows is the UART2 TX request. It is level sensitive, so a
+    cell that fills the TX buffer also ends the request until the buffer
+    has drained again. The source and destination pointers wrap at their
+    sizes. When the larger size has been moved, the block is complete:
+    CHBCIF, CHSDIF and CHDDIF are set, CHEN is cleared unless CHAEN is set,
+    and DMAxIF is raised for enabled flags.
+
+    Addresses are physical. 0x1F8xxxxx and pointers into the SFR register
+    file (what &U2TXREG gives on the host) reach the peripheral registers,
+    a write to U2TXREG goes into the UART TX buffer. Anything else is host
+    memory (see include/sys/kmem.h). Transfers take no simulated time and
+    do not stall the CPU. On silicon they share the bus with it, which is
+    not modelled.
+ *******************************************************************************/
+
+#include "sim.h"
+#include "xc.h"
+
+#define SIM_DMA_PA_SFR_BASE     (SIM_SFR_BASE & 0x1FFFFFFFu)
+#define SIM_DMA_PA_SFR_END      (SIM_SFR_END & 0x1FFFFFFFu)
+
+#define SIM_DCH_REG(ch, addr)   SIM_SFR_Ptr((addr) + (ch) * SIM_DCH_STRIDE)
+#define SIM_DMA_INT_FLAGS       0x000000FFu
+
+typedef struct
+{
+    bool enabled;           // CHEN seen by the model, pointers reset on the rising edge
+    uint32_t done;          // bytes moved in the current block
+} SIM_DMA_CHANNEL;
+
+static SIM_DMA_CHANNEL channels[SIM_DCH_COUNT];
+static uint64_t dmaBytes;
+static uint64_t dmaCells;
+static uint64_t dmaBlocks;
+
+static uint32_t SIM_DMA_Size(uint32_t reg)
+{
+    // 16 bit size registers, 0 means 65536
+    uint32_t size = reg & 0xFFFFu;
+
+    return (size == 0u) ? 0x10000u : size;
+}
+
+static uint8_t SIM_DMA_Read(uint32_t pa)
+{
+    if ((pa >= SIM_DMA_PA_SFR_BASE) && (pa < SIM_DMA_PA_SFR_END))
+    {
+        uint32_t address = pa | 0xA0000000u;
+
+        return (uint8_t)(*SIM_SFR_Ptr(address & ~3u) >> ((address & 3u) * 8u));
+    }
+    return *(const uint8_t *)(uintptr_t)pa;
+}
+
+static void SIM_DMA_Write(uint32_t pa, uint8_t data)
+{
+    uint32_t address = 0u;
+
+    if ((pa >= SIM_DMA_PA_SFR_BASE) && (pa < SIM_DMA_PA_SFR_END))
+    {
+        address = pa | 0xA0000000u;
+    }
+    else
+    {
+        address = SIM_SFR_AddressOf((const void *)(uintptr_t)pa);
+    }
+    if (address == U2TXREG_ADDR)
+    {
+        SIM_UART_TxWrite(data);
+    }
+    else if (address != 0u)
+    {
+        *SIM_SFR_Ptr(address & ~3u) = data;
+    }
+    else
+    {
+        *(uint8_t *)(uintptr_t)pa = data;
+    }
+}
+
+static bool SIM_DMA_StartIrq(uint32_t irq)
+{
+    return (irq == _UART2_TX_IRQ) && SIM_UART_TxRequest();
+}
+
+// one cell, returns true when it completed the block
+static bool SIM_DMA_Cell(unsigned ch)
+{
+    SIM_DMA_CHANNEL *c = &channels[ch];
+    uint32_t ssa = *SIM_DCH_REG(ch, DCH0SSA_ADDR);
+    uint32_t dsa = *SIM_DCH_REG(ch, DCH0DSA_ADDR);
+    uint32_t ssiz = SIM_DMA_Size(*SIM_DCH_REG(ch, DCH0SSIZ_ADDR));
+    uint32_t dsiz = SIM_DMA_Size(*SIM_DCH_REG(ch, DCH0DSIZ_ADDR));
+    uint32_t csiz = SIM_DMA_Size(*SIM_DCH_REG(ch, DCH0CSIZ_ADDR));
+    uint32_t block = (ssiz > dsiz) ? ssiz : dsiz;
+    volatile uint32_t *sptr = SIM_DCH_REG(ch, DCH0SPTR_ADDR);
+    volatile uint32_t *dptr = SIM_DCH_REG(ch, DCH0DPTR_ADDR);
+    uint32_t n;
+
+    for (n = 0; (n < csiz) && (c->done < block); n++)
+    {
+        SIM_DMA_Write(dsa + *dptr, SIM_DMA_Read(ssa + *sptr));
+        *sptr = (*sptr + 1u == ssiz) ? 0u : *sptr + 1u;
+        *dptr = (*dptr + 1u == dsiz) ? 0u : *dptr + 1u;
+        c->done++;
+    }
+    *SIM_DCH_REG(ch, DCH0CPTR_ADDR) = n;
+    dmaBytes += n;
+    dmaCells++;
+    return c->done == block;
+}
+
+static void SIM_DMA_BlockDone(unsigned ch)
+{
+    volatile uint32_t *con = SIM_DCH_REG(ch, DCH0CON_ADDR);
+    volatile uint32_t *flags = SIM_DCH_REG(ch, DCH0INT_ADDR);
+
+    dmaBlocks++;
+    *flags |= _DCH0INT_CHBCIF_MASK | _DCH0INT_CHSDIF_MASK | 0x20u;  // CHDDIF
+    channels[ch].done = 0u;
+    *SIM_DCH_REG(ch, DCH0SPTR_ADDR) = 0u;
+    *SIM_DCH_REG(ch, DCH0DPTR_ADDR) = 0u;
+    if ((*con & _DCH0CON_CHAEN_MASK) == 0u)
+    {
+        *con &= ~_DCH0CON_CHEN_MASK;
+        channels[ch].enabled = false;
+    }
+}
+
+void SIM_DMA_Sync(void)
+{
+    unsigned ch;
+
+    if ((*SIM_SFR_Ptr(DMACON_ADDR) & _DMACON_ON_MASK) == 0u)
+    {
+        return;
+    }
+    for (ch = 0; ch < SIM_DCH_COUNT; ch++)
+    {
+        volatile uint32_t *con = SIM_DCH_REG(ch, DCH0CON_ADDR);
+        volatile uint32_t *econ = SIM_DCH_REG(ch, DCH0ECON_ADDR);
+        volatile uint32_t *flags = SIM_DCH_REG(ch, DCH0INT_ADDR);
+        SIM_DMA_CHANNEL *c = &channels[ch];
+
+        if ((*econ & _DCH0ECON_CABORT_MASK) != 0u)
+        {
+            *econ &= ~(_DCH0ECON_CABORT_MASK | _DCH0ECON_CFORCE_MASK);
+            *con &= ~_DCH0CON_CHEN_MASK;
+        }
+        if ((*con & _DCH0CON_CHEN_MASK) == 0u)
+        {
+            c->enabled = false;
+            continue;
+        }
+        if (!c->enabled)
+        {
+            c->enabled = true;
+            c->done = 0u;
+            *SIM_DCH_REG(ch, DCH0SPTR_ADDR) = 0u;
+            *SIM_DCH_REG(ch, DCH0DPTR_ADDR) = 0u;
+        }
+        while (c->enabled && (((*econ & _DCH0ECON_CFORCE_MASK) != 0u) ||
+               (((*econ & _DCH0ECON_SIRQEN_MASK) != 0u) &&
+                SIM_DMA_StartIrq((*econ & _DCH0ECON_CHSIRQ_MASK) >> _DCH0ECON_CHSIRQ_POSITION))))
+        {
+            *econ &= ~_DCH0ECON_CFORCE_MASK;
+            if (SIM_DMA_Cell(ch))
+            {
+                SIM_DMA_BlockDone(ch);
+            }
+        }
+        if (((*flags & SIM_DMA_INT_FLAGS) & (*flags >> 16)) != 0u)
+        {
+            *SIM_SFR_Ptr(IFS1_ADDR) |= _IFS1_DMA0IF_MASK << ch;
+        }
+    }
+}
+
+void SIM_DMA_Reset(void)
+{
+    unsigned ch;
+
+    for (ch = 0; ch < SIM_DCH_COUNT; ch++)
+    {
+        channels[ch] = (SIM_DMA_CHANNEL){ 0 };
+    }
+    dmaBytes = 0;
+    dmaCells = 0;
+    dmaBlocks = 0;
+}
+
+void SIM_DMA_Report(FILE *out)
+{
+    if (dmaBlocks != 0u)
+    {
+        fprintf(out, "dma: %llu blocks, %llu cells, %llu bytes\n",
+                (unsigned long long)dmaBlocks, (unsigned long long)dmaCells,
+                (unsigned long long)dmaBytes);
+    }
+}
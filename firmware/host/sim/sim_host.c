@@ -0,0 +1,307 @@
+/*******************************************************************************
+  PIC32MX host simulator - scripted host
+
+  File Name:
+    sim_host.c
+
+  Summary:
+    The PC on the other end of UART2 for the rate switch of app_baud.h
+    (simulator option -B) and commands of the console shell (-S).
+
+  Description:
+    Without APP_BAUD_AUTOBAUD the host waits for the first line of the
+    console, sends "baud <rate>\r", and once the answer is in it changes its
+    own rate and confirms with 0x55. With APP_BAUD_AUTOBAUD it starts at the
+    -B rate and sends 0x55 right away. When no clean answer comes back it
+    tries the next lower standard rate, after the target has given up on the
+    previous one.
+
+    Shell commands (-S, separated by ';') are sent in turn, one every
+    SIM_HOST_TYPE_US at full line speed like a script would, not while a
+    rate switch is going on.
+
+    The host polls from the main loop of sim_main.c, so its actions are late
+    by up to one SYS_Tasks() round. That is well within the timeouts of
+    app_baud.h.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "app_baud.h"
+
+// the target changes its rate right after the last stop bit of its answer
+#define SIM_HOST_CONFIRM_DELAY_US   1000u
+// waits for an answer, longer than APP_BAUD_CONFIRM_MS so that the target
+// has re-armed auto-baud before the next try
+#define SIM_HOST_ANSWER_TIMEOUT_US  ((APP_BAUD_CONFIRM_MS + 100u) * 1000u)
+#define SIM_HOST_LINE_SIZE          80u
+#define SIM_HOST_TYPE_US            20000u
+
+typedef enum
+{
+    SIM_HOST_STATE_OFF = 0,
+    SIM_HOST_STATE_START,       // waits for the first console line
+    SIM_HOST_STATE_ANSWER,      // waits for "baud: <rate>"
+    SIM_HOST_STATE_CONFIRM,     // sends 0x55 at the new rate
+    SIM_HOST_STATE_RESULT,      // waits for "baud: <rate> ok"
+    SIM_HOST_STATE_DONE,
+} SIM_HOST_STATE;
+
+// rates the host steps down through in the auto-baud handshake
+static const uint32_t simHostRates[] =
+{
+    3000000u, 2000000u, 1500000u, 1000000u, 921600u, 460800u, 230400u, 115200u,
+    57600u, 38400u, 19200u, 9600u
+};
+
+typedef struct
+{
+    SIM_HOST_STATE state;
+    uint32_t baud;              // rate asked for, or being tried
+    uint64_t deadline;
+    uint64_t startCycles;
+    uint64_t doneCycles;
+    uint32_t tries;
+    bool ok;
+    char line[SIM_HOST_LINE_SIZE];
+    size_t lineLen;
+    bool lineDamaged;
+} SIM_HOST_OBJ;
+
+static SIM_HOST_OBJ host;
+
+static struct
+{
+    char commands[256];
+    size_t pos;                 // of the next command in commands[]
+    uint64_t next;
+    uint32_t count;
+} hostType;
+
+void SIM_HOST_TypeSet(const char *commands)
+{
+    (void)snprintf(hostType.commands, sizeof(hostType.commands), "%s", commands);
+    hostType.pos = 0;
+    hostType.next = SIM_US_TO_CYCLES(SIM_HOST_TYPE_US);
+    hostType.count = 0;
+}
+
+void SIM_HOST_BaudSwitchSet(uint32_t baud)
+{
+    host = (SIM_HOST_OBJ){ .state = SIM_HOST_STATE_START, .baud = baud };
+}
+
+static void SIM_HOST_Send(const char *text)
+{
+    SIM_UART_RxInject((const uint8_t *)text, strlen(text));
+}
+
+static void SIM_HOST_Finish(bool ok)
+{
+    host.ok = ok;
+    host.doneCycles = simCycles;
+    host.state = SIM_HOST_STATE_DONE;
+}
+
+static void SIM_HOST_Try(void)
+{
+    host.tries++;
+    // whatever came in at the last rate is dropped
+    host.lineLen = 0;
+    host.lineDamaged = false;
+    SIM_UART_HostBaudSet(host.baud);
+    SIM_HOST_Send("U");
+    host.deadline = simCycles + SIM_US_TO_CYCLES(SIM_HOST_ANSWER_TIMEOUT_US);
+    host.state = SIM_HOST_STATE_ANSWER;
+}
+
+static void SIM_HOST_NextRate(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(simHostRates) / sizeof(simHostRates[0]); i++)
+    {
+        if (simHostRates[i] < host.baud)
+        {
+            host.baud = simHostRates[i];
+            SIM_HOST_Try();
+            return;
+        }
+    }
+    SIM_HOST_Finish(false);
+}
+
+// the commands separated by ';' in turn, one each SIM_HOST_TYPE_US
+static void SIM_HOST_Type(void)
+{
+    const char *command = &hostType.commands[hostType.pos];
+    size_t len = strcspn(command, ";");
+
+    if ((hostType.commands[0] == '\0') || (simCycles < hostType.next))
+    {
+        return;
+    }
+    hostType.next += SIM_US_TO_CYCLES(SIM_HOST_TYPE_US);
+    if ((host.state != SIM_HOST_STATE_OFF) && (host.state != SIM_HOST_STATE_DONE))
+    {
+        return;
+    }
+    SIM_UART_RxInject((const uint8_t *)command, len);
+    SIM_HOST_Send("\r");
+    hostType.count++;
+    hostType.pos = (command[len] == ';') ? hostType.pos + len + 1u : 0u;
+}
+
+void SIM_HOST_Poll(void)
+{
+    SIM_HOST_Type();
+    switch (host.state)
+    {
+        case SIM_HOST_STATE_START:
+            if (APP_BAUD_AUTOBAUD)
+            {
+                host.startCycles = simCycles;
+                SIM_HOST_Try();
+            }
+            break;
+
+        case SIM_HOST_STATE_ANSWER:
+            if (simCycles < host.deadline)
+            {
+                break;
+            }
+            if (APP_BAUD_AUTOBAUD)
+            {
+                SIM_HOST_NextRate();
+            }
+            else
+            {
+                SIM_HOST_Finish(false);
+            }
+            break;
+
+        case SIM_HOST_STATE_CONFIRM:
+            if (simCycles < host.deadline)
+            {
+                break;
+            }
+            SIM_HOST_Send("U");
+            host.deadline = simCycles + SIM_US_TO_CYCLES(SIM_HOST_ANSWER_TIMEOUT_US);
+            host.state = SIM_HOST_STATE_RESULT;
+            break;
+
+        case SIM_HOST_STATE_RESULT:
+            if (simCycles >= host.deadline)
+            {
+                // the target went back to the old rate
+                SIM_UART_HostBaudSet(0u);
+                SIM_HOST_Finish(false);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void SIM_HOST_Line(const char *line)
+{
+    char *end;
+    unsigned long baud;
+
+    if (host.state == SIM_HOST_STATE_START)
+    {
+        char command[32];
+
+        // the console is up, ask for the new rate
+        (void)snprintf(command, sizeof(command), "baud %u\r", (unsigned)host.baud);
+        SIM_HOST_Send(command);
+        host.startCycles = simCycles;
+        host.tries++;
+        host.deadline = simCycles + SIM_US_TO_CYCLES(SIM_HOST_ANSWER_TIMEOUT_US);
+        host.state = SIM_HOST_STATE_ANSWER;
+        return;
+    }
+    if (strncmp(line, "baud: ", 6u) != 0)
+    {
+        return;
+    }
+    baud = strtoul(&line[6], &end, 10);
+    if (host.state == SIM_HOST_STATE_ANSWER)
+    {
+        if (*end != '\0')
+        {
+            // "not supported"
+            SIM_HOST_Finish(false);
+            return;
+        }
+        // auto-baud answers with the measured rate, it is close to ours
+        SIM_UART_HostBaudSet(APP_BAUD_AUTOBAUD ? host.baud : (uint32_t)baud);
+        host.deadline = simCycles + SIM_US_TO_CYCLES(SIM_HOST_CONFIRM_DELAY_US);
+        host.state = SIM_HOST_STATE_CONFIRM;
+    }
+    else if (host.state == SIM_HOST_STATE_RESULT)
+    {
+        SIM_HOST_Finish(strcmp(end, " ok") == 0);
+    }
+    else
+    {
+        /* Nothing to do */
+    }
+}
+
+void SIM_HOST_Receive(uint8_t c, bool ok)
+{
+    if ((host.state == SIM_HOST_STATE_OFF) || (host.state == SIM_HOST_STATE_DONE))
+    {
+        return;
+    }
+    if (!ok)
+    {
+        host.lineDamaged = true;
+        return;
+    }
+    if (c == '\r')
+    {
+        return;
+    }
+    if (c != '\n')
+    {
+        if (host.lineLen < sizeof(host.line) - 1u)
+        {
+            host.line[host.lineLen++] = (char)c;
+        }
+        return;
+    }
+    host.line[host.lineLen] = '\0';
+    host.lineLen = 0;
+    if (!host.lineDamaged)
+    {
+        SIM_HOST_Line(host.line);
+    }
+    host.lineDamaged = false;
+}
+
+bool SIM_HOST_Report(FILE *out)
+{
+    if (hostType.count != 0u)
+    {
+        fprintf(out, "host: typed %u commands\n", (unsigned)hostType.count);
+    }
+    if (host.state == SIM_HOST_STATE_OFF)
+    {
+        return true;
+    }
+    if (host.state != SIM_HOST_STATE_DONE)
+    {
+        fprintf(out, "host: %s to %u Bd not finished\n",
+                APP_BAUD_AUTOBAUD ? "auto-baud" : "rate switch", (unsigned)host.baud);
+        return false;
+    }
+    fprintf(out, "host: %s to %u Bd %s after %.1f ms, %u tries\n",
+            APP_BAUD_AUTOBAUD ? "auto-baud" : "rate switch", (unsigned)host.baud,
+            host.ok ? "confirmed" : "failed",
+            SIM_CYCLES_TO_US(host.doneCycles - host.startCycles) / 1000.0, (unsigned)host.tries);
+    return host.ok;
+}
@@ -0,0 +1,333 @@
+/*******************************************************************************
+  PIC32MX host simulator - I2C1 master
+
+  File Name:
+    sim_i2c.c
+
+  Summary:
+    Bus level model of the I2C1 master and the slaves attached to it.
+
+  Description:
+    Each bus primitive (START, RESTART, STOP, address/data byte, receive,
+    ACK) is started by the firmware through I2C1CON or I2C1TRN and completes
+    after the number of SCL periods it takes on the wire. Completion raises
+    I2C1MIF, as the silicon does. SCL period = 2 * (I2C1BRG + 2) PBCLK
+    cycles, which gives 101 kHz for the BRG=235 the MCC PLIB programs.
+    Slaves may stretch the clock on each byte. A bus collision can be
+    injected on every n-th START, which raises I2C1BIF instead.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include "sim.h"
+#include "xc.h"
+
+// I2C1TRN holds this value until the firmware writes a byte to it
+#define SIM_I2C_TRN_EMPTY   0xFFFFFFFFu
+
+typedef enum
+{
+    SIM_I2C_OP_NONE = 0,
+    SIM_I2C_OP_START,
+    SIM_I2C_OP_RESTART,
+    SIM_I2C_OP_STOP,
+    SIM_I2C_OP_TX,
+    SIM_I2C_OP_RX,
+    SIM_I2C_OP_ACK,
+} SIM_I2C_OP;
+
+typedef struct
+{
+    SIM_I2C_OP op;
+    uint64_t doneAt;
+    uint8_t txByte;
+    bool addressPhase;
+    bool busBusy;
+    uint64_t busBusySince;
+    SIM_I2C_SLAVE *slaves;
+    SIM_I2C_SLAVE *active;
+    // statistics
+    uint64_t starts;
+    uint64_t stops;
+    uint64_t bytesTx;
+    uint64_t bytesRx;
+    uint64_t nacks;
+    uint64_t busCycles;
+    uint64_t busErrors;
+    uint32_t busErrorEvery;
+    uint32_t busErrorCount;
+} SIM_I2C_OBJ;
+
+static SIM_I2C_OBJ i2c;
+
+uint64_t SIM_I2C_BitCycles(void)
+{
+    uint32_t brg = *SIM_SFR_Ptr(I2C1BRG_ADDR) & 0xFFFu;
+
+    return 2u * ((uint64_t)brg + 2u) * (SIM_CPU_CLOCK_HZ / SIM_PB_CLOCK_HZ);
+}
+
+static void SIM_I2C_OpStart(SIM_I2C_OP op, unsigned bits, uint64_t stretch)
+{
+    i2c.op = op;
+    i2c.doneAt = simCycles + bits * SIM_I2C_BitCycles() + stretch;
+    SIM_EventsReschedule();
+}
+
+static uint64_t SIM_I2C_Stretch(const SIM_I2C_SLAVE *slave)
+{
+    return (slave != NULL) ? slave->stretchCycles : 0u;
+}
+
+SIM_I2C_SLAVE *SIM_I2C_SlaveFind(uint8_t address)
+{
+    SIM_I2C_SLAVE *s;
+
+    for (s = i2c.slaves; s != NULL; s = s->next)
+    {
+        if (s->address == address)
+        {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+void SIM_I2C_SlaveAttach(SIM_I2C_SLAVE *slave)
+{
+    slave->next = i2c.slaves;
+    i2c.slaves = slave;
+}
+
+void SIM_I2C_BusErrorEverySet(uint32_t n)
+{
+    i2c.busErrorEvery = n;
+}
+
+bool SIM_I2C_BusErrorInject(void)
+{
+    if (i2c.busErrorEvery == 0u)
+    {
+        return false;
+    }
+    i2c.busErrorCount++;
+    if ((i2c.busErrorCount % i2c.busErrorEvery) != 0u)
+    {
+        return false;
+    }
+    i2c.busErrors++;
+    return true;
+}
+
+uint64_t SIM_I2C_BusCyclesGet(void)
+{
+    return i2c.busCycles;
+}
+
+void SIM_I2C_Account(uint32_t starts, uint32_t bytesTx, uint32_t bytesRx,
+                     uint32_t nacks, uint64_t busCycles)
+{
+    i2c.starts += starts;
+    i2c.stops += starts;
+    i2c.bytesTx += bytesTx;
+    i2c.bytesRx += bytesRx;
+    i2c.nacks += nacks;
+    i2c.busCycles += busCycles;
+}
+
+void SIM_I2C_Sync(void)
+{
+    volatile uint32_t *con = SIM_SFR_Ptr(I2C1CON_ADDR);
+    volatile uint32_t *stat = SIM_SFR_Ptr(I2C1STAT_ADDR);
+    volatile uint32_t *trn = SIM_SFR_Ptr(I2C1TRN_ADDR);
+
+    if ((*con & _I2C1CON_ON_MASK) == 0u)
+    {
+        *trn = SIM_I2C_TRN_EMPTY;
+        return;
+    }
+    if (i2c.op != SIM_I2C_OP_NONE)
+    {
+        if (*trn != SIM_I2C_TRN_EMPTY)
+        {
+            // write while the module is busy is dropped
+            *stat |= _I2C1STAT_IWCOL_MASK;
+            *trn = SIM_I2C_TRN_EMPTY;
+        }
+        return;
+    }
+    if (*trn != SIM_I2C_TRN_EMPTY)
+    {
+        i2c.txByte = (uint8_t)*trn;
+        *trn = SIM_I2C_TRN_EMPTY;
+        *stat |= _I2C1STAT_TBF_MASK | _I2C1STAT_TRSTAT_MASK;
+        SIM_I2C_OpStart(SIM_I2C_OP_TX, 9u, SIM_I2C_Stretch(i2c.addressPhase ?
+                        SIM_I2C_SlaveFind(i2c.txByte >> 1) : i2c.active));
+    }
+    else if ((*con & _I2C1CON_SEN_MASK) != 0u)
+    {
+        if (SIM_I2C_BusErrorInject())
+        {
+            // another master won arbitration, the START is not generated
+            *con &= ~_I2C1CON_SEN_MASK;
+            *stat |= _I2C1STAT_BCL_MASK;
+            *SIM_SFR_Ptr(IFS1_ADDR) |= _IFS1_I2C1BIF_MASK;
+            return;
+        }
+        i2c.starts++;
+        if (!i2c.busBusy)
+        {
+            i2c.busBusy = true;
+            i2c.busBusySince = simCycles;
+        }
+        SIM_I2C_OpStart(SIM_I2C_OP_START, 1u, 0u);
+    }
+    else if ((*con & _I2C1CON_RSEN_MASK) != 0u)
+    {
+        SIM_I2C_OpStart(SIM_I2C_OP_RESTART, 1u, 0u);
+    }
+    else if ((*con & _I2C1CON_PEN_MASK) != 0u)
+    {
+        SIM_I2C_OpStart(SIM_I2C_OP_STOP, 1u, 0u);
+    }
+    else if ((*con & _I2C1CON_RCEN_MASK) != 0u)
+    {
+        SIM_I2C_OpStart(SIM_I2C_OP_RX, 8u, SIM_I2C_Stretch(i2c.active));
+    }
+    else if ((*con & _I2C1CON_ACKEN_MASK) != 0u)
+    {
+        SIM_I2C_OpStart(SIM_I2C_OP_ACK, 1u, 0u);
+    }
+    else
+    {
+        // idle
+    }
+}
+
+void SIM_I2C_ReadHook(uint32_t address)
+{
+    (void)address;
+    *SIM_SFR_Ptr(I2C1STAT_ADDR) &= ~(_I2C1STAT_RBF_MASK);
+}
+
+uint64_t SIM_I2C_NextEvent(void)
+{
+    return (i2c.op == SIM_I2C_OP_NONE) ? SIM_TIME_NEVER : i2c.doneAt;
+}
+
+static bool SIM_I2C_Transmit(uint8_t data)
+{
+    bool ack;
+
+    i2c.bytesTx++;
+    if (i2c.addressPhase)
+    {
+        SIM_I2C_SLAVE *s = SIM_I2C_SlaveFind(data >> 1);
+        bool read = (data & 1u) != 0u;
+
+        i2c.addressPhase = false;
+        ack = (s != NULL) && s->start(s->context, read);
+        i2c.active = ack ? s : NULL;
+    }
+    else
+    {
+        ack = (i2c.active != NULL) && i2c.active->write(i2c.active->context, data);
+    }
+    if (!ack)
+    {
+        i2c.nacks++;
+    }
+    return ack;
+}
+
+void SIM_I2C_Event(void)
+{
+    volatile uint32_t *con = SIM_SFR_Ptr(I2C1CON_ADDR);
+    volatile uint32_t *stat = SIM_SFR_Ptr(I2C1STAT_ADDR);
+    SIM_I2C_OP op = i2c.op;
+
+    i2c.op = SIM_I2C_OP_NONE;
+    switch (op)
+    {
+        case SIM_I2C_OP_START:
+            *con &= ~_I2C1CON_SEN_MASK;
+            *stat = (*stat & ~_I2C1STAT_P_MASK) | _I2C1STAT_S_MASK;
+            i2c.addressPhase = true;
+            i2c.active = NULL;
+            break;
+        case SIM_I2C_OP_RESTART:
+            *con &= ~_I2C1CON_RSEN_MASK;
+            i2c.addressPhase = true;
+            break;
+        case SIM_I2C_OP_STOP:
+            *con &= ~_I2C1CON_PEN_MASK;
+            *stat = (*stat & ~_I2C1STAT_S_MASK) | _I2C1STAT_P_MASK;
+            if ((i2c.active != NULL) && (i2c.active->stop != NULL))
+            {
+                i2c.active->stop(i2c.active->context);
+            }
+            i2c.active = NULL;
+            i2c.stops++;
+            if (i2c.busBusy)
+            {
+                i2c.busBusy = false;
+                i2c.busCycles += simCycles - i2c.busBusySince;
+            }
+            break;
+        case SIM_I2C_OP_TX:
+            *stat &= ~(_I2C1STAT_TBF_MASK | _I2C1STAT_TRSTAT_MASK);
+            if (SIM_I2C_Transmit(i2c.txByte))
+            {
+                *stat &= ~_I2C1STAT_ACKSTAT_MASK;
+            }
+            else
+            {
+                *stat |= _I2C1STAT_ACKSTAT_MASK;
+            }
+            break;
+        case SIM_I2C_OP_RX:
+            *con &= ~_I2C1CON_RCEN_MASK;
+            if ((*stat & _I2C1STAT_RBF_MASK) != 0u)
+            {
+                *stat |= _I2C1STAT_I2COV_MASK;
+            }
+            *SIM_SFR_Ptr(I2C1RCV_ADDR) = (i2c.active != NULL) ?
+                i2c.active->read(i2c.active->context) : 0xFFu;
+            *stat |= _I2C1STAT_RBF_MASK;
+            i2c.bytesRx++;
+            break;
+        case SIM_I2C_OP_ACK:
+            *con &= ~_I2C1CON_ACKEN_MASK;
+            if ((i2c.active != NULL) && (i2c.active->ack != NULL))
+            {
+                i2c.active->ack(i2c.active->context, (*con & _I2C1CON_ACKDT_MASK) == 0u);
+            }
+            break;
+        default:
+            return;
+    }
+    *SIM_SFR_Ptr(IFS1_ADDR) |= _IFS1_I2C1MIF_MASK;
+    // a request queued in I2C1CON while we were busy starts now
+    SIM_I2C_Sync();
+    SIM_EventsReschedule();
+}
+
+void SIM_I2C_Reset(void)
+{
+    SIM_I2C_SLAVE *slaves = i2c.slaves;
+    uint32_t busErrorEvery = i2c.busErrorEvery;
+
+    i2c = (SIM_I2C_OBJ){ 0 };
+    i2c.slaves = slaves;
+    i2c.busErrorEvery = busErrorEvery;
+    *SIM_SFR_Ptr(I2C1TRN_ADDR) = SIM_I2C_TRN_EMPTY;
+}
+
+void SIM_I2C_Report(FILE *out)
+{
+    fprintf(out, "i2c1: %llu START, %llu STOP, %llu bytes tx, %llu bytes rx, "
+            "%llu NACK, %llu bus errors, bus busy %.1f us\n",
+            (unsigned long long)i2c.starts, (unsigned long long)i2c.stops,
+            (unsigned long long)i2c.bytesTx, (unsigned long long)i2c.bytesRx,
+            (unsigned long long)i2c.nacks, (unsigned long long)i2c.busErrors,
+            SIM_CYCLES_TO_US(i2c.busCycles));
+}
@@ -0,0 +1,268 @@
+/*******************************************************************************
+  PIC32MX host simulator - transaction level I2C1 PLIB
+
+  File Name:
+    sim_i2c_plib.c
+
+  Summary:
+    Stand-in for the I2C1 PLIB behind the DRV_I2C PLIB interface table.
+
+  Description:
+    With simI2cPlibModel == false, every call is passed to the real
+    I2C1 PLIB, which drives the register level model in sim_i2c.c.
+
+    With simI2cPlibModel == true, the whole transfer is played against the
+    attached slaves as soon as it is submitted. Completion is delayed by its
+    bus time: START, address, data and ACK bits, RESTART, STOP and clock
+    stretching. At that point a single simulated interrupt calls the driver
+    callback. Only the driver, SYS_TIME and the application then run as
+    instrumented code, which makes long load tests cheap.
+ *******************************************************************************/
+
+#include <string.h>
+#include "sim.h"
+#include "peripheral/i2c/master/plib_i2c1_master.h"
+
+#define SIM_I2C_PLIB_MAX_READ   64u
+// rough cost of the PLIB entry point that the model replaces
+
+#define SIM_I2C_PLIB_CYCLES_CALL    40u
+
+bool SIM_I2C_PLIB_Read(uint16_t address, uint8_t *rdata, size_t rlength);
+bool SIM_I2C_PLIB_Write(uint16_t address, uint8_t *wdata, size_t wlength);
+bool SIM_I2C_PLIB_WriteRead(uint16_t address, uint8_t *wdata, size_t wlength,
+                            uint8_t *rdata, size_t rlength);
+void SIM_I2C_PLIB_TransferAbort(void);
+I2C_ERROR SIM_I2C_PLIB_ErrorGet(void);
+bool SIM_I2C_PLIB_TransferSetup(I2C_TRANSFER_SETUP *setup, uint32_t srcClkFreq);
+void SIM_I2C_PLIB_CallbackRegister(I2C_CALLBACK callback, uintptr_t contextHandle);
+
+typedef struct
+{
+    bool busy;
+    bool done;
+    uint64_t doneAt;
+    I2C_ERROR error;
+    I2C_CALLBACK callback;
+    uintptr_t context;
+    uint8_t *readBuffer;
+    size_t readSize;
+    uint8_t readData[SIM_I2C_PLIB_MAX_READ];
+    uint32_t bitRate;
+} SIM_I2C_PLIB_OBJ;
+
+static SIM_I2C_PLIB_OBJ plib = { .bitRate = 0u };
+
+bool simI2cPlibModel;
+
+static uint64_t SIM_I2C_PLIB_BitCycles(void)
+{
+    if (plib.bitRate != 0u)
+    {
+        return SIM_CPU_CLOCK_HZ / plib.bitRate;
+    }
+    // I2C1BRG as left by I2C1_Initialize()
+    return SIM_I2C_BitCycles();
+}
+
+// Play one transfer against the slave, return the number of bus bits used
+static uint64_t SIM_I2C_PLIB_Play(uint16_t address, const uint8_t *wdata, size_t wlength,
+                                  size_t rlength, uint64_t *stretch)
+{
+    SIM_I2C_SLAVE *s = SIM_I2C_SlaveFind((uint8_t)address);
+    uint32_t bytesTx = 0;
+    uint32_t bytesRx = 0;
+    uint32_t nacks = 0;
+    uint64_t bits = 1u;                         // START
+    size_t i;
+
+    *stretch = 0;
+    plib.error = I2C_ERROR_NONE;
+    if (SIM_I2C_BusErrorInject())
+    {
+        plib.error = I2C_ERROR_BUS_COLLISION;
+        return bits;
+    }
+    if ((wlength != 0u) || (rlength == 0u))
+    {
+        bits += 9u;
+        bytesTx++;
+        if ((s == NULL) || !s->start(s->context, false))
+        {
+            nacks++;
+            plib.error = I2C_ERROR_NACK;
+        }
+        for (i = 0; (i < wlength) && (plib.error == I2C_ERROR_NONE); i++)
+        {
+            bits += 9u;
+            bytesTx++;
+            *stretch += s->stretchCycles;
+            if (!s->write(s->context, wdata[i]))
+            {
+                nacks++;
+                plib.error = I2C_ERROR_NACK;
+            }
+        }
+        if ((rlength != 0u) && (plib.error == I2C_ERROR_NONE))
+        {
+            bits += 1u;                         // RESTART
+        }
+    }
+    if ((rlength != 0u) && (plib.error == I2C_ERROR_NONE))
+    {
+        bits += 9u;
+        bytesTx++;
+        if ((s == NULL) || !s->start(s->context, true))
+        {
+            nacks++;
+            plib.error = I2C_ERROR_NACK;
+        }
+        for (i = 0; (i < rlength) && (plib.error == I2C_ERROR_NONE); i++)
+        {
+            bits += 9u;
+            bytesRx++;
+            *stretch += s->stretchCycles;
+            plib.readData[i] = s->read(s->context);
+            if (s->ack != NULL)
+            {
+                s->ack(s->context, (i + 1u) < rlength);
+            }
+        }
+    }
+    if ((s != NULL) && (s->stop != NULL))
+    {
+        s->stop(s->context);
+    }
+    bits += 1u;                                 // STOP
+    SIM_I2C_Account(1u, bytesTx, bytesRx, nacks, bits * SIM_I2C_PLIB_BitCycles() + *stretch);
+    return bits;
+}
+
+static bool SIM_I2C_PLIB_Submit(uint16_t address, uint8_t *wdata, size_t wlength,
+                                uint8_t *rdata, size_t rlength)
+{
+    uint64_t stretch;
+    uint64_t bits;
+
+    SIM_CyclesCharge(SIM_I2C_PLIB_CYCLES_CALL);
+    if (plib.busy || (rlength > SIM_I2C_PLIB_MAX_READ))
+    {
+        return false;
+    }
+    bits = SIM_I2C_PLIB_Play(address, wdata, wlength, rlength, &stretch);
+    plib.busy = true;
+    plib.done = false;
+    plib.readBuffer = rdata;
+    plib.readSize = (plib.error == I2C_ERROR_NONE) ? rlength : 0u;
+    plib.doneAt = simCycles + bits * SIM_I2C_PLIB_BitCycles() + stretch;
+    SIM_EventsReschedule();
+    return true;
+}
+
+bool SIM_I2C_PLIB_Read(uint16_t address, uint8_t *rdata, size_t rlength)
+{
+    if (!simI2cPlibModel)
+    {
+        return I2C1_Read(address, rdata, rlength);
+    }
+    return SIM_I2C_PLIB_Submit(address, NULL, 0, rdata, rlength);
+}
+
+bool SIM_I2C_PLIB_Write(uint16_t address, uint8_t *wdata, size_t wlength)
+{
+    if (!simI2cPlibModel)
+    {
+        return I2C1_Write(address, wdata, wlength);
+    }
+    return SIM_I2C_PLIB_Submit(address, wdata, wlength, NULL, 0);
+}
+
+bool SIM_I2C_PLIB_WriteRead(uint16_t address, uint8_t *wdata, size_t wlength,
+                            uint8_t *rdata, size_t rlength)
+{
+    if (!simI2cPlibModel)
+    {
+        return I2C1_WriteRead(address, wdata, wlength, rdata, rlength);
+    }
+    return SIM_I2C_PLIB_Submit(address, wdata, wlength, rdata, rlength);
+}
+
+void SIM_I2C_PLIB_TransferAbort(void)
+{
+    if (!simI2cPlibModel)
+    {
+        I2C1_TransferAbort();
+        return;
+    }
+    plib.busy = false;
+    plib.done = false;
+    plib.error = I2C_ERROR_NONE;
+    SIM_EventsReschedule();
+}
+
+I2C_ERROR SIM_I2C_PLIB_ErrorGet(void)
+{
+    I2C_ERROR error;
+
+    if (!simI2cPlibModel)
+    {
+        return I2C1_ErrorGet();
+    }
+    error = plib.error;
+    plib.error = I2C_ERROR_NONE;
+    return error;
+}
+
+bool SIM_I2C_PLIB_TransferSetup(I2C_TRANSFER_SETUP *setup, uint32_t srcClkFreq)
+{
+    if (!simI2cPlibModel)
+    {
+        return I2C1_TransferSetup(setup, srcClkFreq);
+    }
+    if ((setup == NULL) || (setup->clkSpeed == 0u) || (setup->clkSpeed > 1000000u))
+    {
+        return false;
+    }
+    plib.bitRate = setup->clkSpeed;
+    return true;
+}
+
+void SIM_I2C_PLIB_CallbackRegister(I2C_CALLBACK callback, uintptr_t contextHandle)
+{
+    // register with both so that -f can be chosen after SYS_Initialize()
+    I2C1_CallbackRegister(callback, contextHandle);
+    if (callback != NULL)
+    {
+        plib.callback = callback;
+        plib.context = contextHandle;
+    }
+}
+
+uint64_t SIM_I2C_PLIB_NextEvent(void)
+{
+    return (plib.busy && !plib.done) ? plib.doneAt : SIM_TIME_NEVER;
+}
+
+void SIM_I2C_PLIB_Event(void)
+{
+    plib.done = true;
+    if (plib.readBuffer != NULL)
+    {
+        memcpy(plib.readBuffer, plib.readData, plib.readSize);
+    }
+}
+
+bool SIM_I2C_PLIB_IrqPending(void)
+{
+    return plib.busy && plib.done;
+}
+
+void SIM_I2C_PLIB_InterruptHandler(void)
+{
+    plib.busy = false;
+    plib.done = false;
+    if (plib.callback != NULL)
+    {
+        plib.callback(plib.context);
+    }
+}
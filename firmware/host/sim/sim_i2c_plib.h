@@ -0,0 +1,25 @@
+/*******************************************************************************
+  PIC32MX host simulator - I2C1 PLIB redirection
+
+  File Name:
+    sim_i2c_plib.h
+
+  Summary:
+    Force-included (gcc -include) into initialization.c only, so that the
+    drvI2C0PLibAPI table points to sim_i2c_plib.c instead of the I2C1 PLIB.
+    Those functions forward to the real PLIB unless the transaction level
+    model was selected at run time (simulator option -f).
+ *******************************************************************************/
+
+#ifndef SIM_I2C_PLIB_H
+#define SIM_I2C_PLIB_H
+
+#define I2C1_Read               SIM_I2C_PLIB_Read
+#define I2C1_Write              SIM_I2C_PLIB_Write
+#define I2C1_WriteRead          SIM_I2C_PLIB_WriteRead
+#define I2C1_TransferAbort      SIM_I2C_PLIB_TransferAbort
+#define I2C1_ErrorGet           SIM_I2C_PLIB_ErrorGet
+#define I2C1_TransferSetup      SIM_I2C_PLIB_TransferSetup
+#define I2C1_CallbackRegister   SIM_I2C_PLIB_CallbackRegister
+
+#endif // SIM_I2C_PLIB_H
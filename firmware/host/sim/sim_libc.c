@@ -0,0 +1,74 @@
+/*******************************************************************************
+  PIC32MX host simulator - C library cost model
+
+  File Name:
+    sim_libc.c
+
+  Summary:
+    Charges target cycles for C library calls that run uninstrumented.
+
+  Description:
+    The firmware links against the host libc, which is not compiled with
+    the basic-block hook. Without a model these calls would look free. The
+    linker redirects them here with --wrap. Each one forwards to the real
+    implementation and then charges the estimated cost of the XC32 (newlib
+    derived) version on the M4K core. The constants are rough estimates.
+    Refine them when numbers measured on hardware are available.
+ *******************************************************************************/
+
+#include <stdarg.h>
+#include <stdint.h>
+#include "sim.h"
+
+#define SIM_PRINTF_CYCLES_CALL          420u
+#define SIM_PRINTF_CYCLES_PER_CHAR      22u
+#define SIM_PRINTF_CYCLES_PER_CONV      260u
+// word copy loop once both pointers are aligned, byte loop otherwise
+#define SIM_MEMCPY_CYCLES_CALL          24u
+#define SIM_MEMCPY_BYTES_PER_CYCLE      2u
+
+int __real_vsnprintf(char *str, size_t size, const char *format, va_list ap);
+int __wrap_vsnprintf(char *str, size_t size, const char *format, va_list ap);
+
+int __wrap_vsnprintf(char *str, size_t size, const char *format, va_list ap)
+{
+    int len = __real_vsnprintf(str, size, format, ap);
+    uint32_t conversions = 0;
+    const char *p;
+
+    for (p = format; *p != '\0'; p++)
+    {
+        if (*p == '%')
+        {
+            p++;
+            if (*p == '\0')
+            {
+                break;
+            }
+            if (*p != '%')
+            {
+                conversions++;
+            }
+        }
+    }
+    SIM_CyclesCharge(SIM_PRINTF_CYCLES_CALL
+                     + (uint32_t)((len > 0) ? len : 0) * SIM_PRINTF_CYCLES_PER_CHAR
+                     + conversions * SIM_PRINTF_CYCLES_PER_CONV);
+    return len;
+}
+
+void *__real_memcpy(void *dest, const void *src, size_t n);
+void *__wrap_memcpy(void *dest, const void *src, size_t n);
+
+void *__wrap_memcpy(void *dest, const void *src, size_t n)
+{
+    // calls from the peripheral models are not firmware time
+    if (!simInPoll)
+    {
+        uint32_t perCycle = ((((uintptr_t)dest | (uintptr_t)src) & 3u) == 0u) ?
+                            SIM_MEMCPY_BYTES_PER_CYCLE : 1u;
+
+        SIM_CyclesCharge(SIM_MEMCPY_CYCLES_CALL + (uint32_t)(n / perCycle));
+    }
+    return __real_memcpy(dest, src, n);
+}
@@ -0,0 +1,618 @@
+/*******************************************************************************
+  PIC32MX host simulator - entry point
+
+  File Name:
+    sim_main.c
+
+  Summary:
+    Replaces firmware main.c: runs SYS_Initialize()/SYS_Tasks() against the
+    simulated peripherals and prints cycle statistics at the end.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "sim.h"
+#include "definitions.h"
+#include "app.h"
+#include "i2c_latency.h"
+
+// TX ring of the console is 1024 bytes, at 115200 Bd that drains in ~90 ms
+#define SIM_DRAIN_US    100000u
+// latency histogram, bucket i counts samples with 2^(i-1) <= us < 2^i
+#define SIM_LATENCY_BUCKETS 24u
+
+extern APP_DATA appData;
+
+const char *simProgramName = "";
+
+// end-to-end latency of one sample: from the state machine leaving the
+// pause (start of scan) to appData.iter being incremented. Includes
+// busy and wake-up retries. Bus time is the I2C START..STOP time within.
+// Wake-up lag: start of scan minus end of the pause, the sampling jitter
+// that other SYS_Tasks() work (console shell, log) adds.
+typedef struct
+{
+    bool running;
+    bool pausing;
+    uint64_t wakeCycles;        // when the pause ends
+    uint64_t wakeCount;
+    uint64_t wakeSum;
+    uint64_t wakeMin;
+    uint64_t wakeMax;
+    uint64_t startCycles;
+    uint64_t startBusCycles;
+    uint64_t busSum;
+    uint64_t busMin;
+    uint64_t busMax;
+    uint32_t lastIter;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t histogram[SIM_LATENCY_BUCKETS];
+} SIM_LATENCY;
+
+static SIM_LATENCY latency =
+{
+    .min = SIM_TIME_NEVER, .busMin = SIM_TIME_NEVER, .wakeMin = SIM_TIME_NEVER
+};
+
+static void SIM_LatencyUpdate(void)
+{
+    if (!latency.pausing && (appData.state == APP_STATE_PAUSE_NEXT))
+    {
+        // seen after the SYS_Tasks() round that started the timer
+        latency.pausing = true;
+        latency.wakeCycles = simCycles + SIM_US_TO_CYCLES(appData.pauseUs);
+    }
+    if (!latency.running && (appData.state == APP_STATE_I2C_SCAN))
+    {
+        if (latency.pausing)
+        {
+            uint64_t lag = (simCycles > latency.wakeCycles) ? simCycles - latency.wakeCycles : 0u;
+
+            latency.pausing = false;
+            latency.wakeCount++;
+            latency.wakeSum += lag;
+            latency.wakeMin = (lag < latency.wakeMin) ? lag : latency.wakeMin;
+            latency.wakeMax = (lag > latency.wakeMax) ? lag : latency.wakeMax;
+        }
+        latency.running = true;
+        latency.startCycles = simCycles;
+        latency.startBusCycles = SIM_I2C_BusCyclesGet();
+    }
+    if (appData.iter != latency.lastIter)
+    {
+        latency.lastIter = appData.iter;
+        if (latency.running)
+        {
+            uint64_t cycles = simCycles - latency.startCycles;
+            uint64_t bus = SIM_I2C_BusCyclesGet() - latency.startBusCycles;
+            uint64_t us = (uint64_t)SIM_CYCLES_TO_US(cycles);
+            unsigned bucket = 0;
+
+            while ((us != 0u) && (bucket < SIM_LATENCY_BUCKETS - 1u))
+            {
+                us >>= 1;
+                bucket++;
+            }
+            latency.histogram[bucket]++;
+            latency.count++;
+            latency.sum += cycles;
+            latency.min = (cycles < latency.min) ? cycles : latency.min;
+            latency.max = (cycles > latency.max) ? cycles : latency.max;
+            latency.busSum += bus;
+            latency.busMin = (bus < latency.busMin) ? bus : latency.busMin;
+            latency.busMax = (bus > latency.busMax) ? bus : latency.busMax;
+            latency.running = false;
+        }
+    }
+}
+
+static void SIM_LatencyReport(FILE *out)
+{
+    unsigned i;
+
+    if (latency.count == 0u)
+    {
+        return;
+    }
+    fprintf(out, "latency: %llu samples, min %.1f us, avg %.1f us, max %.1f us\n",
+            (unsigned long long)latency.count, SIM_CYCLES_TO_US(latency.min),
+            SIM_CYCLES_TO_US(latency.sum / latency.count), SIM_CYCLES_TO_US(latency.max));
+    fprintf(out, "bus time: min %.1f us, avg %.1f us, max %.1f us per sample\n",
+            SIM_CYCLES_TO_US(latency.busMin), SIM_CYCLES_TO_US(latency.busSum / latency.count),
+            SIM_CYCLES_TO_US(latency.busMax));
+    if (latency.wakeCount != 0u)
+    {
+        fprintf(out, "wake-up lag: min %.1f us, avg %.1f us, max %.1f us after the pause\n",
+                SIM_CYCLES_TO_US(latency.wakeMin),
+                SIM_CYCLES_TO_US(latency.wakeSum / latency.wakeCount),
+                SIM_CYCLES_TO_US(latency.wakeMax));
+    }
+    for (i = 0; i < SIM_LATENCY_BUCKETS; i++)
+    {
+        if (latency.histogram[i] != 0u)
+        {
+            fprintf(out, "  < %8llu us %10llu\n", 1ull << i,
+                    (unsigned long long)latency.histogram[i]);
+        }
+    }
+}
+
+// deadlines of the samples (app_sched.h), SYS_TIME counts converted to us
+static void SIM_SchedReport(FILE *out)
+{
+    APP_SCHED_STATS sched;
+    unsigned i;
+
+    APP_SCHED_StatsGet(&sched);
+    if (sched.samples < 2u)
+    {
+        return;
+    }
+    fprintf(out, "schedule: %u samples, %u missed, period %.3f us (set %u us), "
+            "late avg %.1f us, max %u us\n", (unsigned)sched.samples, (unsigned)sched.missed,
+            SIM_CYCLES_TO_US((sched.lastStart - sched.firstStart) * SIM_CORE_TIMER_DIV) /
+            (sched.samples - 1u), (unsigned)APP_SamplePeriodGet(),
+            (double)sched.lateSumUs / sched.samples, (unsigned)sched.lateMaxUs);
+    fprintf(out, "schedule jitter: %d .. %d us over %u intervals\n", (int)sched.jitterMinUs,
+            (int)sched.jitterMaxUs, (unsigned)sched.intervals);
+    for (i = 0; i < APP_SCHED_BINS; i++)
+    {
+        if (sched.histogram[i] != 0u)
+        {
+            fprintf(out, "  %s %8u us %10u\n", (i + 1u < APP_SCHED_BINS) ? "< " : ">=",
+                    (unsigned)((i + 1u < APP_SCHED_BINS) ? APP_SCHED_BinUs(i + 1u) : APP_SCHED_BinUs(i)),
+                    (unsigned)sched.histogram[i]);
+        }
+    }
+}
+
+// stages of the firmware I2C latency instrumentation (I2C_LATENCY=1), core
+// timer ticks converted to us
+static void SIM_I2cLatencyReport(FILE *out)
+{
+    I2C_LAT_STAGE stage;
+    I2C_LAT_STATS stats;
+    unsigned i;
+
+    for (stage = 0; stage < I2C_LAT_STAGE_NUMBER; stage++)
+    {
+        if (!I2C_LAT_StatsGet(stage, &stats))
+        {
+            return;
+        }
+        if (stage == 0)
+        {
+            fprintf(out, "i2c latency       count     min us     avg us     max us\n");
+        }
+        if (stats.count == 0u)
+        {
+            fprintf(out, "  %-11s %9u\n", I2C_LAT_StageName(stage), 0u);
+            continue;
+        }
+        fprintf(out, "  %-11s %9u %10.2f %10.2f %10.2f\n", I2C_LAT_StageName(stage),
+                (unsigned)stats.count, SIM_CYCLES_TO_US((uint64_t)stats.min * SIM_CORE_TIMER_DIV),
+                SIM_CYCLES_TO_US(stats.sum * SIM_CORE_TIMER_DIV / stats.count),
+                SIM_CYCLES_TO_US((uint64_t)stats.max * SIM_CORE_TIMER_DIV));
+        for (i = 0; i < I2C_LAT_BUCKETS; i++)
+        {
+            if (stats.histogram[i] != 0u)
+            {
+                // the last bucket is open ended
+                fprintf(out, "    %s %10.2f us %9u\n", (i + 1u < I2C_LAT_BUCKETS) ? "< " : ">=",
+                        SIM_CYCLES_TO_US(((i + 1u < I2C_LAT_BUCKETS) ? 2ull << i : 1ull << i) *
+                                         SIM_CORE_TIMER_DIV),
+                        (unsigned)stats.histogram[i]);
+            }
+        }
+    }
+}
+
+static void SIM_Usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-n samples] [-t ms] [-q] [-P] [-f] [-a addr]... [-T wave]\n"
+            "          [-c ms] [-s] [-k n] [-b n] [-d us] [-r baud] [-B baud]\n"
+            "          [-S commands]\n"
+            "          [-W cycles[,d]] [-Q depth] [-F] [-U] [-R] [-X timers] [-Y reads]\n"
+            "  -n samples  stop after this many temperature samples (default 20)\n"
+            "  -t ms       stop after this much simulated time (default 600000)\n"
+            "  -q          do not echo UART2 output to stdout\n"
+            "  -P          do not print per function profile\n"
+            "  -f          transaction level I2C model instead of I2C1 registers\n"
+            "  -a addr     attach a TC74 at this address (repeatable, default 0x48)\n"
+            "  -T wave[,base[,amplitude[,periodMs]]]\n"
+            "              TC74 temperature: const, ramp, sine or walk (default const,25)\n"
+            "  -c ms       TC74 conversion time after power-up/wake-up (default 0)\n"
+            "  -s          TC74 powers up in standby\n"
+            "  -k n        TC74 NACKs every n-th address byte\n"
+            "  -b n        bus collision on every n-th START\n"
+            "  -d us       TC74 clock stretching per byte\n"
+            "  -r baud     host adapter rate (default: the rate of UART2)\n"
+            "  -B baud     host switches the console to this rate (app_baud.h), with\n"
+            "              APP_BAUD_AUTOBAUD it starts at this rate instead\n"
+            "  -S commands host sends these console shell commands, separated by ';',\n"
+            "              in turn every 20 ms\n"
+            "  -W cycles[,d]\n"
+            "              adds a 1 ms periodic SYS_TIME callback that takes this many\n"
+            "              cycles, in the core timer interrupt or with ,d deferred\n"
+            "  -Q depth    DRV_I2C queue benchmark up to this depth instead of the\n"
+            "              application (needs DRV_I2C_QUEUE_SIZE_IDX0 >= depth)\n"
+            "  -F          console formatter benchmark instead of the application\n"
+            "  -U          UART2 ring buffer benchmark instead of the application\n"
+            "  -R          UART2 rate benchmark instead of the application\n"
+            "  -X timers   SYS_TIME benchmark with this many periodic timers instead of\n"
+            "              the application (needs SYS_TIME_MAX_TIMERS >= timers)\n"
+            "  -Y reads    SYS_TIME timestamp check and benchmark, this many reads in\n"
+            "              the task, instead of the application\n", name);
+}
+
+static bool SIM_WaveParse(const char *arg, SIM_TC74_CONFIG *cfg)
+{
+    static const char *const names[] = { "const", "ramp", "sine", "walk" };
+    size_t len = strcspn(arg, ",");
+    char *end;
+    size_t i;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if ((strlen(names[i]) == len) && (strncmp(arg, names[i], len) == 0))
+        {
+            break;
+        }
+    }
+    if (i == sizeof(names) / sizeof(names[0]))
+    {
+        return false;
+    }
+    cfg->wave = (SIM_TC74_WAVE)i;
+    arg += len;
+    if (*arg == ',')
+    {
+        cfg->base = strtod(arg + 1, &end);
+        arg = end;
+    }
+    if (*arg == ',')
+    {
+        cfg->amplitude = strtod(arg + 1, &end);
+        arg = end;
+    }
+    if (*arg == ',')
+    {
+        cfg->periodMs = (uint32_t)strtoul(arg + 1, &end, 0);
+        arg = end;
+    }
+    return *arg == '\0';
+}
+
+// the callback of -W, stands for heavy work in a timer callback
+static void SIM_LoadCallback(uintptr_t cycles)
+{
+    SIM_CyclesCharge((uint32_t)cycles);
+}
+
+static void SIM_DeferredReport(FILE *out, const SYS_TIME_DEFERRED_STATS *deferred)
+{
+    if (deferred->queued == 0u)
+    {
+        return;
+    }
+    fprintf(out, "sys_time deferred: %u queued, %u run, %u dropped, depth max %u, "
+            "latency avg %.1f us, max %.1f us\n", (unsigned)deferred->queued,
+            (unsigned)deferred->run, (unsigned)deferred->dropped, (unsigned)deferred->maxDepth,
+            (deferred->run != 0u) ? SIM_CYCLES_TO_US(deferred->latencySum * SIM_CORE_TIMER_DIV) /
+            deferred->run : 0.0,
+            SIM_CYCLES_TO_US((uint64_t)deferred->latencyMax * SIM_CORE_TIMER_DIV));
+}
+
+static double SIM_HostSeconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    static char exePath[4096];
+    unsigned long samples = 20;
+    unsigned long limitMs = 600000;
+    bool profile = true;
+    uint32_t queueBench = 0;
+    bool formatBench = false;
+    bool uartBench = false;
+    bool rateBench = false;
+    uint32_t timeBench = 0;
+    uint32_t stampBench = 0;
+    uint32_t loadCycles = 0;
+    bool loadDeferred = false;
+    uint32_t hostSwitch = 0;
+    bool hostOk;
+    SIM_TC74_CONFIG tc74;
+    APP_LOG_STATS logStats;
+    APP_BAUD_STATS baudStats;
+    APP_SHELL_STATS shellStats;
+    UART2_TX_STATS txStats;
+    SYS_TIME_DEFERRED_STATS deferredStats;
+    uint8_t addresses[8];
+    size_t addressCount = 0;
+    size_t i;
+    uint64_t limitCycles;
+    uint64_t stopCycles;
+    uint64_t drainCycles;
+    uint64_t stopIter;
+    double hostStart;
+    double hostElapsed;
+    ssize_t n;
+    int opt;
+
+    SIM_TC74_ConfigDefault(&tc74);
+    while ((opt = getopt(argc, argv, "n:t:qPfa:T:c:sk:b:d:r:B:S:W:Q:FURX:Y:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                samples = strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                limitMs = strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                simQuiet = true;
+                break;
+            case 'P':
+                profile = false;
+                break;
+            case 'f':
+                simI2cPlibModel = true;
+                break;
+            case 'a':
+                if (addressCount == sizeof(addresses))
+                {
+                    fprintf(stderr, "sim: too many -a\n");
+                    return EXIT_FAILURE;
+                }
+                addresses[addressCount++] = (uint8_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'T':
+                if (!SIM_WaveParse(optarg, &tc74))
+                {
+                    fprintf(stderr, "sim: invalid waveform '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'c':
+                tc74.conversionMs = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                tc74.standby = true;
+                break;
+            case 'k':
+                tc74.nackEvery = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                SIM_I2C_BusErrorEverySet((uint32_t)strtoul(optarg, NULL, 0));
+                break;
+            case 'd':
+                tc74.stretchUs = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                SIM_UART_HostBaudSet((uint32_t)strtoul(optarg, NULL, 0));
+                break;
+            case 'B':
+                hostSwitch = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'S':
+                SIM_HOST_TypeSet(optarg);
+                break;
+            case 'W':
+            {
+                char *end;
+
+                loadCycles = (uint32_t)strtoul(optarg, &end, 0);
+                loadDeferred = (strcmp(end, ",d") == 0);
+                if ((*end != '\0') && !loadDeferred)
+                {
+                    fprintf(stderr, "sim: invalid -W '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+            case 'Q':
+                queueBench = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'F':
+                formatBench = true;
+                break;
+            case 'U':
+                uartBench = true;
+                break;
+            case 'R':
+                rateBench = true;
+                break;
+            case 'X':
+                timeBench = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'Y':
+                stampBench = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                SIM_Usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    n = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1u);
+    simProgramName = (n > 0) ? exePath : argv[0];
+
+    SIM_Reset();
+    if (addressCount == 0u)
+    {
+        addresses[addressCount++] = tc74.address;
+    }
+    for (i = 0; i < addressCount; i++)
+    {
+        tc74.address = addresses[i];
+        SIM_TC74_Attach(&tc74);
+    }
+    limitCycles = SIM_US_TO_CYCLES((uint64_t)limitMs * 1000u);
+
+    hostStart = SIM_HostSeconds();
+    SYS_Initialize(NULL);
+    if (queueBench != 0u)
+    {
+        return (SIM_BenchI2cQueue(stdout, addresses[0], queueBench) == 0) ?
+            EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (formatBench)
+    {
+        return (SIM_BenchConsoleFormat(stdout) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (uartBench)
+    {
+        return (SIM_BenchUartRing(stdout) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (rateBench)
+    {
+        return (SIM_BenchUartRate(stdout) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (timeBench != 0u)
+    {
+        return (SIM_BenchTimers(stdout, timeBench) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (stampBench != 0u)
+    {
+        return (SIM_BenchTimestamp(stdout, addresses[0], stampBench) == 0) ?
+            EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (hostSwitch != 0u)
+    {
+        SIM_HOST_BaudSwitchSet(hostSwitch);
+    }
+    if (loadCycles != 0u)
+    {
+        SYS_TIME_HANDLE load = loadDeferred ?
+            SYS_TIME_CallbackRegisterDeferredUS(SIM_LoadCallback, loadCycles, 1000u, SYS_TIME_PERIODIC) :
+            SYS_TIME_CallbackRegisterUS(SIM_LoadCallback, loadCycles, 1000u, SYS_TIME_PERIODIC);
+
+        if (load == SYS_TIME_HANDLE_INVALID)
+        {
+            fprintf(stderr, "sim: no SYS_TIME timer left for -W\n");
+            return EXIT_FAILURE;
+        }
+    }
+    while ((appData.iter < samples) && (appData.state != APP_STATE_FATAL_ERROR)
+           && (simCycles < limitCycles))
+    {
+        SYS_Tasks();
+        SIM_LatencyUpdate();
+        SIM_HOST_Poll();
+    }
+    hostElapsed = SIM_HostSeconds() - hostStart;
+    stopCycles = simCycles;
+    stopIter = appData.iter;
+    // the drain below does not run SYS_TIME_DeferredTasks()
+    SYS_TIME_DeferredStatsGet(&deferredStats);
+
+    // let the console flush what the last sample printed. Of SYS_Tasks only
+    // the deferred log keeps running until its backlog is in the UART2 TX
+    // ring, interrupts are still served. A rate switch still going on holds
+    // the log, it runs to its end.
+    while (APP_LOG_Pending() || !APP_BAUD_Ready())
+    {
+        APP_BAUD_Tasks();
+        APP_LOG_Tasks();
+        SIM_HOST_Poll();
+        SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+    }
+    drainCycles = simCycles;
+    while (simCycles < drainCycles + SIM_US_TO_CYCLES(SIM_DRAIN_US))
+    {
+        SIM_CyclesCharge(SIM_CYCLES_PER_BLOCK);
+    }
+    fflush(stdout);
+
+    fprintf(stderr, "\nsim: %llu samples in %.6f s simulated (%llu cycles",
+            (unsigned long long)stopIter, SIM_CYCLES_TO_US(stopCycles) / 1e6,
+            (unsigned long long)stopCycles);
+    if (stopIter != 0u)
+    {
+        fprintf(stderr, ", %llu cycles/sample", (unsigned long long)(stopCycles / stopIter));
+    }
+    fprintf(stderr, ")\nsim: host %.3f s, %.0f samples/s, %.2fx real time\n", hostElapsed,
+            (hostElapsed > 0.0) ? (double)stopIter / hostElapsed : 0.0,
+            (hostElapsed > 0.0) ? SIM_CYCLES_TO_US(stopCycles) / 1e6 / hostElapsed : 0.0);
+    fprintf(stderr, "sim: %llu SFR accesses, %llu cycles in interrupts (%.2f%%)\n",
+            (unsigned long long)SIM_SFR_AccessCountGet(), (unsigned long long)simIsrCycles,
+            (stopCycles != 0u) ? 100.0 * (double)simIsrCycles / (double)simCycles : 0.0);
+    SIM_I2C_Report(stderr);
+    if (appData.drvI2CClients != 0u)
+    {
+        fprintf(stderr, "drv_i2c: %u clients, %u bus speed changes\n",
+                (unsigned)appData.drvI2CClients,
+                (unsigned)DRV_I2C_TransferSetupCountGet(appData.drvI2CHandles[0]));
+    }
+    if (appData.batches != 0u)
+    {
+        fprintf(stderr, "drv_i2c: %u batches, %.2f items, bus %.1f us, gaps %.1f us per batch\n",
+                (unsigned)appData.batches, (double)appData.batchItemsDone / appData.batches,
+                SIM_CYCLES_TO_US(appData.batchBusTicks * SIM_CORE_TIMER_DIV) / appData.batches,
+                SIM_CYCLES_TO_US(appData.batchGapTicks * SIM_CORE_TIMER_DIV) / appData.batches);
+    }
+    APP_LOG_StatsGet(&logStats);
+    if (logStats.records != 0u)
+    {
+        fprintf(stderr, "app_log: %u records, %u dropped, ring max %u of %u, max lag %.1f us\n",
+                (unsigned)logStats.records, (unsigned)logStats.dropped,
+                (unsigned)logStats.maxUsed, (unsigned)APP_LOG_RING_SIZE,
+                SIM_CYCLES_TO_US((uint64_t)logStats.maxLag * SIM_CORE_TIMER_DIV));
+    }
+    SIM_UART_Report(stderr);
+    APP_BAUD_StatsGet(&baudStats);
+    if ((baudStats.switches + baudStats.failures + baudStats.autobauds) != 0u)
+    {
+        fprintf(stderr, "app_baud: %u switches, %u failed, %u auto-baud measurements, "
+                "console at %u Bd\n", (unsigned)baudStats.switches, (unsigned)baudStats.failures,
+                (unsigned)baudStats.autobauds, (unsigned)UART2_BaudRateGet());
+    }
+    APP_SHELL_StatsGet(&shellStats);
+    if (shellStats.lines != 0u)
+    {
+        fprintf(stderr, "app_shell: %u lines, %u unknown, %u too long, %u RX errors\n",
+                (unsigned)shellStats.lines, (unsigned)shellStats.unknown,
+                (unsigned)shellStats.overflows, (unsigned)shellStats.errors);
+    }
+    hostOk = SIM_HOST_Report(stderr);
+    SIM_DMA_Report(stderr);
+    UART2_TxStatsGet(&txStats);
+    if (txStats.bytes != 0u)
+    {
+        // the handler ticks leave out interrupt entry/exit, the vector cycles
+        // include them (and the RX/error handlers). With UART2_TX_DMA the
+        // entries are DMA block interrupts.
+        fprintf(stderr, "uart2 tx isr: %u entries, %.1f per KB, %.1f handler cycles per byte, "
+                "%.1f vector cycles per byte\n", (unsigned)txStats.interrupts,
+                1024.0 * txStats.interrupts / txStats.bytes,
+                (double)txStats.ticks * SIM_CORE_TIMER_DIV / txStats.bytes,
+                (double)(SIM_IrqCyclesGet(_UART_2_VECTOR) + SIM_IrqCyclesGet(_DMA_0_VECTOR)) /
+                txStats.bytes);
+    }
+    SIM_TC74_Report(stderr);
+    SIM_LatencyReport(stderr);
+    SIM_SchedReport(stderr);
+    SIM_DeferredReport(stderr, &deferredStats);
+    SIM_I2cLatencyReport(stderr);
+    fputc('\n', stderr);
+    SIM_IrqReport(stderr);
+    if (profile)
+    {
+        fputc('\n', stderr);
+        SIM_ProfileReport(stderr);
+    }
+    return ((appData.state == APP_STATE_FATAL_ERROR) || !hostOk) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
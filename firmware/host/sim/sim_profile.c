@@ -0,0 +1,247 @@
+/*******************************************************************************
+  PIC32MX host simulator - function profiler
+
+  File Name:
+    sim_profile.c
+
+  Summary:
+    Per function cycle accounting driven by -finstrument-functions.
+
+  Description:
+    Each firmware function entry and exit pushes or pops a shadow stack
+    frame. On exit the frame's inclusive cycle count is added to that
+    function's entry. Time spent in interrupt handlers that preempted the
+    function is subtracted, so what remains is what the function cost its
+    caller. Names come from the "<binary>.sym" file, which the Makefile
+    generates with nm. That way static functions show up too.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define SIM_PROFILE_DEPTH   256u
+#define SIM_PROFILE_SLOTS   2048u   // power of two
+
+typedef struct
+{
+    uintptr_t fn;
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t minCycles;
+    uint64_t maxCycles;
+} SIM_PROFILE_ENTRY;
+
+typedef struct
+{
+    uintptr_t fn;
+    uint64_t start;
+    uint64_t isrStart;
+    bool isr;
+} SIM_PROFILE_FRAME;
+
+typedef struct
+{
+    uintptr_t address;
+    char *name;
+} SIM_SYMBOL;
+
+static SIM_PROFILE_ENTRY entries[SIM_PROFILE_SLOTS];
+static SIM_PROFILE_FRAME stack[SIM_PROFILE_DEPTH];
+static unsigned depth;
+static SIM_SYMBOL *symbols;
+static size_t symbolCount;
+
+void __cyg_profile_func_enter(void *fn, void *site) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *fn, void *site) __attribute__((no_instrument_function));
+
+static SIM_PROFILE_ENTRY *SIM_ProfileEntry(uintptr_t fn)
+{
+    size_t i = (fn >> 4) & (SIM_PROFILE_SLOTS - 1u);
+
+    while ((entries[i].fn != 0u) && (entries[i].fn != fn))
+    {
+        i = (i + 1u) & (SIM_PROFILE_SLOTS - 1u);
+    }
+    entries[i].fn = fn;
+    return &entries[i];
+}
+
+void __cyg_profile_func_enter(void *fn, void *site)
+{
+    (void)site;
+    if (depth < SIM_PROFILE_DEPTH)
+    {
+        SIM_PROFILE_FRAME *f = &stack[depth];
+
+        f->fn = (uintptr_t)fn;
+        f->start = simCycles;
+        f->isrStart = simIsrCycles;
+        f->isr = simInIsr;
+    }
+    depth++;
+}
+
+void __cyg_profile_func_exit(void *fn, void *site)
+{
+    (void)fn;
+    (void)site;
+    depth--;
+    if (depth < SIM_PROFILE_DEPTH)
+    {
+        SIM_PROFILE_FRAME *f = &stack[depth];
+        SIM_PROFILE_ENTRY *e = SIM_ProfileEntry(f->fn);
+        uint64_t cycles = simCycles - f->start;
+
+        if (!f->isr)
+        {
+            cycles -= simIsrCycles - f->isrStart;
+        }
+        if ((e->calls == 0u) || (cycles < e->minCycles))
+        {
+            e->minCycles = cycles;
+        }
+        if (cycles > e->maxCycles)
+        {
+            e->maxCycles = cycles;
+        }
+        e->calls++;
+        e->cycles += cycles;
+    }
+}
+
+static int SIM_SymbolCompare(const void *a, const void *b)
+{
+    uintptr_t x = ((const SIM_SYMBOL *)a)->address;
+    uintptr_t y = ((const SIM_SYMBOL *)b)->address;
+
+    return (x > y) - (x < y);
+}
+
+static void SIM_SymbolsLoad(void)
+{
+    char path[4096];
+    char line[512];
+    size_t capacity = 0;
+    FILE *f;
+
+    if (symbols != NULL)
+    {
+        return;
+    }
+    snprintf(path, sizeof(path), "%s.sym", simProgramName);
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        return;
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        unsigned long long address;
+        char type;
+        char name[256];
+
+        if ((sscanf(line, "%llx %c %255s", &address, &type, name) != 3)
+            || ((type != 't') && (type != 'T')))
+        {
+            continue;
+        }
+        if (symbolCount == capacity)
+        {
+            capacity = (capacity == 0u) ? 256u : capacity * 2u;
+            symbols = realloc(symbols, capacity * sizeof(*symbols));
+        }
+        symbols[symbolCount].address = (uintptr_t)address;
+        symbols[symbolCount].name = strdup(name);
+        symbolCount++;
+    }
+    fclose(f);
+    qsort(symbols, symbolCount, sizeof(*symbols), SIM_SymbolCompare);
+}
+
+static const char *SIM_SymbolName(uintptr_t address)
+{
+    SIM_SYMBOL key = { address, NULL };
+    SIM_SYMBOL *s = bsearch(&key, symbols, symbolCount, sizeof(*symbols), SIM_SymbolCompare);
+
+    return (s != NULL) ? s->name : NULL;
+}
+
+static int SIM_EntryCompare(const void *a, const void *b)
+{
+    const SIM_PROFILE_ENTRY *x = a;
+    const SIM_PROFILE_ENTRY *y = b;
+
+    return (y->cycles > x->cycles) - (y->cycles < x->cycles);
+}
+
+void SIM_ProfileReset(void)
+{
+    memset(entries, 0, sizeof(entries));
+}
+
+void SIM_ProfileReport(FILE *out)
+{
+    // one row per name: static inline helpers have a copy in every TU
+    static SIM_PROFILE_ENTRY rows[SIM_PROFILE_SLOTS];
+    static const char *names[SIM_PROFILE_SLOTS];
+    static char unnamed[SIM_PROFILE_SLOTS][24];
+    size_t n = 0;
+    size_t i;
+    size_t j;
+
+    SIM_SymbolsLoad();
+    for (i = 0; i < SIM_PROFILE_SLOTS; i++)
+    {
+        const SIM_PROFILE_ENTRY *e = &entries[i];
+        const char *name;
+
+        if (e->calls == 0u)
+        {
+            continue;
+        }
+        name = SIM_SymbolName(e->fn);
+        if (name == NULL)
+        {
+            snprintf(unnamed[i], sizeof(unnamed[i]), "%#lx", (unsigned long)e->fn);
+            name = unnamed[i];
+        }
+        for (j = 0; j < n; j++)
+        {
+            if (strcmp(names[rows[j].fn], name) == 0)
+            {
+                break;
+            }
+        }
+        if (j == n)
+        {
+            rows[n] = *e;
+            rows[n].fn = n;
+            names[n] = name;
+            n++;
+            continue;
+        }
+        rows[j].calls += e->calls;
+        rows[j].cycles += e->cycles;
+        if (e->minCycles < rows[j].minCycles)
+        {
+            rows[j].minCycles = e->minCycles;
+        }
+        if (e->maxCycles > rows[j].maxCycles)
+        {
+            rows[j].maxCycles = e->maxCycles;
+        }
+    }
+    qsort(rows, n, sizeof(rows[0]), SIM_EntryCompare);
+    fprintf(out, "%-40s %10s %14s %10s %10s %10s\n",
+            "function (inclusive cycles)", "calls", "total", "avg", "min", "max");
+    for (i = 0; i < n; i++)
+    {
+        const SIM_PROFILE_ENTRY *e = &rows[i];
+
+        fprintf(out, "%-40s %10llu %14llu %10llu %10llu %10llu\n", names[e->fn],
+                (unsigned long long)e->calls, (unsigned long long)e->cycles,
+                (unsigned long long)(e->cycles / e->calls),
+                (unsigned long long)e->minCycles, (unsigned long long)e->maxCycles);
+    }
+}
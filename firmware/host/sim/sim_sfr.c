@@ -0,0 +1,144 @@
+/*******************************************************************************
+  PIC32MX host simulator - SFR space
+
+  File Name:
+    sim_sfr.c
+
+  Summary:
+    Backing store for the memory mapped peripheral registers.
+
+  Description:
+    The firmware gets a plain pointer into regs[] and reads or writes it
+    directly. Side effects are applied lazily. Any access marks the space
+    dirty. The next SIM_SFR_Sync(), which runs no later than the next basic
+    block, folds the CLR/SET/INV aliases into their base registers and then
+    lets the peripheral models react to what changed. Registers with read
+    side effects (I2C1RCV, U2RXREG) are serviced when they are accessed.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "xc.h"
+
+#define SIM_SFR_WORDS   ((SIM_SFR_END - SIM_SFR_BASE) / 4u)
+// upper bound of distinct registers (0x10 aligned) touched by the firmware
+#define SIM_SFR_MAX_ACTIVE 128u
+
+static uint32_t regs[SIM_SFR_WORDS];
+static uint8_t activeMap[SIM_SFR_WORDS / 4u];
+static uint32_t activeRegs[SIM_SFR_MAX_ACTIVE];
+static size_t activeCount;
+static uint64_t accessCount;
+
+bool simSfrDirty;
+
+static void SIM_SFR_Activate(uint32_t address)
+{
+    uint32_t idx = (address - SIM_SFR_BASE) >> 4;
+
+    if (activeMap[idx] == 0u)
+    {
+        if (activeCount == SIM_SFR_MAX_ACTIVE)
+        {
+            fprintf(stderr, "sim: too many active SFRs (0x%08X)\n", address);
+            return;
+        }
+        activeMap[idx] = 1u;
+        activeRegs[activeCount++] = address & ~0xFu;
+    }
+}
+
+volatile uint32_t *SIM_SFR_Ptr(uint32_t address)
+{
+    return &regs[(address - SIM_SFR_BASE) / 4u];
+}
+
+uint32_t SIM_SFR_AddressOf(const volatile void *p)
+{
+    uintptr_t offset = (uintptr_t)p - (uintptr_t)regs;
+
+    return (offset < sizeof(regs)) ? SIM_SFR_BASE + (uint32_t)offset : 0u;
+}
+
+volatile uint32_t *SIM_SFR_Access(uint32_t address)
+{
+    if ((address < SIM_SFR_BASE) || (address >= SIM_SFR_END))
+    {
+        fprintf(stderr, "sim: SFR access outside of peripheral space 0x%08X\n", address);
+        abort();
+    }
+    accessCount++;
+    simCycles += SIM_CYCLES_PER_SFR;
+    SIM_SFR_Activate(address);
+    // apply previous writes (and deliver interrupts) before this access
+    SIM_Poll();
+    switch (address)
+    {
+        case I2C1RCV_ADDR:
+            SIM_I2C_ReadHook(address);
+            break;
+        case U2RXREG_ADDR:
+            SIM_UART_ReadHook(address);
+            break;
+        default:
+            break;
+    }
+    simSfrDirty = true;
+    return SIM_SFR_Ptr(address);
+}
+
+void SIM_SFR_Sync(void)
+{
+    size_t i;
+
+    simSfrDirty = false;
+    for (i = 0; i < activeCount; i++)
+    {
+        uint32_t *reg = &regs[(activeRegs[i] - SIM_SFR_BASE) / 4u];
+        uint32_t clr = reg[1], set = reg[2], inv = reg[3];
+
+        if ((clr | set | inv) != 0u)
+        {
+            reg[0] = ((reg[0] & ~clr) | set) ^ inv;
+            reg[1] = 0u;
+            reg[2] = 0u;
+            reg[3] = 0u;
+        }
+    }
+    SIM_I2C_Sync();
+    SIM_UART_Sync();
+    SIM_DMA_Sync();
+}
+
+void SIM_SFR_Reset(void)
+{
+    static const uint32_t knownRegs[] = {
+        I2C1CON_ADDR, I2C1STAT_ADDR, U2MODE_ADDR, U2STA_ADDR,
+        INTCON_ADDR, IFS0_ADDR, IFS1_ADDR, IEC0_ADDR, IEC1_ADDR,
+        IPC0_ADDR, IPC8_ADDR, IPC9_ADDR, IPC10_ADDR,
+        ANSELA_ADDR, TRISA_ADDR, LATA_ADDR, CNPUB_ADDR,
+    };
+    size_t i;
+
+    memset(regs, 0, sizeof(regs));
+    memset(activeMap, 0, sizeof(activeMap));
+    activeCount = 0;
+    accessCount = 0;
+    simSfrDirty = false;
+    // registers reachable only through pointer arithmetic (EVIC, GPIO)
+    for (i = 0; i < sizeof(knownRegs) / sizeof(knownRegs[0]); i++)
+    {
+        SIM_SFR_Activate(knownRegs[i]);
+    }
+    // POR values the firmware depends on
+    regs[(OSCCON_ADDR - SIM_SFR_BASE) / 4u] = 0x00000020u;   // SLOCK: PLL locked
+    regs[(TRISA_ADDR - SIM_SFR_BASE) / 4u] = 0x0000001Fu;
+    regs[(TRISB_ADDR - SIM_SFR_BASE) / 4u] = 0x0000FFFFu;
+    regs[(BMXCON_ADDR - SIM_SFR_BASE) / 4u] = 0x00000041u;
+}
+
+uint64_t SIM_SFR_AccessCountGet(void)
+{
+    return accessCount;
+}
@@ -0,0 +1,248 @@
+/*******************************************************************************
+  PIC32MX host simulator - TC74 temperature sensor
+
+  File Name:
+    sim_tc74.c
+
+  Summary:
+    Behavioural model of a Microchip TC74 on the simulated I2C bus.
+
+  Description:
+    Like the real part, the TC74 has a register pointer that the first
+    written byte selects. Reads return the selected register: TEMP (0) or
+    CONFIG (1). A second written byte goes to CONFIG, where only SHDN (bit 7)
+    is writable.
+
+    Behaviour that matters to the firmware state machine:
+    - after power-up and after leaving standby, DATA_RDY stays 0 until the
+      first conversion is done (conversionMs)
+    - in standby, DATA_RDY reads 0 and TEMP keeps the last converted value
+    - TEMP is updated at the TC74 rate of 8 conversions per second, from
+      the configured waveform
+    - every n-th address phase can be NACKed (nackEvery) to exercise
+      driver and application error paths
+ *******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "sim.h"
+
+#define SIM_TC74_REG_TEMP       0u
+#define SIM_TC74_REG_CONFIG     1u
+#define SIM_TC74_CONFIG_SHDN    0x80u
+#define SIM_TC74_CONFIG_READY   0x40u
+#define SIM_TC74_MAX_DEVICES    8u
+// TC74 converts continuously at 8 samples/s
+#define SIM_TC74_CONVERSION_US  125000u
+
+typedef struct
+{
+    SIM_I2C_SLAVE slave;
+    SIM_TC74_CONFIG cfg;
+    uint8_t pointer;
+    bool standby;
+    unsigned writeIndex;
+    uint64_t readyAt;           // DATA_RDY becomes 1
+    uint64_t frozenAt;          // TEMP sampling time while in standby
+    uint32_t addressCount;
+    uint32_t walkState;
+    int8_t walkValue;
+    uint64_t walkAt;
+    // statistics
+    uint32_t nacks;
+    uint32_t wakeups;
+    uint32_t tempReads;
+    uint32_t configReads;
+} SIM_TC74;
+
+static SIM_TC74 tc74[SIM_TC74_MAX_DEVICES];
+static size_t tc74Count;
+
+static int8_t SIM_TC74_Clamp(double t)
+{
+    long v = lround(t);
+
+    // TC74 range is -65..+127 Celsius, two's complement
+    if (v < -65)
+    {
+        v = -65;
+    }
+    if (v > 127)
+    {
+        v = 127;
+    }
+    return (int8_t)v;
+}
+
+// temperature of the conversion that finished last before cycle "at"
+static int8_t SIM_TC74_Temperature(SIM_TC74 *dev, uint64_t at)
+{
+    const SIM_TC74_CONFIG *c = &dev->cfg;
+    uint64_t conv = SIM_US_TO_CYCLES(SIM_TC74_CONVERSION_US);
+    uint64_t t = (at / conv) * conv;
+    double ms = SIM_CYCLES_TO_US(t) / 1000.0;
+    double period = (c->periodMs != 0u) ? (double)c->periodMs : 1.0;
+    double phase = fmod(ms, period) / period;
+
+    switch (c->wave)
+    {
+        case SIM_TC74_WAVE_RAMP:
+            return SIM_TC74_Clamp(c->base + c->amplitude * phase);
+        case SIM_TC74_WAVE_SINE:
+            return SIM_TC74_Clamp(c->base + c->amplitude * sin(2.0 * M_PI * phase));
+        case SIM_TC74_WAVE_WALK:
+            // one +-1 step per conversion, kept within base +- amplitude
+            while (dev->walkAt < t)
+            {
+                dev->walkState ^= dev->walkState << 13;
+                dev->walkState ^= dev->walkState >> 17;
+                dev->walkState ^= dev->walkState << 5;
+                dev->walkValue += ((dev->walkState & 1u) != 0u) ? 1 : -1;
+                if (dev->walkValue > SIM_TC74_Clamp(c->base + c->amplitude))
+                {
+                    dev->walkValue -= 2;
+                }
+                if (dev->walkValue < SIM_TC74_Clamp(c->base - c->amplitude))
+                {
+                    dev->walkValue += 2;
+                }
+                dev->walkAt += conv;
+            }
+            return dev->walkValue;
+        default:
+            return SIM_TC74_Clamp(c->base);
+    }
+}
+
+static uint8_t SIM_TC74_Config(const SIM_TC74 *dev)
+{
+    if (dev->standby)
+    {
+        return SIM_TC74_CONFIG_SHDN;
+    }
+    return (simCycles >= dev->readyAt) ? SIM_TC74_CONFIG_READY : 0u;
+}
+
+static void SIM_TC74_StandbySet(SIM_TC74 *dev, bool standby)
+{
+    if (standby && !dev->standby)
+    {
+        dev->frozenAt = simCycles;
+    }
+    else if (!standby && dev->standby)
+    {
+        dev->wakeups++;
+        dev->readyAt = simCycles + SIM_US_TO_CYCLES((uint64_t)dev->cfg.conversionMs * 1000u);
+    }
+    else
+    {
+        // no change
+    }
+    dev->standby = standby;
+}
+
+static bool SIM_TC74_Start(void *context, bool read)
+{
+    SIM_TC74 *dev = context;
+
+    (void)read;
+    dev->writeIndex = 0;
+    dev->addressCount++;
+    if ((dev->cfg.nackEvery != 0u) && ((dev->addressCount % dev->cfg.nackEvery) == 0u))
+    {
+        dev->nacks++;
+        return false;
+    }
+    return true;
+}
+
+static bool SIM_TC74_Write(void *context, uint8_t data)
+{
+    SIM_TC74 *dev = context;
+
+    if (dev->writeIndex == 0u)
+    {
+        dev->pointer = data;
+    }
+    else if (dev->pointer == SIM_TC74_REG_CONFIG)
+    {
+        SIM_TC74_StandbySet(dev, (data & SIM_TC74_CONFIG_SHDN) != 0u);
+    }
+    else
+    {
+        // TEMP is read-only, the byte is ignored
+    }
+    dev->writeIndex++;
+    return dev->pointer <= SIM_TC74_REG_CONFIG;
+}
+
+static uint8_t SIM_TC74_Read(void *context)
+{
+    SIM_TC74 *dev = context;
+
+    if (dev->pointer == SIM_TC74_REG_TEMP)
+    {
+        uint64_t at = dev->standby ? dev->frozenAt : simCycles;
+
+        dev->tempReads++;
+        if (!dev->standby && (simCycles < dev->readyAt))
+        {
+            // no conversion finished yet since power-up/wake-up
+            return 0u;
+        }
+        return (uint8_t)SIM_TC74_Temperature(dev, at);
+    }
+    dev->configReads++;
+    return SIM_TC74_Config(dev);
+}
+
+void SIM_TC74_ConfigDefault(SIM_TC74_CONFIG *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->address = 0x48;
+    cfg->wave = SIM_TC74_WAVE_CONST;
+    cfg->base = 25.0;
+    cfg->amplitude = 10.0;
+    cfg->periodMs = 10000;
+}
+
+void SIM_TC74_Attach(const SIM_TC74_CONFIG *cfg)
+{
+    SIM_TC74 *dev;
+
+    if (tc74Count == SIM_TC74_MAX_DEVICES)
+    {
+        fprintf(stderr, "sim: at most %u TC74 devices\n", SIM_TC74_MAX_DEVICES);
+        return;
+    }
+    dev = &tc74[tc74Count++];
+    memset(dev, 0, sizeof(*dev));
+    dev->cfg = *cfg;
+    dev->slave.address = cfg->address;
+    dev->slave.context = dev;
+    dev->slave.stretchCycles = SIM_US_TO_CYCLES(cfg->stretchUs);
+    dev->slave.start = SIM_TC74_Start;
+    dev->slave.write = SIM_TC74_Write;
+    dev->slave.read = SIM_TC74_Read;
+    dev->standby = cfg->standby;
+    dev->frozenAt = simCycles;
+    dev->readyAt = simCycles + SIM_US_TO_CYCLES((uint64_t)cfg->conversionMs * 1000u);
+    dev->walkState = 0x2545F491u ^ cfg->address;
+    dev->walkValue = SIM_TC74_Clamp(cfg->base);
+    SIM_I2C_SlaveAttach(&dev->slave);
+}
+
+void SIM_TC74_Report(FILE *out)
+{
+    size_t i;
+
+    for (i = 0; i < tc74Count; i++)
+    {
+        const SIM_TC74 *dev = &tc74[i];
+
+        fprintf(out, "tc74 0x%02X: %u CONFIG reads, %u TEMP reads, %u wake-ups, "
+                "%u injected NACKs%s\n", dev->cfg.address, dev->configReads,
+                dev->tempReads, dev->wakeups, dev->nacks,
+                dev->standby ? ", in standby" : "");
+    }
+}
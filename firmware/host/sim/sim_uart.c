@@ -0,0 +1,425 @@
+/*******************************************************************************
+  PIC32MX host simulator - UART2
+
+  File Name:
+    sim_uart.c
+
+  Summary:
+    Model of UART2 with 8 level TX/RX FIFOs and character timing.
+
+  Description:
+    A character written to U2TXREG enters the TX FIFO. From there it moves
+    to the shift register, and it appears on the host stdout once all of its
+    frame bits have been sent. The model asserts U2TXIF for as long as the
+    condition selected by UTXISEL holds, and U2RXIF while the RX FIFO holds
+    data, matching the level-sensitive behaviour the PLIB ISR expects.
+    Characters injected with SIM_UART_RxInject() arrive at line rate.
+
+    The host adapter runs at the rate UART2 is set to, or at a fixed rate
+    (SIM_UART_HostBaudSet()). With a fixed rate each character is sampled the
+    way a receiver does it, in the middle of its own bit times. When the
+    stop bit is not where the receiver expects it the character is lost: the
+    host counts an error, or UART2 receives it with FERR set. With
+    U2MODE.ABAUD set the next received character is measured instead, U2BRG
+    is set from its bit time.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "xc.h"
+
+#define SIM_UART_FIFO_DEPTH     8u
+#define SIM_UART_TXREG_EMPTY    0xFFFFFFFFu
+// RX FIFO entry received with a framing error
+#define SIM_UART_RX_FERR        0x8000u
+
+typedef struct
+{
+    uint16_t data[SIM_UART_FIFO_DEPTH];
+    unsigned head;
+    unsigned count;
+} SIM_UART_FIFO;
+
+typedef struct
+{
+    SIM_UART_FIFO txFifo;
+    SIM_UART_FIFO rxFifo;
+    bool shiftBusy;
+    uint16_t shiftData;
+    uint64_t txDoneAt;
+    // bytes waiting "on the wire" to be received
+    uint8_t *rxPending;
+    size_t rxPendingSize;
+    size_t rxPendingPos;
+    uint64_t rxNextAt;
+    // level of the TX interrupt request (IFS1.U2TXIF is sticky)
+    bool txRequest;
+    // host adapter rate, 0 = follows UART2
+    uint32_t hostBaud;
+    // statistics
+    uint64_t bytesTx;
+    uint64_t bytesRx;
+    uint64_t overruns;
+    uint64_t hostErrors;
+    uint64_t framingErrors;
+    uint64_t autobauds;
+    uint64_t lineBusyCycles;
+} SIM_UART_OBJ;
+
+static SIM_UART_OBJ uart;
+
+bool simQuiet;
+
+static bool SIM_UART_FifoPush(SIM_UART_FIFO *f, uint16_t data)
+{
+    if (f->count == SIM_UART_FIFO_DEPTH)
+    {
+        return false;
+    }
+    f->data[(f->head + f->count) % SIM_UART_FIFO_DEPTH] = data;
+    f->count++;
+    return true;
+}
+
+static uint16_t SIM_UART_FifoPop(SIM_UART_FIFO *f)
+{
+    uint16_t data = f->data[f->head];
+
+    f->head = (f->head + 1u) % SIM_UART_FIFO_DEPTH;
+    f->count--;
+    return data;
+}
+
+static bool SIM_UART_On(void)
+{
+    return (*SIM_SFR_Ptr(U2MODE_ADDR) & _U2MODE_ON_MASK) != 0u;
+}
+
+// bit time of UART2 in CPU cycles
+static uint64_t SIM_UART_BitCycles(void)
+{
+    uint32_t mode = *SIM_SFR_Ptr(U2MODE_ADDR);
+    uint32_t brg = *SIM_SFR_Ptr(U2BRG_ADDR) & 0xFFFFu;
+
+    return (((mode & _U2MODE_BRGH_MASK) != 0u) ? 4u : 16u) * ((uint64_t)brg + 1u)
+        * (SIM_CPU_CLOCK_HZ / SIM_PB_CLOCK_HZ);
+}
+
+static double SIM_UART_HostBitCycles(void)
+{
+    if (uart.hostBaud == 0u)
+    {
+        return (double)SIM_UART_BitCycles();
+    }
+    return (double)SIM_CPU_CLOCK_HZ / uart.hostBaud;
+}
+
+static unsigned SIM_UART_FrameBits(void)
+{
+    uint32_t mode = *SIM_SFR_Ptr(U2MODE_ADDR);
+    // start + 8/9 data (+ parity) + 1/2 stop
+    unsigned bits = 10u;
+
+    if ((mode & _U2MODE_PDSEL_MASK) != 0u)
+    {
+        bits++;
+    }
+    if ((mode & _U2MODE_STSEL_MASK) != 0u)
+    {
+        bits++;
+    }
+    return bits;
+}
+
+static uint64_t SIM_UART_CharCycles(void)
+{
+    return SIM_UART_FrameBits() * SIM_UART_BitCycles();
+}
+
+static uint64_t SIM_UART_HostCharCycles(void)
+{
+    return (uint64_t)(SIM_UART_FrameBits() * SIM_UART_HostBitCycles() + 0.5);
+}
+
+// the receiver samples the first stop bit in the middle of its own bit time,
+// the character is intact when that falls within the sender's stop bit
+static bool SIM_UART_FrameOk(double senderBit, double receiverBit)
+{
+    double stop = SIM_UART_FrameBits() - 1u;
+    double sample = (stop + 0.5) * receiverBit;
+
+    return (uart.hostBaud == 0u)
+        || ((sample >= stop * senderBit) && (sample < (stop + 1.0) * senderBit));
+}
+
+// Recompute flag bits that are a function of the FIFO state
+static void SIM_UART_StatusUpdate(void)
+{
+    volatile uint32_t *sta = SIM_SFR_Ptr(U2STA_ADDR);
+    volatile uint32_t *ifs = SIM_SFR_Ptr(IFS1_ADDR);
+    uint32_t s = *sta & ~(_U2STA_UTXBF_MASK | _U2STA_TRMT_MASK | _U2STA_URXDA_MASK);
+    bool txIrq;
+
+    if (uart.txFifo.count == SIM_UART_FIFO_DEPTH)
+    {
+        s |= _U2STA_UTXBF_MASK;
+    }
+    if ((uart.txFifo.count == 0u) && !uart.shiftBusy)
+    {
+        s |= _U2STA_TRMT_MASK;
+    }
+    // FERR belongs to the character at the top of the RX FIFO
+    s &= ~_U2STA_FERR_MASK;
+    if (uart.rxFifo.count != 0u)
+    {
+        s |= _U2STA_URXDA_MASK;
+        if ((uart.rxFifo.data[uart.rxFifo.head] & SIM_UART_RX_FERR) != 0u)
+        {
+            s |= _U2STA_FERR_MASK;
+        }
+    }
+    *sta = s;
+
+    uart.txRequest = false;
+    if (!SIM_UART_On() || ((s & _U2STA_UTXEN_MASK) == 0u))
+    {
+        return;
+    }
+    switch (s & _U2STA_UTXISEL_MASK)
+    {
+        case 0u:            // TX buffer has at least one empty slot
+            txIrq = uart.txFifo.count < SIM_UART_FIFO_DEPTH;
+            break;
+        case _U2STA_UTXISEL0_MASK:  // all characters transmitted
+            txIrq = (s & _U2STA_TRMT_MASK) != 0u;
+            break;
+        default:            // TX buffer empty
+            txIrq = uart.txFifo.count == 0u;
+            break;
+    }
+    uart.txRequest = txIrq;
+    if (txIrq)
+    {
+        *ifs |= _IFS1_U2TXIF_MASK;
+    }
+    if (uart.rxFifo.count != 0u)
+    {
+        *ifs |= _IFS1_U2RXIF_MASK;
+    }
+}
+
+static void SIM_UART_ShiftLoad(void)
+{
+    if (!uart.shiftBusy && (uart.txFifo.count != 0u))
+    {
+        uart.shiftData = SIM_UART_FifoPop(&uart.txFifo);
+        uart.shiftBusy = true;
+        uart.txDoneAt = simCycles + SIM_UART_CharCycles();
+        SIM_EventsReschedule();
+    }
+}
+
+static void SIM_UART_TxPush(uint16_t data)
+{
+    if (SIM_UART_On() && ((*SIM_SFR_Ptr(U2STA_ADDR) & _U2STA_UTXEN_MASK) != 0u))
+    {
+        // a write to a full FIFO is lost, as on silicon
+        (void)SIM_UART_FifoPush(&uart.txFifo, data);
+        SIM_UART_ShiftLoad();
+    }
+}
+
+void SIM_UART_Sync(void)
+{
+    volatile uint32_t *txreg = SIM_SFR_Ptr(U2TXREG_ADDR);
+
+    if (*txreg != SIM_UART_TXREG_EMPTY)
+    {
+        uint16_t data = (uint16_t)(*txreg & 0x1FFu);
+
+        *txreg = SIM_UART_TXREG_EMPTY;
+        SIM_UART_TxPush(data);
+    }
+    SIM_UART_StatusUpdate();
+}
+
+void SIM_UART_TxWrite(uint16_t data)
+{
+    SIM_UART_TxPush(data & 0x1FFu);
+    SIM_UART_StatusUpdate();
+}
+
+bool SIM_UART_TxRequest(void)
+{
+    return uart.txRequest;
+}
+
+void SIM_UART_ReadHook(uint32_t address)
+{
+    (void)address;
+    if (uart.rxFifo.count != 0u)
+    {
+        *SIM_SFR_Ptr(U2RXREG_ADDR) = SIM_UART_FifoPop(&uart.rxFifo) & 0x1FFu;
+    }
+    SIM_UART_StatusUpdate();
+}
+
+uint64_t SIM_UART_NextEvent(void)
+{
+    uint64_t next = uart.shiftBusy ? uart.txDoneAt : SIM_TIME_NEVER;
+
+    if ((uart.rxPendingPos < uart.rxPendingSize) && (uart.rxNextAt < next))
+    {
+        next = uart.rxNextAt;
+    }
+    return next;
+}
+
+// U2MODE.ABAUD: the 0x55 is timed from its first to its fifth falling edge
+// (8 bits), the count goes to U2BRG and the character is not received
+static void SIM_UART_AutoBaud(void)
+{
+    volatile uint32_t *mode = SIM_SFR_Ptr(U2MODE_ADDR);
+    double div = ((*mode & _U2MODE_BRGH_MASK) != 0u) ? 4.0 : 16.0;
+    uint32_t count = (uint32_t)(SIM_UART_HostBitCycles() / (SIM_CPU_CLOCK_HZ / SIM_PB_CLOCK_HZ) / div);
+
+    *SIM_SFR_Ptr(U2BRG_ADDR) = (count > 0u) ? (count - 1u) : 0u;
+    *mode &= ~_U2MODE_ABAUD_MASK;
+    uart.autobauds++;
+}
+
+static void SIM_UART_Receive(uint8_t c)
+{
+    uint16_t data = c;
+
+    if ((*SIM_SFR_Ptr(U2MODE_ADDR) & _U2MODE_ABAUD_MASK) != 0u)
+    {
+        SIM_UART_AutoBaud();
+        return;
+    }
+    if (!SIM_UART_FrameOk(SIM_UART_HostBitCycles(), (double)SIM_UART_BitCycles()))
+    {
+        uart.framingErrors++;
+        data |= SIM_UART_RX_FERR;
+        *SIM_SFR_Ptr(IFS1_ADDR) |= _IFS1_U2EIF_MASK;
+    }
+    if (!SIM_UART_FifoPush(&uart.rxFifo, data))
+    {
+        uart.overruns++;
+        *SIM_SFR_Ptr(U2STA_ADDR) |= _U2STA_OERR_MASK;
+        *SIM_SFR_Ptr(IFS1_ADDR) |= _IFS1_U2EIF_MASK;
+    }
+    else
+    {
+        uart.bytesRx++;
+    }
+}
+
+void SIM_UART_Event(void)
+{
+    bool ok;
+
+    if (uart.shiftBusy && (simCycles >= uart.txDoneAt))
+    {
+        uint8_t c = (uint8_t)uart.shiftData;
+
+        uart.shiftBusy = false;
+        uart.bytesTx++;
+        uart.lineBusyCycles += SIM_UART_CharCycles();
+        ok = SIM_UART_FrameOk((double)SIM_UART_BitCycles(), SIM_UART_HostBitCycles());
+        if (!ok)
+        {
+            uart.hostErrors++;
+        }
+        else if (!simQuiet)
+        {
+            fputc(c, stdout);
+        }
+        SIM_HOST_Receive(c, ok);
+        SIM_UART_ShiftLoad();
+    }
+    if ((uart.rxPendingPos < uart.rxPendingSize) && (simCycles >= uart.rxNextAt))
+    {
+        uint32_t sta = *SIM_SFR_Ptr(U2STA_ADDR);
+
+        if (SIM_UART_On() && ((sta & _U2STA_URXEN_MASK) != 0u))
+        {
+            SIM_UART_Receive(uart.rxPending[uart.rxPendingPos]);
+        }
+        uart.rxPendingPos++;
+        // back to back characters, the event may have run a little late
+        uart.rxNextAt += SIM_UART_HostCharCycles();
+    }
+    SIM_UART_StatusUpdate();
+    SIM_EventsReschedule();
+}
+
+void SIM_UART_RxInject(const uint8_t *data, size_t size)
+{
+    size_t remaining = uart.rxPendingSize - uart.rxPendingPos;
+    uint8_t *buf = malloc(remaining + size);
+
+    if (buf == NULL)
+    {
+        return;
+    }
+    if (remaining != 0u)
+    {
+        memcpy(buf, uart.rxPending + uart.rxPendingPos, remaining);
+    }
+    else
+    {
+        uart.rxNextAt = simCycles + SIM_UART_HostCharCycles();
+    }
+    memcpy(buf + remaining, data, size);
+    free(uart.rxPending);
+    uart.rxPending = buf;
+    uart.rxPendingSize = remaining + size;
+    uart.rxPendingPos = 0;
+    SIM_EventsReschedule();
+}
+
+void SIM_UART_HostBaudSet(uint32_t baud)
+{
+    uart.hostBaud = baud;
+}
+
+uint32_t SIM_UART_HostBaudGet(void)
+{
+    return (uint32_t)((double)SIM_CPU_CLOCK_HZ / SIM_UART_HostBitCycles() + 0.5);
+}
+
+void SIM_UART_StatsGet(SIM_UART_STATS *stats)
+{
+    stats->bytesTx = uart.bytesTx;
+    stats->bytesRx = uart.bytesRx;
+    stats->overruns = uart.overruns;
+    stats->hostErrors = uart.hostErrors;
+    stats->framingErrors = uart.framingErrors;
+    stats->autobauds = uart.autobauds;
+}
+
+void SIM_UART_Reset(void)
+{
+    uint32_t hostBaud = uart.hostBaud;
+
+    free(uart.rxPending);
+    uart = (SIM_UART_OBJ){ .hostBaud = hostBaud };
+    *SIM_SFR_Ptr(U2TXREG_ADDR) = SIM_UART_TXREG_EMPTY;
+    *SIM_SFR_Ptr(U2STA_ADDR) = _U2STA_TRMT_MASK;
+}
+
+void SIM_UART_Report(FILE *out)
+{
+    fprintf(out, "uart2: %llu bytes tx (line busy %.1f us), %llu bytes rx, %llu overruns\n",
+            (unsigned long long)uart.bytesTx, SIM_CYCLES_TO_US(uart.lineBusyCycles),
+            (unsigned long long)uart.bytesRx, (unsigned long long)uart.overruns);
+    if (uart.hostBaud != 0u)
+    {
+        fprintf(out, "uart2: host at %u Bd, UART2 at %u Bd, %llu characters lost by the host, "
+                "%llu framing errors, %llu auto-baud measurements\n", (unsigned)uart.hostBaud,
+                (unsigned)(SIM_CPU_CLOCK_HZ / SIM_UART_BitCycles()), (unsigned long long)uart.hostErrors,
+                (unsigned long long)uart.framingErrors, (unsigned long long)uart.autobauds);
+    }
+}
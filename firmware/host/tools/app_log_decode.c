@@ -0,0 +1,391 @@
+/*******************************************************************************
+  Dictionary log decoder
+
+  File Name:
+    app_log_decode.c
+
+  Summary:
+    Turns the binary UART2 stream of an APP_LOG_DICT=1 build back into text.
+
+  Description:
+    Usage: app_log_decode firmware.elf [stream]
+
+    Reads the .app_log_dict section of the ELF (the format strings, see
+    src/app_log.h) and the allocated sections (for the strings %s arguments
+    point to), then decodes frames from the stream (default stdin):
+
+      0xF0 | nArgs, varint ID, nArgs x varint argument
+
+    The ID is the offset of the format string in .app_log_dict. A frame whose
+    argument count does not match its format is skipped byte by byte until
+    the next valid one, so decoding resumes after lost bytes.
+
+    Works with 32 bit (XC32) and 64 bit (host simulator) little endian ELF.
+ *******************************************************************************/
+
+#include <elf.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DICT_SECTION    ".app_log_dict"
+#define FRAME_MARK      0xF0u
+#define FRAME_ARGS_MAX  6u
+#define FRAME_SIZE_MAX  (1u + 10u * (FRAME_ARGS_MAX + 1u))
+
+typedef struct
+{
+    uint64_t addr;
+    uint64_t size;
+    const uint8_t *data;
+} SECTION;
+
+static uint8_t *elfImage;
+static size_t elfSize;
+static bool elf64;
+static SECTION dict;
+static SECTION *allocSections;
+static size_t allocSectionCount;
+
+static uint8_t *FileRead(const char *name, size_t *size)
+{
+    FILE *f = fopen(name, "rb");
+    uint8_t *buf = NULL;
+    long len;
+
+    if (f == NULL)
+    {
+        return NULL;
+    }
+    if ((fseek(f, 0, SEEK_END) == 0) && ((len = ftell(f)) > 0) && (fseek(f, 0, SEEK_SET) == 0))
+    {
+        buf = malloc((size_t)len);
+        if ((buf != NULL) && (fread(buf, 1, (size_t)len, f) != (size_t)len))
+        {
+            free(buf);
+            buf = NULL;
+        }
+        *size = (size_t)len;
+    }
+    fclose(f);
+    return buf;
+}
+
+static bool ElfLoad(const char *name)
+{
+    uint64_t shoff;
+    unsigned shnum;
+    unsigned shentsize;
+    unsigned shstrndx;
+    const uint8_t *shstr;
+    unsigned i;
+
+    elfImage = FileRead(name, &elfSize);
+    if ((elfImage == NULL) || (elfSize < sizeof(Elf32_Ehdr)) ||
+        (memcmp(elfImage, ELFMAG, SELFMAG) != 0) || (elfImage[EI_DATA] != ELFDATA2LSB))
+    {
+        return false;
+    }
+    elf64 = (elfImage[EI_CLASS] == ELFCLASS64);
+    if (elf64)
+    {
+        const Elf64_Ehdr *eh = (const Elf64_Ehdr *)elfImage;
+
+        shoff = eh->e_shoff;
+        shnum = eh->e_shnum;
+        shentsize = eh->e_shentsize;
+        shstrndx = eh->e_shstrndx;
+    }
+    else
+    {
+        const Elf32_Ehdr *eh = (const Elf32_Ehdr *)elfImage;
+
+        shoff = eh->e_shoff;
+        shnum = eh->e_shnum;
+        shentsize = eh->e_shentsize;
+        shstrndx = eh->e_shstrndx;
+    }
+    if ((shoff + (uint64_t)shnum * shentsize > elfSize) || (shstrndx >= shnum))
+    {
+        return false;
+    }
+    allocSections = calloc(shnum, sizeof(SECTION));
+    if (allocSections == NULL)
+    {
+        return false;
+    }
+
+    {
+        const uint8_t *st = elfImage + shoff + (uint64_t)shstrndx * shentsize;
+
+        shstr = elfImage + (elf64 ? ((const Elf64_Shdr *)st)->sh_offset :
+                                    ((const Elf32_Shdr *)st)->sh_offset);
+    }
+    for (i = 0; i < shnum; i++)
+    {
+        const uint8_t *sh = elfImage + shoff + (uint64_t)i * shentsize;
+        uint64_t type;
+        uint64_t flags;
+        uint64_t addr;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t nameIndex;
+
+        if (elf64)
+        {
+            const Elf64_Shdr *s = (const Elf64_Shdr *)sh;
+
+            nameIndex = s->sh_name; type = s->sh_type; flags = s->sh_flags;
+            addr = s->sh_addr; offset = s->sh_offset; size = s->sh_size;
+        }
+        else
+        {
+            const Elf32_Shdr *s = (const Elf32_Shdr *)sh;
+
+            nameIndex = s->sh_name; type = s->sh_type; flags = s->sh_flags;
+            addr = s->sh_addr; offset = s->sh_offset; size = s->sh_size;
+        }
+        if ((type == SHT_NOBITS) || (offset + size > elfSize))
+        {
+            continue;
+        }
+        if (strcmp((const char *)shstr + nameIndex, DICT_SECTION) == 0)
+        {
+            dict = (SECTION){ addr, size, elfImage + offset };
+        }
+        else if ((flags & SHF_ALLOC) != 0u)
+        {
+            allocSections[allocSectionCount++] = (SECTION){ addr, size, elfImage + offset };
+        }
+    }
+    return dict.data != NULL;
+}
+
+// NUL terminated string at a target address, NULL when it is not in the ELF
+static const char *StringAt(uint64_t addr)
+{
+    size_t i;
+
+    for (i = 0; i < allocSectionCount; i++)
+    {
+        const SECTION *s = &allocSections[i];
+
+        if ((addr >= s->addr) && (addr < s->addr + s->size) &&
+            (memchr(s->data + (addr - s->addr), '\0', s->size - (addr - s->addr)) != NULL))
+        {
+            return (const char *)s->data + (addr - s->addr);
+        }
+    }
+    return NULL;
+}
+
+// format string of an ID, NULL when the ID is not the start of one
+static const char *DictFormat(uint64_t id)
+{
+    if ((id >= dict.size) || ((id != 0u) && (dict.data[id - 1u] != '\0')) ||
+        (memchr(dict.data + id, '\0', dict.size - id) == NULL))
+    {
+        return NULL;
+    }
+    return (const char *)dict.data + id;
+}
+
+static unsigned Conversions(const char *fmt)
+{
+    unsigned n = 0;
+
+    for (; *fmt != '\0'; fmt++)
+    {
+        if (*fmt == '%')
+        {
+            fmt++;
+            if (*fmt == '\0')
+            {
+                break;
+            }
+            if (*fmt != '%')
+            {
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+static void Print(FILE *out, const char *fmt, const uint64_t *args)
+{
+    char spec[16];
+
+    while (*fmt != '\0')
+    {
+        const char *start = fmt;
+        size_t len;
+
+        if (*fmt != '%')
+        {
+            fputc(*fmt++, out);
+            continue;
+        }
+        fmt++;
+        if (*fmt == '%')
+        {
+            fputc('%', out);
+            fmt++;
+            continue;
+        }
+        // flags, width, precision and length modifiers up to the conversion
+        fmt += strspn(fmt, "-+ #0123456789.hlzjt");
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        // length modifiers are dropped, arguments are printed as (unsigned) int
+        len = 0;
+        for (; (start <= fmt) && (len < sizeof(spec) - 1u); start++)
+        {
+            if (strchr("hlzjt", *start) == NULL)
+            {
+                spec[len++] = *start;
+            }
+        }
+        spec[len] = '\0';
+        switch (*fmt)
+        {
+            case 'd':
+            case 'i':
+                // the firmware passes int, sign extended when uintptr_t is wider
+                fprintf(out, spec, (int)(int32_t)*args);
+                break;
+            case 's':
+            {
+                const char *str = StringAt(*args);
+
+                if (str != NULL)
+                {
+                    fprintf(out, spec, str);
+                }
+                else
+                {
+                    fprintf(out, "<0x%llx>", (unsigned long long)*args);
+                }
+                break;
+            }
+            case 'p':
+                fprintf(out, "0x%llx", (unsigned long long)*args);
+                break;
+            default:
+                fprintf(out, spec, (unsigned)(uint32_t)*args);
+                break;
+        }
+        args++;
+        fmt++;
+    }
+}
+
+// decodes the frame at buf, returns its length or 0 when it is not valid
+static size_t FrameDecode(FILE *out, const uint8_t *buf, size_t len, bool *incomplete)
+{
+    uint64_t values[1u + FRAME_ARGS_MAX];
+    unsigned nArgs = buf[0] & 0x0fu;
+    unsigned v;
+    size_t pos = 1;
+    const char *fmt;
+
+    *incomplete = false;
+    if (((buf[0] & 0xf0u) != FRAME_MARK) || (nArgs > FRAME_ARGS_MAX))
+    {
+        return 0;
+    }
+    for (v = 0; v < 1u + nArgs; v++)
+    {
+        unsigned shift = 0;
+
+        values[v] = 0;
+        do
+        {
+            if (pos >= len)
+            {
+                *incomplete = true;
+                return 0;
+            }
+            if (shift > 63u)
+            {
+                return 0;
+            }
+            values[v] |= (uint64_t)(buf[pos] & 0x7fu) << shift;
+            shift += 7u;
+        } while ((buf[pos++] & 0x80u) != 0u);
+    }
+    fmt = DictFormat(values[0]);
+    if ((fmt == NULL) || (Conversions(fmt) != nArgs))
+    {
+        return 0;
+    }
+    Print(out, fmt, &values[1]);
+    return pos;
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t buf[4096];
+    size_t len = 0;
+    size_t skipped = 0;
+    bool eof = false;
+    FILE *in = stdin;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "Usage: %s firmware.elf [stream]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!ElfLoad(argv[1]))
+    {
+        fprintf(stderr, "%s: no " DICT_SECTION " section in %s (built with APP_LOG_DICT=1?)\n",
+                argv[0], argv[1]);
+        return EXIT_FAILURE;
+    }
+    if ((argc == 3) && ((in = fopen(argv[2], "rb")) == NULL))
+    {
+        perror(argv[2]);
+        return EXIT_FAILURE;
+    }
+    while (!eof || (len != 0u))
+    {
+        size_t pos = 0;
+
+        if (!eof)
+        {
+            size_t n = fread(buf + len, 1, sizeof(buf) - len, in);
+
+            len += n;
+            eof = (n == 0u);
+        }
+        while (pos < len)
+        {
+            bool incomplete;
+            size_t n = FrameDecode(stdout, buf + pos, len - pos, &incomplete);
+
+            if (incomplete && !eof && (len - pos < FRAME_SIZE_MAX))
+            {
+                break;
+            }
+            if (n == 0u)
+            {
+                skipped++;
+                pos++;
+                continue;
+            }
+            pos += n;
+        }
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        fflush(stdout);
+    }
+    if (skipped != 0u)
+    {
+        fprintf(stderr, "%s: %zu bytes skipped\n", argv[0], skipped);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+  Telemetry stream decoder
+
+  File Name:
+    telemetry.c
+
+  Summary:
+    COBS/CRC16 frame decoder for the APP_TELEMETRY=1 UART2 stream (see
+    telemetry.h).
+ *******************************************************************************/
+
+#include <string.h>
+#include "telemetry.h"
+
+void TLM_DecoderInit(TLM_DECODER *dec, TLM_FRAME_HANDLER frameHandler,
+                     TLM_TEXT_HANDLER textHandler, void *context)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->frameHandler = frameHandler;
+    dec->textHandler = textHandler;
+    dec->context = context;
+}
+
+static uint64_t TLM_Le(const uint8_t *p, unsigned size)
+{
+    uint64_t value = 0;
+
+    while (size-- != 0u)
+    {
+        value = (value << 8) | p[size];
+    }
+    return value;
+}
+
+bool TLM_FrameDecode(const uint8_t *segment, size_t size, TLM_FRAME *frame, bool *crcError)
+{
+    uint8_t payload[APP_TELEMETRY_PAYLOAD_MAX + 2u];
+    size_t len = 0;
+    size_t pos = 0;
+
+    *crcError = false;
+    // COBS: the code byte is the distance to the next (removed) zero
+    while (pos < size)
+    {
+        uint8_t code = segment[pos++];
+        uint8_t i;
+
+        if ((code == 0u) || (pos + code - 1u > size))
+        {
+            return false;
+        }
+        for (i = 1; i < code; i++)
+        {
+            if (len == sizeof(payload))
+            {
+                return false;
+            }
+            payload[len++] = segment[pos++];
+        }
+        if ((code != 0xffu) && (pos < size))
+        {
+            if (len == sizeof(payload))
+            {
+                return false;
+            }
+            payload[len++] = 0;
+        }
+    }
+    if (len < 3u)
+    {
+        return false;
+    }
+    len -= 2u;
+    switch (payload[0])
+    {
+        case APP_TELEMETRY_TYPE_SAMPLE:
+            if (len != APP_TELEMETRY_SAMPLE_SIZE)
+            {
+                return false;
+            }
+            break;
+        case APP_TELEMETRY_TYPE_INFO:
+            if (len != APP_TELEMETRY_INFO_SIZE)
+            {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    if (APP_TELEMETRY_Crc16(payload, len) != (uint16_t)TLM_Le(&payload[len], 2))
+    {
+        *crcError = true;
+        return false;
+    }
+    frame->type = payload[0];
+    if (frame->type == APP_TELEMETRY_TYPE_SAMPLE)
+    {
+        frame->sample.sequence = (uint16_t)TLM_Le(&payload[1], 2);
+        frame->sample.address = payload[3];
+        frame->sample.timestamp = TLM_Le(&payload[4], 8);
+        frame->sample.temp = (int8_t)payload[12];
+        frame->sample.config = payload[13];
+        frame->sample.flags = payload[14];
+    }
+    else
+    {
+        frame->info.version = (uint16_t)TLM_Le(&payload[1], 2);
+        frame->info.counterFrequency = (uint32_t)TLM_Le(&payload[4], 4);
+    }
+    return true;
+}
+
+static void TLM_TextFlush(TLM_DECODER *dec)
+{
+    if ((dec->textHandler != NULL) && (dec->size != 0u))
+    {
+        dec->textHandler(dec->segment, dec->size, dec->context);
+    }
+    dec->size = 0;
+}
+
+static void TLM_SegmentEnd(TLM_DECODER *dec)
+{
+    TLM_FRAME frame;
+    bool crcError = false;
+
+    if ((dec->size == 0u) && !dec->text)
+    {
+        return;
+    }
+    if (!dec->text && TLM_FrameDecode(dec->segment, dec->size, &frame, &crcError))
+    {
+        dec->frames++;
+        dec->frameHandler(&frame, dec->context);
+        dec->size = 0;
+    }
+    else
+    {
+        dec->crcErrors += crcError;
+        dec->textSegments++;
+        TLM_TextFlush(dec);
+    }
+    dec->text = false;
+}
+
+void TLM_DecoderPush(TLM_DECODER *dec, const uint8_t *data, size_t size)
+{
+    dec->bytes += size;
+    while (size != 0u)
+    {
+        const uint8_t *zero = memchr(data, 0, size);
+        size_t n = (zero != NULL) ? (size_t)(zero - data) : size;
+
+        while (n != 0u)
+        {
+            size_t room = TLM_SEGMENT_MAX - dec->size;
+            size_t copy = (n < room) ? n : room;
+
+            if (copy == 0u)
+            {
+                // too long for a frame, pass on what there is
+                dec->text = true;
+                TLM_TextFlush(dec);
+                continue;
+            }
+            memcpy(&dec->segment[dec->size], data, copy);
+            dec->size += copy;
+            data += copy;
+            size -= copy;
+            n -= copy;
+        }
+        if (zero == NULL)
+        {
+            return;
+        }
+        TLM_SegmentEnd(dec);
+        data++;
+        size--;
+    }
+}
+
+void TLM_DecoderFlush(TLM_DECODER *dec)
+{
+    TLM_SegmentEnd(dec);
+}
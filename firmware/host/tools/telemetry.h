@@ -0,0 +1,74 @@
+/*******************************************************************************
+  Telemetry stream decoder
+
+  File Name:
+    telemetry.h
+
+  Summary:
+    Host library that splits the UART2 stream of an APP_TELEMETRY=1 build
+    into telemetry frames and text.
+
+  Description:
+    Feed any number of bytes with TLM_DecoderPush(). Every 0x00 ends a
+    segment. A segment that COBS decodes to a payload of a known type and
+    size with a correct CRC16 is reported as a frame, anything else as text
+    (the console messages between frames, or a damaged frame). Frame layout
+    and CRC are those of src/app_telemetry.h.
+ *******************************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "app_telemetry.h"
+
+// longer segments are text and are passed on in pieces of this size
+#define TLM_SEGMENT_MAX 256u
+
+typedef struct
+{
+    uint8_t type;   // APP_TELEMETRY_TYPE_*
+    union
+    {
+        APP_TELEMETRY_SAMPLE sample;
+        struct
+        {
+            uint16_t version;
+            uint32_t counterFrequency;
+        } info;
+    };
+} TLM_FRAME;
+
+typedef void (*TLM_FRAME_HANDLER)(const TLM_FRAME *frame, void *context);
+// text is not NUL terminated and a long segment comes in several calls, the
+// handler may be NULL
+typedef void (*TLM_TEXT_HANDLER)(const uint8_t *text, size_t size, void *context);
+
+typedef struct
+{
+    TLM_FRAME_HANDLER frameHandler;
+    TLM_TEXT_HANDLER textHandler;
+    void *context;
+    uint8_t segment[TLM_SEGMENT_MAX];
+    size_t size;        // bytes kept of the current segment
+    bool text;          // the current segment was too long for a frame
+    uint64_t frames;
+    uint64_t textSegments;
+    uint64_t crcErrors; // COBS and length were fine, CRC was not
+    uint64_t bytes;
+} TLM_DECODER;
+
+void TLM_DecoderInit(TLM_DECODER *dec, TLM_FRAME_HANDLER frameHandler,
+                     TLM_TEXT_HANDLER textHandler, void *context);
+
+void TLM_DecoderPush(TLM_DECODER *dec, const uint8_t *data, size_t size);
+
+// reports a trailing segment without terminating 0x00 (end of stream)
+void TLM_DecoderFlush(TLM_DECODER *dec);
+
+// decodes one COBS segment (without the 0x00), false when it is not a frame
+bool TLM_FrameDecode(const uint8_t *segment, size_t size, TLM_FRAME *frame, bool *crcError);
+
+#endif // TELEMETRY_H
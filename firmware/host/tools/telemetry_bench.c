@@ -0,0 +1,173 @@
+/*******************************************************************************
+  Telemetry benchmark
+
+  File Name:
+    telemetry_bench.c
+
+  Summary:
+    Wire size and host parse time of telemetry frames against the text
+    temperature line.
+
+  Description:
+    Usage: telemetry_bench [samples]
+
+    Builds the same sample sequence (8 sensors) once as the console line of
+    APP_TELEMETRY=0
+
+      app.c:NNN #<n> ADDR=0x<a> Temp=<t> Celsius (raw=0x<T>)\r\n
+
+    and once as frames encoded by src/app_telemetry.c, then parses both
+    (sscanf per line, TLM_DecoderPush on the frames) and checks that both
+    give back the same samples. Wire time assumes 115200 baud 8N1. Parse
+    times depend on the host and are best of 5 runs.
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "telemetry.h"
+
+#define SENSORS         8u
+#define LINE_MAX        96u
+#define BYTES_PER_S     (115200u / 10u)
+#define RUNS            5u
+
+typedef struct
+{
+    uint64_t samples;
+    int64_t tempSum;
+    uint64_t addrSum;
+} CHECK;
+
+static double Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static APP_TELEMETRY_SAMPLE Sample(unsigned i)
+{
+    APP_TELEMETRY_SAMPLE s = {
+        .sequence = (uint16_t)(1u + i / SENSORS),
+        .address = (uint8_t)(0x48u + i % SENSORS),
+        .timestamp = (uint64_t)(i / SENSORS) * 50000u + 1234u,
+        .temp = (int8_t)(20 + (int)((i * 7u) % 15u) - 5),
+        .config = 0,
+        .flags = (i % 16u == 0u) ? APP_TELEMETRY_FLAG_CONFIG_FRESH : 0,
+    };
+
+    return s;
+}
+
+// line by line, as a reader of the UART would get them (sscanf on the whole
+// buffer would strlen() it for every line)
+static void TextParse(const char *text, size_t size, CHECK *check)
+{
+    const char *end = text + size;
+
+    while (text < end)
+    {
+        const char *eol = memchr(text, '\n', (size_t)(end - text));
+        size_t len = ((eol != NULL) ? (size_t)(eol - text) : (size_t)(end - text));
+        char line[LINE_MAX];
+        unsigned iter;
+        unsigned addr;
+        int temp;
+        unsigned raw;
+
+        len = (len < LINE_MAX - 1u) ? len : LINE_MAX - 1u;
+        memcpy(line, text, len);
+        line[len] = '\0';
+        if (sscanf(line, "%*[^ ] #%u ADDR=0x%x Temp=%d Celsius (raw=0x%x)",
+                   &iter, &addr, &temp, &raw) == 4)
+        {
+            check->samples++;
+            check->tempSum += temp;
+            check->addrSum += addr;
+        }
+        text = (eol != NULL) ? eol + 1 : end;
+    }
+}
+
+static void FrameCount(const TLM_FRAME *frame, void *context)
+{
+    CHECK *check = context;
+
+    if (frame->type == APP_TELEMETRY_TYPE_SAMPLE)
+    {
+        check->samples++;
+        check->tempSum += frame->sample.temp;
+        check->addrSum += frame->sample.address;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned samples = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : 1000000u;
+    char *text = malloc((size_t)samples * LINE_MAX);
+    uint8_t *frames = malloc((size_t)samples * APP_TELEMETRY_FRAME_MAX);
+    size_t textSize = 0;
+    size_t frameSize = 0;
+    double textTime = 1e30;
+    double frameTime = 1e30;
+    CHECK textCheck;
+    CHECK frameCheck;
+    unsigned i;
+
+    if ((samples == 0u) || (text == NULL) || (frames == NULL))
+    {
+        fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < samples; i++)
+    {
+        APP_TELEMETRY_SAMPLE s = Sample(i);
+        uint8_t payload[APP_TELEMETRY_PAYLOAD_MAX];
+
+        textSize += (size_t)sprintf(text + textSize,
+                "app.c:595 #%u ADDR=0x%x Temp=%d Celsius (raw=0x%X)\r\n",
+                s.sequence, s.address, s.temp, (uint8_t)s.temp);
+        frameSize += APP_TELEMETRY_FrameEncode(frames + frameSize, payload,
+                APP_TELEMETRY_SamplePack(payload, &s), i == 0u);
+    }
+
+    for (i = 0; i < RUNS; i++)
+    {
+        TLM_DECODER dec;
+        double t = Now();
+
+        memset(&textCheck, 0, sizeof(textCheck));
+        TextParse(text, textSize, &textCheck);
+        t = Now() - t;
+        textTime = (t < textTime) ? t : textTime;
+
+        memset(&frameCheck, 0, sizeof(frameCheck));
+        TLM_DecoderInit(&dec, FrameCount, NULL, &frameCheck);
+        t = Now();
+        TLM_DecoderPush(&dec, frames, frameSize);
+        t = Now() - t;
+        frameTime = (t < frameTime) ? t : frameTime;
+    }
+    if ((textCheck.samples != samples) || (memcmp(&textCheck, &frameCheck, sizeof(CHECK)) != 0))
+    {
+        fprintf(stderr, "%s: decoded samples differ (text %llu, frames %llu)\n", argv[0],
+                (unsigned long long)textCheck.samples, (unsigned long long)frameCheck.samples);
+        return EXIT_FAILURE;
+    }
+
+    printf("%u samples, %u sensors\n", samples, SENSORS);
+    printf("%-7s %9s %12s %14s %14s\n", "format", "B/sample", "max sps", "parse ns/smp", "parse MB/s");
+    printf("%-7s %9.2f %12.1f %14.1f %14.1f\n", "text", (double)textSize / samples,
+           (double)BYTES_PER_S * samples / textSize, textTime * 1e9 / samples,
+           textSize / textTime / 1e6);
+    printf("%-7s %9.2f %12.1f %14.1f %14.1f\n", "frames", (double)frameSize / samples,
+           (double)BYTES_PER_S * samples / frameSize, frameTime * 1e9 / samples,
+           frameSize / frameTime / 1e6);
+    printf("max sps: samples per second at 115200 baud 8N1\n");
+    free(text);
+    free(frames);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+  Telemetry decoder
+
+  File Name:
+    telemetry_decode.c
+
+  Summary:
+    Prints the sample frames of an APP_TELEMETRY=1 UART2 stream as CSV.
+
+  Description:
+    Usage: telemetry_decode [-t] [stream]
+
+    Reads the stream (default stdin) and prints one line per sample frame:
+
+      sequence,address,time_us,temp,config,config_fresh
+
+    time_us is derived from the counter frequency of the INFO frame (counter
+    ticks until one was seen). With -t the text between frames goes to
+    stderr. Frame and error counts are printed to stderr at the end.
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "telemetry.h"
+
+typedef struct
+{
+    FILE *text;
+    uint32_t counterFrequency;
+} DECODE_CONTEXT;
+
+static void FramePrint(const TLM_FRAME *frame, void *context)
+{
+    DECODE_CONTEXT *ctx = context;
+
+    if (frame->type == APP_TELEMETRY_TYPE_INFO)
+    {
+        ctx->counterFrequency = frame->info.counterFrequency;
+        printf("# v%u.%02u counter %lu Hz\n", frame->info.version / 100u,
+               frame->info.version % 100u, (unsigned long)frame->info.counterFrequency);
+        return;
+    }
+    printf("%u,0x%02x,%llu,%d,0x%02x,%u\n", frame->sample.sequence, frame->sample.address,
+           (unsigned long long)((ctx->counterFrequency != 0u) ?
+               frame->sample.timestamp * 1000000u / ctx->counterFrequency :
+               frame->sample.timestamp),
+           frame->sample.temp, frame->sample.config,
+           (frame->sample.flags & APP_TELEMETRY_FLAG_CONFIG_FRESH) != 0u);
+}
+
+static void TextPrint(const uint8_t *text, size_t size, void *context)
+{
+    DECODE_CONTEXT *ctx = context;
+
+    if (ctx->text != NULL)
+    {
+        fwrite(text, 1, size, ctx->text);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    DECODE_CONTEXT ctx = { NULL, 0 };
+    TLM_DECODER dec;
+    uint8_t buf[4096];
+    FILE *in = stdin;
+    size_t n;
+    int arg = 1;
+
+    if ((arg < argc) && (strcmp(argv[arg], "-t") == 0))
+    {
+        ctx.text = stderr;
+        arg++;
+    }
+    if (argc > arg + 1)
+    {
+        fprintf(stderr, "Usage: %s [-t] [stream]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((arg < argc) && ((in = fopen(argv[arg], "rb")) == NULL))
+    {
+        perror(argv[arg]);
+        return EXIT_FAILURE;
+    }
+    TLM_DecoderInit(&dec, FramePrint, TextPrint, &ctx);
+    printf("sequence,address,time_us,temp,config,config_fresh\n");
+    while ((n = fread(buf, 1, sizeof(buf), in)) != 0u)
+    {
+        TLM_DecoderPush(&dec, buf, n);
+        fflush(stdout);
+    }
+    TLM_DecoderFlush(&dec);
+    fprintf(stderr, "%s: %llu bytes, %llu frames, %llu text segments, %llu CRC errors\n",
+            argv[0], (unsigned long long)dec.bytes, (unsigned long long)dec.frames,
+            (unsigned long long)dec.textSegments, (unsigned long long)dec.crcErrors);
+    return EXIT_SUCCESS;
+}
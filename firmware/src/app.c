@@ -41,27 +41,131 @@
 #define APP_VERSION 104 // 123 = 1.23
 #define LED_BLINK_RATE_MS         500
 #define APP_MINIMUM_PAUSE_US 1000
-// TC74 I2C Address - WARNING! You have to read it from package and
-// use proper address. My is TC74A0
-// Where A0 according to datasheet is 0x48
+// period of the temperature samples, host simulation build overrides it
+#ifndef APP_SAMPLE_PERIOD_US
+#define APP_SAMPLE_PERIOD_US 2000000
+#endif
+// retry of busy or just woken TC74, maximum busy time should be 250ms
+#define APP_TC74_RETRY_US 300000
+// longest single SYS_TIME delay of a pause, its count fits in 32 bits.
+// Longer pauses (periods up to an hour) take several.
+#define APP_PAUSE_MAX_US 60000000u
+// Fast path: once TC74 reported READY, read only TEMP (one I2C transaction
+// instead of two). CONFIG is re-read every APP_TC74_CONFIG_EVERY scans,
+// after an error or wake-up, or when TEMP changes by more than
+// APP_TC74_MAX_JUMP Celsius between two scans.
+#ifndef APP_TC74_FAST_PATH
+#define APP_TC74_FAST_PATH 1
+#endif
+// Queue TEMP reads of all sensors on the fast path as one DRV_I2C batch:
+// items follow each other from the I2C ISR, one callback per scan
+#ifndef APP_TC74_BATCH
+#define APP_TC74_BATCH 1
+#endif
+#define APP_TC74_CONFIG_EVERY 16
+#define APP_TC74_MAX_JUMP 5
+// TC74 I2C Address - it is on package: TC74A0 .. TC74A7
+// Where A0 according to datasheet is 0x48 (mine), A7 is 0x4F.
+// All APP_TC74_SENSORS_MAX addresses from A0 are probed on start-up
 #define APP_TC74_SLAVE_ADDR_A0 0x48
-#define APP_TC74_SLAVE_ADDR_A5 0x4D
-#define APP_TC74_SLAVE_ADDR APP_TC74_SLAVE_ADDR_A0
+// I2C clock of TC74 at A0..A7, sensors with different speed get their own
+// DRV_I2C client. TC74 is SMBus device - datasheet allows max 100 kHz
+#ifndef APP_TC74_CLOCK_SPEEDS
+#define APP_TC74_CLOCK_SPEEDS { \
+    DRV_I2C_CLOCK_SPEED_IDX0, DRV_I2C_CLOCK_SPEED_IDX0, \
+    DRV_I2C_CLOCK_SPEED_IDX0, DRV_I2C_CLOCK_SPEED_IDX0, \
+    DRV_I2C_CLOCK_SPEED_IDX0, DRV_I2C_CLOCK_SPEED_IDX0, \
+    DRV_I2C_CLOCK_SPEED_IDX0, DRV_I2C_CLOCK_SPEED_IDX0 }
+#endif
 // TEMPerature register in TC74
 #define APP_TC74_REG_TEMP 0
 // CONFIG register in TC74
 #define APP_TC74_REG_CONFIG 1
+// we do not know where TC74 register pointer is
+#define APP_TC74_REG_UNKNOWN 0xff
 #define APP_TC74_CONFIG_STANDBY_MASK 0x80
 #define APP_TC74_CONFIG_READY_MASK 0x40
 #define APP_TC74_CONFIG_ZERO_MASK 0x3f
 #define APP_TC74_CONFIG_STATUS_MASK (APP_TC74_CONFIG_STANDBY_MASK|APP_TC74_CONFIG_READY_MASK)
 // short version of __FILE__ without path
-static const char *APP_FILE = "app.c";
+#define APP_FILE_NAME "app.c"
+#if !APP_LOG_DICT && APP_LOG_LEVEL_MAX >= 1
+static const char *APP_FILE = APP_FILE_NAME;
+#endif
+// Messages are queued as records and formatted later by APP_LOG_Tasks() in
+// SYS_Tasks() (app_log.h): arguments must be ints, chars or pointers to
+// literals. APP_LOG_DEFERRED 0 formats and writes them inline with
+// SYS_CONSOLE_Print(). Each message has a SYS_DEBUG level and a module
+// (APP_ or APP_TC74_ macros). Above APP_LOG_LEVEL_<module> it is not
+// compiled, otherwise it follows the run-time level (shell command "log").
+// Binary telemetry (app_telemetry.h): the temperature line is replaced by a
+// COBS framed sample frame per sensor, other messages stay text
+#ifndef APP_TELEMETRY
+#define APP_TELEMETRY 0
+#endif
+#if APP_TELEMETRY && (APP_LOG_DICT || !APP_LOG_DEFERRED)
+#error "APP_TELEMETRY needs APP_LOG_DEFERRED and text (not APP_LOG_DICT) messages"
+#endif
+#if APP_LOG_DICT && !APP_LOG_DEFERRED
+#error "APP_LOG_DICT needs APP_LOG_DEFERRED"
+#endif
+#if APP_LOG_DICT
+// app_log.h: only IDs and arguments are sent, text is in the ELF only
+#define APP_LOG_AT(level,prefix,fmt,...) \
+    do{ if ((level) <= SYS_DEBUG_ErrorLevelGet()) \
+            APP_LOG_DICT_PRINT(prefix APP_FILE_NAME ":" APP_LOG_XSTR(__LINE__) " " fmt "\r\n", \
+                               ##__VA_ARGS__); \
+    }while(0)
+#define APP_LOG_RAW(fmt,...) APP_LOG_DICT_PRINT(fmt, ##__VA_ARGS__)
+#elif APP_LOG_DEFERRED
 // improved macro that will print file and line of message
-#define APP_CONSOLE_PRINT(fmt,...) SYS_CONSOLE_PRINT("%s:%d " fmt "\r\n", APP_FILE, __LINE__, ##__VA_ARGS__)
+#define APP_LOG_AT(level,prefix,fmt,...) \
+    do{ if ((level) <= SYS_DEBUG_ErrorLevelGet()) \
+            APP_LOG_PRINT(APP_FILE, prefix "%s:%d " fmt "\r\n", ##__VA_ARGS__); \
+    }while(0)
 // simple form  without any added content
-#define APP_CONSOLE_PRINT_RAW(fmt,...) SYS_CONSOLE_PRINT(fmt, ##__VA_ARGS__)
-#define APP_ERROR_PRINT(fmt,...) SYS_DEBUG_PRINT(SYS_ERROR_ERROR, "ERROR: %s:%d " fmt "\r\n", APP_FILE, __LINE__, ##__VA_ARGS__)
+#define APP_LOG_RAW(fmt,...) APP_LOG_PRINT(NULL, fmt, ##__VA_ARGS__)
+#else
+#define APP_LOG_AT(level,prefix,fmt,...) SYS_DEBUG_PRINT(level, prefix "%s:%d " fmt "\r\n", APP_FILE, __LINE__, ##__VA_ARGS__)
+#define APP_LOG_RAW(fmt,...) SYS_CONSOLE_PRINT(fmt, ##__VA_ARGS__)
+#endif
+// not compiled: arguments are not evaluated either
+#define APP_LOG_NONE(fmt,...) do{ }while(0)
+
+// module APP: start-up, probe, fatal errors
+#if APP_LOG_LEVEL_APP >= 1
+#define APP_ERROR_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_ERROR, "ERROR: ", fmt, ##__VA_ARGS__)
+#else
+#define APP_ERROR_PRINT APP_LOG_NONE
+#endif
+#if APP_LOG_LEVEL_APP >= 3
+#define APP_CONSOLE_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_INFO, "", fmt, ##__VA_ARGS__)
+#define APP_CONSOLE_PRINT_RAW APP_LOG_RAW
+#else
+#define APP_CONSOLE_PRINT APP_LOG_NONE
+#define APP_CONSOLE_PRINT_RAW APP_LOG_NONE
+#endif
+// module TC74: every sample and sensor
+#if APP_LOG_LEVEL_TC74 >= 1
+#define APP_TC74_ERROR_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_ERROR, "ERROR: ", fmt, ##__VA_ARGS__)
+#else
+#define APP_TC74_ERROR_PRINT APP_LOG_NONE
+#endif
+#if APP_LOG_LEVEL_TC74 >= 2
+#define APP_TC74_WARNING_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_WARNING, "WARNING: ", fmt, ##__VA_ARGS__)
+#else
+#define APP_TC74_WARNING_PRINT APP_LOG_NONE
+#endif
+#if APP_LOG_LEVEL_TC74 >= 3
+#define APP_TC74_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_INFO, "", fmt, ##__VA_ARGS__)
+#else
+#define APP_TC74_PRINT APP_LOG_NONE
+#endif
+#if APP_LOG_LEVEL_TC74 >= 4
+#define APP_TC74_DEBUG_PRINT(fmt,...) APP_LOG_AT(SYS_ERROR_DEBUG, "", fmt, ##__VA_ARGS__)
+#else
+#define APP_TC74_DEBUG_PRINT APP_LOG_NONE
+#endif
 
 #define APP_ERROR_PRINT_AND_STATE(fmt,...) \
     do{ APP_ERROR_PRINT(fmt, ##__VA_ARGS__); \
@@ -117,12 +221,15 @@ static const char *APP_FILE = "app.c";
 
 APP_DATA appData;
 
+static const uint32_t appTc74ClockSpeeds[APP_TC74_SENSORS_MAX] = APP_TC74_CLOCK_SPEEDS;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Callback Functions
 // *****************************************************************************
 // *****************************************************************************
 
+// deferred SYS_TIME callback, runs from SYS_Tasks() and not in the interrupt
 void Timer1_Callback ( uintptr_t context )
 {
     if (appData.state != APP_STATE_FATAL_ERROR){
@@ -130,25 +237,38 @@ void Timer1_Callback ( uintptr_t context )
     }
 }
 
+static void APP_TC74_TransferDone(APP_TC74_SENSOR *sensor, bool ok);
+static void APP_TC74_Pump(void);
+static void APP_TC74_BatchDone(DRV_I2C_TRANSFER_EVENT event);
+
 // from harmony-repo\core_apps_pic32mx\apps\driver\i2c\async\i2c_eeprom\firmware\src\app.c
+// Called from I2C ISR. Completes transfer of one sensor and immediately
+// queues next transfer(s), so the I2C bus does not wait for APP_Tasks()
 void APP_I2CEventHandler (
     DRV_I2C_TRANSFER_EVENT event,
     DRV_I2C_TRANSFER_HANDLE transferHandle,
     uintptr_t context
 )
 {
-    APP_TRANSFER_STATUS* transferStatus = (APP_TRANSFER_STATUS*)context;
+    unsigned i;
 
-    appData.i2cEvent = event;
-    if (event == DRV_I2C_TRANSFER_EVENT_COMPLETE){
-        if (transferStatus){
-            *transferStatus = APP_TRANSFER_STATUS_SUCCESS;
-        }
-    } else {
-        if (transferStatus){
-            *transferStatus = APP_TRANSFER_STATUS_ERROR;
+    appData.transfersInFlight--;
+    if (transferHandle == appData.batchHandle){
+        appData.batchHandle = DRV_I2C_TRANSFER_HANDLE_INVALID;
+        APP_TC74_BatchDone(event);
+        APP_TC74_Pump();
+        return;
+    }
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+        if (sensor->state == APP_TC74_STATE_IN_PROGRESS
+                && sensor->transferHandle == transferHandle){
+            sensor->i2cEvent = event;
+            APP_TC74_TransferDone(sensor, event == DRV_I2C_TRANSFER_EVENT_COMPLETE);
+            break;
         }
     }
+    APP_TC74_Pump();
 }
 
 // *****************************************************************************
@@ -157,6 +277,493 @@ void APP_I2CEventHandler (
 // *****************************************************************************
 // *****************************************************************************
 
+// sensor has finished current probe/scan
+static void APP_TC74_Finish(APP_TC74_SENSOR *sensor, APP_TC74_STATE state,
+        APP_TC74_RESULT result)
+{
+    sensor->state = state;
+    sensor->result = result;
+    appData.sensorsPending--;
+}
+
+// Decide what to do next with sensor after its transfer has finished.
+// Called from I2C ISR (APP_I2CEventHandler)
+static void APP_TC74_TransferDone(APP_TC74_SENSOR *sensor, bool ok)
+{
+    uint8_t cfg;
+
+    if (!ok){
+        // NACK or bus error may leave the pointer anywhere
+        sensor->pointer = APP_TC74_REG_UNKNOWN;
+        sensor->fastPath = false;
+        if (sensor->op == APP_TC74_STATE_PROBE){
+            APP_TC74_Finish(sensor, APP_TC74_STATE_ABSENT, APP_TC74_RESULT_ERROR);
+        } else {
+            sensor->errors++;
+            APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_ERROR);
+        }
+        return;
+    }
+    sensor->pointer = sensor->pointerNext;
+    switch(sensor->op){
+        case APP_TC74_STATE_QUERY_CONFIG:
+            cfg = sensor->rxData[0];
+            sensor->config = cfg;
+            sensor->configThisScan = true;
+            sensor->scansSinceConfig = 0;
+            sensor->fastPath = false;
+            if (cfg & APP_TC74_CONFIG_ZERO_MASK){
+                APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_NOT_TC74);
+            } else if ( (cfg & APP_TC74_CONFIG_STATUS_MASK) == APP_TC74_CONFIG_READY_MASK ){
+                sensor->fastPath = APP_TC74_FAST_PATH;
+                sensor->state = APP_TC74_STATE_QUERY_TEMP;
+            } else if (cfg & APP_TC74_CONFIG_STANDBY_MASK){
+                sensor->state = APP_TC74_STATE_WAKEUP;
+            } else {
+                APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_BUSY);
+            }
+            break;
+        case APP_TC74_STATE_WAKEUP:
+            APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_WAKEUP);
+            break;
+        case APP_TC74_STATE_QUERY_TEMP:
+        {
+            // temperature is signed !
+            int8_t temp = (int8_t)sensor->rxData[0];
+            if (!sensor->configThisScan && abs(temp - sensor->temp) > APP_TC74_MAX_JUMP){
+                // implausible on fast path: check CONFIG and read TEMP again
+                sensor->anomaly = true;
+                sensor->anomalies++;
+                sensor->state = APP_TC74_STATE_QUERY_CONFIG;
+                break;
+            }
+            sensor->temp = temp;
+            APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_TEMP);
+        }
+        break;
+        default: // APP_TC74_STATE_PROBE
+            APP_TC74_Finish(sensor, APP_TC74_STATE_IDLE, APP_TC74_RESULT_NONE);
+            break;
+    }
+}
+
+// Queue transfer for sensor. Returns false when DRV_I2C refused it (queue full)
+static bool APP_TC74_Submit(APP_TC74_SENSOR *sensor)
+{
+    DRV_I2C_TRANSFER_HANDLE *h = &sensor->transferHandle;
+
+    switch(sensor->state){
+        case APP_TC74_STATE_PROBE:
+            sensor->pointerNext = sensor->pointer;
+            // read should be non-destructive for all I2C devices.
+            DRV_I2C_ReadTransferAdd(sensor->drvI2CHandle, sensor->address,
+                    sensor->rxData, 1, h);
+            break;
+        case APP_TC74_STATE_QUERY_CONFIG:
+            // select and query CONFIG register to know if TC74 is Up and
+            // and Ready to read TEMPerature
+            sensor->txData[0] = APP_TC74_REG_CONFIG;
+            sensor->rxData[0] = 0; // clean read buffer
+            sensor->pointerNext = APP_TC74_REG_CONFIG;
+            DRV_I2C_WriteReadTransferAdd(sensor->drvI2CHandle, sensor->address,
+                    sensor->txData, 1, sensor->rxData, 1, h);
+            break;
+        case APP_TC74_STATE_WAKEUP:
+            sensor->txData[0] = APP_TC74_REG_CONFIG;
+            sensor->txData[1] = 0; // clean SHUTDOWN bit;
+            sensor->pointerNext = APP_TC74_REG_CONFIG;
+            DRV_I2C_WriteTransferAdd(sensor->drvI2CHandle, sensor->address,
+                    sensor->txData, 2, h);
+            break;
+        case APP_TC74_STATE_QUERY_TEMP:
+            sensor->rxData[0] = 0; // clean read buffer
+            if (sensor->pointer == APP_TC74_REG_TEMP){
+                // TC74 still points to TEMPerature: plain 1 byte read,
+                // 2 bytes on bus instead of 3 and repeated START
+                sensor->pointerNext = APP_TC74_REG_TEMP;
+                DRV_I2C_ReadTransferAdd(sensor->drvI2CHandle, sensor->address,
+                        sensor->rxData, 1, h);
+                break;
+            }
+            // select and query TEMPERATURE register to get current temperature
+            sensor->txData[0] = APP_TC74_REG_TEMP;
+            sensor->pointerNext = APP_TC74_REG_TEMP;
+            DRV_I2C_WriteReadTransferAdd(sensor->drvI2CHandle, sensor->address,
+                    sensor->txData, 1, sensor->rxData, 1, h);
+            break;
+        default:
+            // idle, finished or transfer in flight (pointerNext is in use)
+            return true;
+    }
+    if (*h == DRV_I2C_TRANSFER_HANDLE_INVALID){
+        return false;
+    }
+    sensor->op = sensor->state;
+    sensor->state = APP_TC74_STATE_IN_PROGRESS;
+    appData.transfersInFlight++;
+    return true;
+}
+
+// Poll scheduler: keeps DRV_I2C transfer queue full. Sensors are served
+// round-robin, each has at most one transfer in the queue.
+// Must run with I2C callback excluded: from ISR or with interrupts disabled
+static void APP_TC74_Pump(void)
+{
+    unsigned n;
+
+    for(n=0; n < APP_TC74_SENSORS_MAX; n++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[appData.pumpOrder[appData.pumpNext]];
+
+        if (!APP_TC74_Submit(sensor)){
+            if (appData.transfersInFlight == 0){
+                // refused with empty queue - it will never succeed
+                sensor->errors++;
+                APP_TC74_Finish(sensor, sensor->state == APP_TC74_STATE_PROBE ?
+                        APP_TC74_STATE_ABSENT : APP_TC74_STATE_IDLE,
+                        APP_TC74_RESULT_ERROR);
+            } else {
+                // retried from APP_I2CEventHandler when slot is free
+                break;
+            }
+        }
+        appData.pumpNext = (appData.pumpNext + 1) % APP_TC74_SENSORS_MAX;
+    }
+}
+
+#if APP_TC74_BATCH
+// Queue TEMP reads of sensors in QUERY_TEMP state as one DRV_I2C batch.
+// Batch items share transfer setup, so only sensors on the same client as
+// the first one are taken. The rest is left to APP_TC74_Pump().
+// Must run with I2C callback excluded (interrupts disabled)
+static void APP_TC74_BatchSubmit(void)
+{
+    DRV_HANDLE h = DRV_HANDLE_INVALID;
+    DRV_I2C_TRANSFER_HANDLE batchHandle;
+    unsigned i;
+    unsigned n = 0;
+
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[appData.pumpOrder[i]];
+        DRV_I2C_BATCH_ITEM *item = &appData.batchItems[n];
+
+        if (sensor->state != APP_TC74_STATE_QUERY_TEMP){
+            continue;
+        }
+        if (h == DRV_HANDLE_INVALID){
+            h = sensor->drvI2CHandle;
+        } else if (sensor->drvI2CHandle != h){
+            continue;
+        }
+        sensor->rxData[0] = 0; // clean read buffer
+        item->address = sensor->address;
+        item->readBuffer = sensor->rxData;
+        item->readSize = 1;
+        if (sensor->pointer == APP_TC74_REG_TEMP){
+            item->writeBuffer = NULL;
+            item->writeSize = 0;
+        } else {
+            sensor->txData[0] = APP_TC74_REG_TEMP;
+            item->writeBuffer = sensor->txData;
+            item->writeSize = 1;
+        }
+        sensor->pointerNext = APP_TC74_REG_TEMP;
+        appData.batchSensors[n++] = appData.pumpOrder[i];
+    }
+    if (n < 2){
+        // nothing to save on a single transfer
+        return;
+    }
+    appData.batch.items = appData.batchItems;
+    appData.batch.nItems = n;
+    DRV_I2C_BatchTransferAdd(h, &appData.batch, &batchHandle);
+    appData.batchHandle = batchHandle;
+    if (batchHandle == DRV_I2C_TRANSFER_HANDLE_INVALID){
+        // queue full, sensors go one by one
+        return;
+    }
+    for(i=0; i < n; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[appData.batchSensors[i]];
+        sensor->op = APP_TC74_STATE_QUERY_TEMP;
+        sensor->state = APP_TC74_STATE_IN_PROGRESS;
+        sensor->transferHandle = batchHandle;
+    }
+    appData.transfersInFlight++;
+}
+#endif
+
+// Batch has finished: items before batch.nDone were read, on error
+// batch.nDone is the one that failed and later items were not started.
+// Called from I2C ISR (APP_I2CEventHandler)
+static void APP_TC74_BatchDone(DRV_I2C_TRANSFER_EVENT event)
+{
+    unsigned i;
+
+    appData.batches++;
+    appData.batchItemsDone += appData.batch.nDone;
+    appData.batchBusTicks += appData.batch.busTicks;
+    appData.batchGapTicks += appData.batch.gapTicks;
+    for(i=0; i < appData.batch.nItems; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[appData.batchSensors[i]];
+        if (i < appData.batch.nDone){
+            sensor->i2cEvent = DRV_I2C_TRANSFER_EVENT_COMPLETE;
+            APP_TC74_TransferDone(sensor, true);
+        } else if (i == appData.batch.nDone){
+            sensor->i2cEvent = event;
+            APP_TC74_TransferDone(sensor, false);
+        } else {
+            // not started, APP_TC74_Pump() queues it alone
+            sensor->state = APP_TC74_STATE_QUERY_TEMP;
+        }
+    }
+}
+
+// put all present sensors (or all addresses when probing) to state and
+// start transfers
+static void APP_TC74_ScanStart(APP_TC74_STATE state)
+{
+    bool interruptStatus;
+    unsigned i;
+
+    interruptStatus = SYS_INT_Disable();
+    appData.sensorsPending = 0;
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+        if (state == APP_TC74_STATE_PROBE || sensor->state != APP_TC74_STATE_ABSENT){
+            sensor->state = state;
+            sensor->result = APP_TC74_RESULT_NONE;
+            sensor->configThisScan = false;
+            sensor->anomaly = false;
+            if (state == APP_TC74_STATE_QUERY_CONFIG && sensor->fastPath
+                    && ++sensor->scansSinceConfig < APP_TC74_CONFIG_EVERY){
+                sensor->state = APP_TC74_STATE_QUERY_TEMP;
+            }
+            appData.sensorsPending++;
+        }
+    }
+    // sensors switched on again by APP_SensorEnable() are probed in this scan
+    if (appData.sensorsProbing != 0){
+        for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+            APP_TC74_SENSOR *sensor = &appData.sensors[i];
+            if (appData.sensorsProbing & (1u << i)){
+                sensor->state = APP_TC74_STATE_PROBE;
+                sensor->result = APP_TC74_RESULT_NONE;
+                sensor->configThisScan = false;
+                sensor->anomaly = false;
+                appData.sensorsPending++;
+            }
+        }
+    }
+#if APP_TC74_BATCH
+    if (state == APP_TC74_STATE_QUERY_CONFIG){
+        APP_TC74_BatchSubmit();
+    }
+#endif
+    APP_TC74_Pump();
+    SYS_INT_Restore(interruptStatus);
+}
+
+// sensor changes asked for by APP_SensorEnable(), between two scans
+static void APP_TC74_RequestsApply(void)
+{
+    unsigned i;
+
+    if ((appData.sensorsOff | appData.sensorsProbe | appData.sensorsProbing) == 0){
+        return;
+    }
+    appData.sensorsProbing = 0;
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+        uint32_t bit = 1u << i;
+
+        if (appData.sensorsOff & bit){
+            sensor->state = APP_TC74_STATE_ABSENT;
+            sensor->fastPath = false;
+        } else if ((appData.sensorsProbe & bit) && sensor->state == APP_TC74_STATE_ABSENT){
+            sensor->pointer = APP_TC74_REG_UNKNOWN;
+            sensor->oldConfig = ~0;
+            appData.sensorsProbing |= bit;
+        }
+    }
+    appData.sensorsOff = 0;
+    appData.sensorsProbe = 0;
+}
+
+#if APP_TELEMETRY
+// sample frame of one sensor, CRC and framing are added by APP_LOG_Tasks()
+static void APP_TC74_TelemetrySend(const APP_TC74_SENSOR *sensor, uint64_t timestamp)
+{
+    uint8_t payload[APP_TELEMETRY_PAYLOAD_MAX];
+    APP_TELEMETRY_SAMPLE sample = {
+        .sequence = (uint16_t)appData.iter,
+        .address = sensor->address,
+        .timestamp = timestamp,
+        .temp = sensor->temp,
+        .config = sensor->config,
+        .flags = sensor->configThisScan ? APP_TELEMETRY_FLAG_CONFIG_FRESH : 0,
+    };
+
+    APP_LOG_FrameWrite(payload, APP_TELEMETRY_SamplePack(payload, &sample));
+}
+#endif
+
+// outcome of the probes of APP_TC74_ScanStart(), a sensor that answered is
+// polled from the next scan on
+static void APP_TC74_ProbeReport(void)
+{
+    unsigned i;
+
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+
+        if ((appData.sensorsProbing & (1u << i)) == 0){
+            continue;
+        }
+        if (sensor->state == APP_TC74_STATE_ABSENT){
+            APP_CONSOLE_PRINT("TC74 at ADDR=0x%x did not respond, not polled.", sensor->address);
+        } else {
+            APP_CONSOLE_PRINT("OK: I2C ACK response from dev at ADDR=0x%x. Data=0x%x",
+                    sensor->address, sensor->rxData[0]);
+        }
+    }
+}
+
+// print results of finished scan. Returns number of temperatures read
+static unsigned APP_TC74_ScanReport(bool *retry)
+{
+    unsigned i;
+    unsigned temps = 0;
+
+    *retry = false;
+    if (appData.sensorsProbing != 0){
+        APP_TC74_ProbeReport();
+    }
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+        uint8_t cfg = sensor->config;
+
+        if (sensor->state == APP_TC74_STATE_ABSENT
+                || (appData.sensorsProbing & (1u << i))){
+            continue;
+        }
+        if (sensor->result != APP_TC74_RESULT_ERROR && cfg != sensor->oldConfig){
+            APP_TC74_DEBUG_PRINT("Data from TC74 at ADDR=0x%x: CONFIG=0x%x %s %s zero mask: 0x%x",
+                    sensor->address, cfg,
+                    cfg & APP_TC74_CONFIG_STANDBY_MASK ? "STANDBY" : "UP",
+                    cfg & APP_TC74_CONFIG_READY_MASK ? "READY" : "BUSY",
+                    cfg & APP_TC74_CONFIG_ZERO_MASK);
+            sensor->oldConfig = cfg;
+        }
+        if (sensor->anomaly){
+            APP_TC74_WARNING_PRINT("TC74 at ADDR=0x%x: TEMP jump over %d Celsius, CONFIG re-read (%u times).",
+                    sensor->address, APP_TC74_MAX_JUMP, sensor->anomalies);
+        }
+        switch(sensor->result){
+            case APP_TC74_RESULT_TEMP:
+                temps++;
+                break;
+            case APP_TC74_RESULT_BUSY:
+                *retry = true;
+                APP_TC74_DEBUG_PRINT("TC74 at ADDR=0x%x busy: waiting %ums before retry.",
+                        sensor->address, APP_TC74_RETRY_US/1000);
+                break;
+            case APP_TC74_RESULT_WAKEUP:
+                *retry = true;
+                APP_TC74_PRINT("TC74 at ADDR=0x%x Waking Up!: waiting %ums before retry.",
+                        sensor->address, APP_TC74_RETRY_US/1000);
+                break;
+            case APP_TC74_RESULT_NOT_TC74:
+                APP_TC74_ERROR_PRINT("Invalid CONFIG=0x%x LSB bits==0x%x at ADDR=0x%x - should be 0. Is target device TC74?",
+                        cfg, cfg & APP_TC74_CONFIG_ZERO_MASK, sensor->address);
+                // do not poll it anymore
+                sensor->state = APP_TC74_STATE_ABSENT;
+                break;
+            default:
+                APP_TC74_ERROR_PRINT("I2C Read from TC74 at ADDR=0x%x failed (%u errors). i2cEvent=%d",
+                        sensor->address, sensor->errors, sensor->i2cEvent);
+                break;
+        }
+    }
+    if (temps != 0){
+        appData.iter++;
+        for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+            APP_TC74_SENSOR *sensor = &appData.sensors[i];
+            if (sensor->state != APP_TC74_STATE_ABSENT
+                    && sensor->result == APP_TC74_RESULT_TEMP){
+#if APP_TELEMETRY
+                APP_TC74_TelemetrySend(sensor, appData.sampleTime);
+#else
+                APP_TC74_PRINT("#%u ADDR=0x%x Temp=%d Celsius (raw=0x%X)",
+                        appData.iter, sensor->address, sensor->temp, sensor->rxData[0]);
+#endif
+            }
+        }
+    }
+    return temps;
+}
+
+// returns DRV_I2C client for clockSpeed, opens new one when needed
+static DRV_HANDLE APP_I2CClientGet(uint32_t clockSpeed)
+{
+    DRV_I2C_TRANSFER_SETUP setup;
+    DRV_HANDLE h;
+    unsigned i;
+
+    for(i=0; i < appData.drvI2CClients; i++){
+        if (appData.drvI2CClockSpeeds[i] == clockSpeed){
+            return appData.drvI2CHandles[i];
+        }
+    }
+    if (appData.drvI2CClients == DRV_I2C_CLIENTS_NUMBER_IDX0){
+        // increase DRV_I2C_CLIENTS_NUMBER_IDX0 in MCC
+        return DRV_HANDLE_INVALID;
+    }
+    h = DRV_I2C_Open(DRV_I2C_INDEX_0, DRV_IO_INTENT_READWRITE);
+    if (h == DRV_HANDLE_INVALID){
+        return h;
+    }
+    setup.clockSpeed = clockSpeed;
+    if (!DRV_I2C_TransferSetup(h, &setup)){
+        DRV_I2C_Close(h);
+        return DRV_HANDLE_INVALID;
+    }
+    /* Register the I2C Driver event Handler */
+    DRV_I2C_TransferEventHandlerSet(h, APP_I2CEventHandler, 0);
+    appData.drvI2CHandles[appData.drvI2CClients] = h;
+    appData.drvI2CClockSpeeds[appData.drvI2CClients] = clockSpeed;
+    appData.drvI2CClients++;
+    return h;
+}
+
+// fill appData.pumpOrder with sensors sorted by clockSpeed (stable)
+static void APP_TC74_PumpOrderInit(void)
+{
+    unsigned i, j;
+
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        uint8_t s = i;
+        for(j=i; j > 0 && appData.sensors[appData.pumpOrder[j-1]].clockSpeed
+                > appData.sensors[s].clockSpeed; j--){
+            appData.pumpOrder[j] = appData.pumpOrder[j-1];
+        }
+        appData.pumpOrder[j] = s;
+    }
+    appData.pumpNext = 0;
+}
+
+// number of sensors that responded to probe
+static unsigned APP_TC74_PresentCount(void)
+{
+    unsigned i;
+    unsigned n = 0;
+
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        if (appData.sensors[i].state != APP_TC74_STATE_ABSENT){
+            n++;
+        }
+    }
+    return n;
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Initialization and State Machine Functions
@@ -173,19 +780,109 @@ void APP_I2CEventHandler (
 
 void APP_Initialize ( void )
 {
+    unsigned i;
+
     // NOTE: Only data should be initialized here, because it is called
     // very early from initialization.c!
     // Do not attempt to call API from here!
     appData.state = APP_STATE_INIT;
     appData.ledTimerHandle = SYS_TIME_HANDLE_INVALID;
-    appData.drvI2CHandle = DRV_HANDLE_INVALID;
+    appData.drvI2CClients = 0;
+    appData.batchHandle = DRV_I2C_TRANSFER_HANDLE_INVALID;
     appData.pauseTimer = SYS_TIME_HANDLE_INVALID;
-    appData.transferHandle = DRV_I2C_TRANSFER_HANDLE_INVALID;
-    appData.transferStatus = APP_TRANSFER_STATUS_ERROR;
-    appData.rxData[0] = 0;
-    appData.txData[0] = 0;
-    appData.txData[1] = 0;
+    appData.periodUs = APP_SAMPLE_PERIOD_US;
+    for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+        APP_TC74_SENSOR *sensor = &appData.sensors[i];
+        sensor->address = APP_TC74_SLAVE_ADDR_A0 + i;
+        sensor->clockSpeed = appTc74ClockSpeeds[i];
+        sensor->drvI2CHandle = DRV_HANDLE_INVALID;
+        sensor->state = APP_TC74_STATE_ABSENT;
+        sensor->result = APP_TC74_RESULT_NONE;
+        sensor->transferHandle = DRV_I2C_TRANSFER_HANDLE_INVALID;
+        sensor->oldConfig = ~0;
+        sensor->pointer = APP_TC74_REG_UNKNOWN;
+        sensor->fastPath = false;
+        sensor->scansSinceConfig = 0;
+        sensor->errors = 0;
+        sensor->anomalies = 0;
+    }
+    appData.sensorsPending = 0;
+    appData.transfersInFlight = 0;
+    appData.pumpNext = 0;
     appData.iter = 0;
+    appData.sensorsOff = 0;
+    appData.sensorsProbe = 0;
+    appData.sensorsProbing = 0;
+}
+
+bool APP_SamplePeriodSet(uint32_t us)
+{
+    if (us < APP_MINIMUM_PAUSE_US){
+        return false;
+    }
+    appData.periodUs = us;
+    return true;
+}
+
+uint32_t APP_SamplePeriodGet(void)
+{
+    return appData.periodUs;
+}
+
+bool APP_SensorEnable(uint8_t address, bool enable)
+{
+    unsigned i = address - APP_TC74_SLAVE_ADDR_A0;
+    uint32_t bit;
+    unsigned polled = 0;
+    unsigned j;
+
+    if (address < APP_TC74_SLAVE_ADDR_A0 || i >= APP_TC74_SENSORS_MAX){
+        return false;
+    }
+    bit = 1u << i;
+    if (enable){
+        appData.sensorsOff &= ~bit;
+        appData.sensorsProbe |= bit;
+        return true;
+    }
+    // without any sensor the application halts
+    for(j=0; j < APP_TC74_SENSORS_MAX; j++){
+        if (appData.sensors[j].state != APP_TC74_STATE_ABSENT
+                && (appData.sensorsOff & (1u << j)) == 0 && j != i){
+            polled++;
+        }
+    }
+    if (polled == 0){
+        return false;
+    }
+    appData.sensorsProbe &= ~bit;
+    appData.sensorsOff |= bit;
+    return true;
+}
+
+const APP_TC74_SENSOR* APP_SensorGet(unsigned index)
+{
+    return (index < APP_TC74_SENSORS_MAX) ? &appData.sensors[index] : NULL;
+}
+
+uint32_t APP_SampleCountGet(void)
+{
+    return appData.iter;
+}
+
+bool APP_SampleSoon(uint32_t us)
+{
+    switch (appData.state){
+        case APP_STATE_PAUSE_NEXT:
+            return SYS_TIME_Counter64Get() + SYS_TIME_USToCount(us) >= appData.pauseEnd;
+        case APP_STATE_I2C_PROBE_WAIT:
+        case APP_STATE_I2C_SCAN:
+        case APP_STATE_I2C_SCAN_WAIT:
+        case APP_STATE_PAUSE:
+            return true;
+        default:
+            return false;
+    }
 }
 
 /******************************************************************************
@@ -204,12 +901,25 @@ void APP_Tasks ( void )
         /* Application's initial state. */
         case APP_STATE_INIT:
         {
+            // the banner goes out at the final console rate
+            if (!APP_BAUD_Ready())
+            {
+                break;
+            }
             APP_CONSOLE_PRINT_RAW("\r\n");
             APP_CONSOLE_PRINT("Starting app v%d.%02d",
                     APP_VERSION/100,APP_VERSION%100);
+#if APP_TELEMETRY
+            {
+                uint8_t payload[APP_TELEMETRY_PAYLOAD_MAX];
+
+                APP_LOG_FrameWrite(payload, APP_TELEMETRY_InfoPack(payload,
+                        APP_VERSION, SYS_TIME_FrequencyGet()));
+            }
+#endif
             
             APP_CHECK_ERROR(appData.ledTimerHandle,
-                    SYS_TIME_CallbackRegisterMS(Timer1_Callback,
+                    SYS_TIME_CallbackRegisterDeferredMS(Timer1_Callback,
                         0, LED_BLINK_RATE_MS, SYS_TIME_PERIODIC),
                     SYS_TIME_HANDLE_INVALID,InitErrorJump);
             
@@ -221,194 +931,106 @@ void APP_Tasks ( void )
 
         case APP_STATE_INIT_I2C:
         {
-            APP_CHECK_ERROR(appData.drvI2CHandle,
-                    DRV_I2C_Open(DRV_I2C_INDEX_0, DRV_IO_INTENT_READWRITE),
-                    DRV_HANDLE_INVALID, InitI2cErrorJump);
-            
-            appData.transferStatus = APP_TRANSFER_STATUS_IDLE;
-            /* Register the I2C Driver event Handler */
-            DRV_I2C_TransferEventHandlerSet(
-                appData.drvI2CHandle,
-                APP_I2CEventHandler,
-                (uintptr_t)&appData.transferStatus
-            );
-
-            APP_CHECK_ERROR_VOID(appData.transferHandle,
-                DRV_I2C_ReadTransferAdd(
-                    appData.drvI2CHandle, APP_TC74_SLAVE_ADDR,
-                    (void *)appData.rxData, 1, &appData.transferHandle),
-                DRV_I2C_TRANSFER_HANDLE_INVALID, InitI2cErrorJump);
-            appData.state = APP_STATE_I2C_TEST_READ;
+            unsigned i;
+            for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+                APP_TC74_SENSOR *sensor = &appData.sensors[i];
+                APP_CHECK_ERROR(sensor->drvI2CHandle,
+                        APP_I2CClientGet(sensor->clockSpeed),
+                        DRV_HANDLE_INVALID, InitI2cErrorJump);
+            }
+            APP_TC74_PumpOrderInit();
+
+            // test which TC74 addresses respond
+            APP_TC74_ScanStart(APP_TC74_STATE_PROBE);
+            appData.state = APP_STATE_I2C_PROBE_WAIT;
             // here jumps APP_CHECK_ERROR() macro in case of error:
             InitI2cErrorJump:;
         }
         break;
 
-        case APP_STATE_I2C_TEST_READ:
+        case APP_STATE_I2C_PROBE_WAIT:
         {
-            // test if any I2C device responds with TC74 slave address
-            // read should be non-destructive for all I2C devices.
-            if(appData.transferStatus == APP_TRANSFER_STATUS_SUCCESS){
-                APP_CONSOLE_PRINT("OK: I2C ACK response from dev at ADDR=0x%x. Data=0x%x",
-                        APP_TC74_SLAVE_ADDR, appData.rxData[0]);
-                appData.state = APP_STATE_I2C_QUERY_CONFIG;
-            } else if (appData.transferStatus == APP_TRANSFER_STATUS_ERROR){
-                APP_ERROR_PRINT_AND_JUMP(I2cTestReadErrorJump,
-                        "I2C Read from ADDR=0x%x failed. Is TC74 connected? i2cEvent=%d",
-                        APP_TC74_SLAVE_ADDR, appData.i2cEvent);
-            } else {
-                // other states: transfer in progress, do nothing...
+            unsigned i;
+            if (appData.sensorsPending != 0){
+                // transfers in progress, do nothing...
+                break;
             }
-            I2cTestReadErrorJump:;
-        }
-        break;
-
-        case APP_STATE_I2C_QUERY_CONFIG:
-        {
-            // select and query CONFIG register to know if TC74 is Up and
-            // and Ready to read TEMPerature
-            appData.txData[0] = APP_TC74_REG_CONFIG; // register we want to select
-            appData.rxData[0] = 0; // clean read buffer
-            appData.transferStatus = APP_TRANSFER_STATUS_IDLE;
-            APP_CHECK_ERROR_VOID(appData.transferHandle,
-                DRV_I2C_WriteReadTransferAdd(appData.drvI2CHandle, APP_TC74_SLAVE_ADDR,
-                    appData.txData, 1, appData.rxData, 1,&appData.transferHandle),
-                DRV_I2C_TRANSFER_HANDLE_INVALID, I2cQueryConfigErrorJump);
-            appData.state = APP_STATE_I2C_QUERY_CONFIG_READ;
-            I2cQueryConfigErrorJump:;
-        }
-        break;
-
-        case APP_STATE_I2C_QUERY_CONFIG_READ:
-        {
-            static uint8_t oldCfg = ~0;
-            // test if CONFIG register was read without error
-            if(appData.transferStatus == APP_TRANSFER_STATUS_SUCCESS){
-                uint8_t cfg = appData.rxData[0];
-                if (cfg != oldCfg){
-                    APP_CONSOLE_PRINT("Data from TC74 at ADDR=0x%x: CONFIG=0x%x %s %s zero mask: 0x%x",
-                            APP_TC74_SLAVE_ADDR, cfg,
-                            cfg & APP_TC74_CONFIG_STANDBY_MASK ? "STANDBY" : "UP",
-                            cfg & APP_TC74_CONFIG_READY_MASK ? "READY" : "BUSY",
-                            cfg & APP_TC74_CONFIG_ZERO_MASK);
-                    oldCfg = cfg;
+            for(i=0; i < APP_TC74_SENSORS_MAX; i++){
+                APP_TC74_SENSOR *sensor = &appData.sensors[i];
+                if (sensor->state != APP_TC74_STATE_ABSENT){
+                    APP_CONSOLE_PRINT("OK: I2C ACK response from dev at ADDR=0x%x. Data=0x%x",
+                            sensor->address, sensor->rxData[0]);
                 }
-                if (cfg & APP_TC74_CONFIG_ZERO_MASK){
-                APP_ERROR_PRINT_AND_JUMP(I2cQueryConfigReadErrorJump,
-                        "Invalid CONFIG=0x%x LSB bits==0x%x - should be 0. Is target device TC74?",
-                        cfg, cfg & APP_TC74_CONFIG_ZERO_MASK);
-                }
-                if ( (cfg & APP_TC74_CONFIG_STATUS_MASK) == APP_TC74_CONFIG_READY_MASK ){
-                    appData.state = APP_STATE_I2C_QUERY_TEMP;
-                } else if (cfg & APP_TC74_CONFIG_STANDBY_MASK){
-                    appData.state = APP_STATE_I2C_WAKEUP_TC74;
-                } else if ((cfg & APP_TC74_CONFIG_READY_MASK)==0){
-                    appData.state = APP_STATE_I2C_BUSY_TC74;
-                } else {
-                    APP_ERROR_PRINT_AND_JUMP(I2cQueryConfigReadErrorJump,
-                        "Unexpected Config state=0x%x CONFIG=0x%x - INERNAL ERROR",
-                        cfg & APP_TC74_CONFIG_STATUS_MASK, cfg);
-                }
-            } else if (appData.transferStatus == APP_TRANSFER_STATUS_ERROR){
-                APP_ERROR_PRINT_AND_JUMP(I2cQueryConfigReadErrorJump,
-                        "I2C Read CONFIG from ADDR=0x%x failed. Is target device TC74? i2cEvent=%d",
-                        APP_TC74_SLAVE_ADDR, appData.i2cEvent);
-            } else {
-                // other states: transfer in progress, do nothing...
             }
-            I2cQueryConfigReadErrorJump:;
+            if (APP_TC74_PresentCount() == 0){
+                APP_ERROR_PRINT_AND_JUMP(I2cProbeErrorJump,
+                        "I2C Read from ADDR=0x%x..0x%x failed. Is TC74 connected?",
+                        APP_TC74_SLAVE_ADDR_A0, APP_TC74_SLAVE_ADDR_A0 + APP_TC74_SENSORS_MAX - 1);
+            }
+            APP_SCHED_Start(SYS_TIME_Counter64Get());
+            appData.onSchedule = true;
+            appData.state = APP_STATE_I2C_SCAN;
+            I2cProbeErrorJump:;
         }
         break;
 
-        case APP_STATE_I2C_WAKEUP_TC74:
+        case APP_STATE_I2C_SCAN:
         {
-            appData.txData[0] = APP_TC74_REG_CONFIG; // register we want to select
-            appData.txData[1] = 0; // clean SHUTDOWN bit;
-            appData.transferStatus = APP_TRANSFER_STATUS_IDLE;
-            APP_CHECK_ERROR_VOID(appData.transferHandle,
-                DRV_I2C_WriteTransferAdd(appData.drvI2CHandle, APP_TC74_SLAVE_ADDR,
-                    appData.txData, 2,&appData.transferHandle),
-                DRV_I2C_TRANSFER_HANDLE_INVALID, I2cWakeUpErrorJump);
-            appData.state = APP_STATE_I2C_WAKEUP_TC74_NEXT;
-            I2cWakeUpErrorJump:;
+            // CONFIG then TEMP (only TEMP on fast path) of all sensors,
+            // pipelined in DRV_I2C queue
+            // timestamp of the sample, taken before the scan is queued
+            appData.sampleTime = SYS_TIME_Counter64Get();
+            APP_TC74_RequestsApply();
+            APP_TC74_ScanStart(APP_TC74_STATE_QUERY_CONFIG);
+            if (appData.onSchedule){
+                APP_SCHED_Started(appData.sampleTime);
+            }
+            appData.state = APP_STATE_I2C_SCAN_WAIT;
         }
         break;
 
-        case APP_STATE_I2C_WAKEUP_TC74_NEXT:
+        case APP_STATE_I2C_SCAN_WAIT:
         {
-            if(appData.transferStatus == APP_TRANSFER_STATUS_SUCCESS){
-                appData.pauseUs = 3000000;
-                appData.state = APP_STATE_PAUSE;
-                APP_CONSOLE_PRINT("TC74 Waking Up!: waiting 300ms before retry.");
-            } else if (appData.transferStatus == APP_TRANSFER_STATUS_ERROR){
-                APP_ERROR_PRINT_AND_JUMP(I2cWakeUpNexErrorJump,
-                        "Writing CONFIG register at ADDR=0x%x failed. i2cEvent=%d",
-                        APP_TC74_SLAVE_ADDR, appData.i2cEvent);
+            bool retry;
+            if (appData.sensorsPending != 0){
+                // transfers in progress, do nothing...
+                break;
+            }
+            // Wait and measure again: a retry after APP_TC74_RETRY_US,
+            // otherwise at the next deadline of the schedule
+            if (APP_TC74_ScanReport(&retry) == 0 && retry){
+                appData.pauseEnd = SYS_TIME_Counter64Get() + SYS_TIME_USToCount(APP_TC74_RETRY_US);
+                appData.onSchedule = false;
             } else {
-                // other states: transfer in progress, do nothing...
+                appData.pauseEnd = APP_SCHED_Next(SYS_TIME_Counter64Get(),
+                        (uint64_t)appData.periodUs * SYS_TIME_FrequencyGet() / 1000000u);
+                appData.onSchedule = true;
             }
-            I2cWakeUpNexErrorJump:;
-        }
-        break;
-
-        case APP_STATE_I2C_BUSY_TC74:
-        {
-            // maximum busy time should be 250ms, we will wait 300ms and try again
-            appData.pauseUs = 3000000;
             appData.state = APP_STATE_PAUSE;
-            APP_CONSOLE_PRINT("TC74 busy: waiting 300ms before retry.");
-        }
-        break;
-        
-        case APP_STATE_I2C_QUERY_TEMP:
-        {
-            // select and query TEMPERATURE register to get current temperature
-            appData.txData[0] = APP_TC74_REG_TEMP; // register we want to select
-            appData.rxData[0] = 0; // clean read buffer
-            appData.transferStatus = APP_TRANSFER_STATUS_IDLE;
-            APP_CHECK_ERROR_VOID(appData.transferHandle,
-                DRV_I2C_WriteReadTransferAdd(appData.drvI2CHandle, APP_TC74_SLAVE_ADDR,
-                    appData.txData, 1, appData.rxData, 1,&appData.transferHandle),
-                DRV_I2C_TRANSFER_HANDLE_INVALID, I2cQueryTempErrorJump);
-            appData.state = APP_STATE_I2C_QUERY_TEMP_READ;
-            I2cQueryTempErrorJump:;
-        }
-        break;
-
-        case APP_STATE_I2C_QUERY_TEMP_READ:
-        {
-            // test if CONFIG register was read without error
-            if(appData.transferStatus == APP_TRANSFER_STATUS_SUCCESS){
-                // temperature is signed !
-                int8_t temp = (int8_t)appData.rxData[0];
-                appData.iter++;
-                APP_CONSOLE_PRINT("#%u Temp=%d Celsius (raw=0x%X)",
-                        appData.iter, temp, appData.rxData[0]);
-                // Wait and measure again
-                appData.pauseUs = 2000000;
-                appData.state = APP_STATE_PAUSE;
-            } else if (appData.transferStatus == APP_TRANSFER_STATUS_ERROR){
-                APP_ERROR_PRINT_AND_JUMP(I2cQueryTempReadErrorJump,
-                        "I2C Read TEMP from ADDR=0x%x failed. Is target device TC74? i2cEvent=%d",
-                        APP_TC74_SLAVE_ADDR, appData.i2cEvent);
-            } else {
-                // other states: transfer in progress, do nothing...
+            if (APP_TC74_PresentCount() == 0){
+                APP_ERROR_PRINT_AND_STATE("No TC74 left to poll.");
             }
-            I2cQueryTempReadErrorJump:;
         }
         break;
 
         case APP_STATE_PAUSE:
         {
             SYS_TIME_RESULT res;
-            if (appData.pauseUs < APP_MINIMUM_PAUSE_US){
-                APP_ERROR_PRINT_AND_JUMP(PauseErrorJump,
-                    "Invalid app.pauseUs=%u must be >= %u - INTERNAL ERROR",
-                    appData.pauseUs, APP_MINIMUM_PAUSE_US);
+            uint64_t now = SYS_TIME_Counter64Get();
+            uint64_t left = (appData.pauseEnd > now) ? appData.pauseEnd - now : 0u;
+
+            if (left == 0u){
+                // the deadline has passed already
+                appData.state = APP_STATE_I2C_SCAN;
+                break;
             }
+            appData.pauseLong = left > SYS_TIME_USToCount(APP_PAUSE_MAX_US);
+            // rounded up, the scan never starts before its deadline
+            appData.pauseUs = appData.pauseLong ? APP_PAUSE_MAX_US
+                    : SYS_TIME_CountToUS((uint32_t)left) + 1u;
             APP_CHECK_ERROR_NEQ(res,
                 SYS_TIME_DelayUS(appData.pauseUs, &appData.pauseTimer),
-                SYS_TIME_SUCCESS,I2cQueryTempReadErrorJump);
+                SYS_TIME_SUCCESS,PauseErrorJump);
             appData.state = APP_STATE_PAUSE_NEXT;
             PauseErrorJump:;
         }
@@ -417,7 +1039,7 @@ void APP_Tasks ( void )
         case APP_STATE_PAUSE_NEXT:
         {
             if (SYS_TIME_DelayIsComplete(appData.pauseTimer)){
-                appData.state = APP_STATE_I2C_QUERY_CONFIG;
+                appData.state = appData.pauseLong ? APP_STATE_PAUSE : APP_STATE_I2C_SCAN;
             }
         }
         break;
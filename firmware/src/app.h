@@ -34,6 +34,11 @@
 #include <inttypes.h>
 #include "configuration.h"
 #include "definitions.h"
+#include "app_log.h"
+#include "app_baud.h"
+#include "app_shell.h"
+#include "app_telemetry.h"
+#include "app_sched.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -61,33 +66,77 @@ extern "C" {
 */
 
 // harmony-repo\core_apps_pic32mx\apps\driver\i2c\async\i2c_eeprom\firmware\src\app.h    
-typedef enum
-{
-    APP_TRANSFER_STATUS_IN_PROGRESS,
-    APP_TRANSFER_STATUS_SUCCESS,
-    APP_TRANSFER_STATUS_ERROR,
-    APP_TRANSFER_STATUS_IDLE,
-} APP_TRANSFER_STATUS;    
-    
 typedef enum
 {
     /* Application's state machine's initial state. */
     APP_STATE_INIT=0,
     APP_STATE_INIT_I2C,
-    APP_STATE_I2C_TEST_READ,
-    APP_STATE_I2C_QUERY_CONFIG,
-    APP_STATE_I2C_QUERY_CONFIG_READ,
-    APP_STATE_I2C_WAKEUP_TC74,
-    APP_STATE_I2C_WAKEUP_TC74_NEXT,
-    APP_STATE_I2C_BUSY_TC74,
-    APP_STATE_I2C_QUERY_TEMP,
-    APP_STATE_I2C_QUERY_TEMP_READ,
+    APP_STATE_I2C_PROBE_WAIT,
+    APP_STATE_I2C_SCAN,
+    APP_STATE_I2C_SCAN_WAIT,
     APP_STATE_PAUSE,
     APP_STATE_PAUSE_NEXT,
     APP_STATE_SERVICE_TASKS,
     APP_STATE_FATAL_ERROR=9999
 } APP_STATES;
 
+// number of TC74 addresses probed: TC74A0..TC74A7 = 0x48..0x4F
+#define APP_TC74_SENSORS_MAX 8
+
+// state of one sensor within a scan, changed from the I2C callback (ISR)
+typedef enum
+{
+    APP_TC74_STATE_ABSENT=0,     // did not respond to probe, never polled
+    APP_TC74_STATE_IDLE,         // nothing to do until the next scan
+    APP_TC74_STATE_PROBE,        // transfer waiting for a free DRV_I2C queue slot
+    APP_TC74_STATE_QUERY_CONFIG, // -"-
+    APP_TC74_STATE_WAKEUP,       // -"-
+    APP_TC74_STATE_QUERY_TEMP,   // -"-
+    APP_TC74_STATE_IN_PROGRESS,  // transfer queued in DRV_I2C
+} APP_TC74_STATE;
+
+// outcome of the last scan of one sensor
+typedef enum
+{
+    APP_TC74_RESULT_NONE=0,
+    APP_TC74_RESULT_TEMP,        // temperature was read
+    APP_TC74_RESULT_BUSY,        // CONFIG: up but no DATA_RDY yet
+    APP_TC74_RESULT_WAKEUP,      // CONFIG: standby, SHDN was cleared
+    APP_TC74_RESULT_NOT_TC74,    // CONFIG: bits that must be 0 are set
+    APP_TC74_RESULT_ERROR,       // I2C transfer failed
+} APP_TC74_RESULT;
+
+typedef struct
+{
+    uint8_t address;
+    uint32_t clockSpeed;       // I2C clock of this sensor
+    DRV_HANDLE drvI2CHandle;   // client opened for clockSpeed
+    volatile APP_TC74_STATE state;
+    // which state queued the transfer that is in progress
+    APP_TC74_STATE op;
+    volatile APP_TC74_RESULT result;
+    volatile DRV_I2C_TRANSFER_EVENT i2cEvent;
+    DRV_I2C_TRANSFER_HANDLE transferHandle;
+    uint8_t rxData[1]; // we always read only 1 byte
+    uint8_t txData[2]; // we always write 2 bytes - 1. Register, 2. Value
+    // register pointer of TC74 (kept between transactions), APP_TC74_REG_UNKNOWN
+    // after power-up or any failed transfer
+    uint8_t pointer;
+    // pointer after the transfer in progress completes successfully
+    uint8_t pointerNext;
+    uint8_t config;    // last CONFIG value
+    uint8_t oldConfig; // last reported CONFIG value
+    int8_t temp;       // last temperature in Celsius
+    // fast path: READY was seen, scans read only TEMP
+    volatile bool fastPath;
+    // CONFIG was read in current scan, so TEMP needs no plausibility check
+    volatile bool configThisScan;
+    // fast path TEMP jumped too much, CONFIG was re-read
+    volatile bool anomaly;
+    uint32_t scansSinceConfig;
+    uint32_t errors;
+    uint32_t anomalies;
+} APP_TC74_SENSOR;
 
 // *****************************************************************************
 /* Application Data
@@ -107,17 +156,45 @@ typedef struct
     /* The application's current state */
     APP_STATES state;
     SYS_TIME_HANDLE ledTimerHandle;
-    DRV_HANDLE drvI2CHandle;
-    DRV_I2C_TRANSFER_HANDLE transferHandle;
+    // one DRV_I2C client per I2C clock speed used by sensors
+    DRV_HANDLE drvI2CHandles[DRV_I2C_CLIENTS_NUMBER_IDX0];
+    uint32_t drvI2CClockSpeeds[DRV_I2C_CLIENTS_NUMBER_IDX0];
+    uint32_t drvI2CClients;
     SYS_TIME_HANDLE pauseTimer;
-    uint32_t pauseUs; // wanted pause in micro-seconds
-    // value set from ISR, so must be volatile
-    volatile DRV_I2C_TRANSFER_EVENT i2cEvent;
-    // modified from ISR, so must be volatile:
-    volatile APP_TRANSFER_STATUS transferStatus;
-    uint8_t rxData[1]; // we always read only 1 byte
-    uint8_t txData[2]; // we always write 2 bytes - 1. Register, 2. Value
+    uint32_t pauseUs; // current delay of pauseTimer in micro-seconds
+    bool pauseLong; // pauseEnd is further than one delay, pauseTimer goes again
+    uint32_t periodUs; // period of the samples, APP_SamplePeriodSet()
+    uint64_t pauseEnd; // SYS_TIME counter at the end of the current pause
+    // the next scan is on the deadline of app_sched.h, not a retry
+    bool onSchedule;
+    uint64_t sampleTime; // SYS_TIME counter at the start of the current scan
+    APP_TC74_SENSOR sensors[APP_TC74_SENSORS_MAX];
+    // sensors that did not finish current probe/scan, modified from ISR
+    volatile uint32_t sensorsPending;
+    // transfers queued in DRV_I2C by us, modified from ISR
+    volatile uint32_t transfersInFlight;
+    // round-robin start for APP_TC74_Pump(), index to pumpOrder
+    uint32_t pumpNext;
+    // sensors sorted by clockSpeed, so DRV_I2C changes bus speed only
+    // between groups
+    uint8_t pumpOrder[APP_TC74_SENSORS_MAX];
+    // TEMP reads of a scan queued as one DRV_I2C batch
+    DRV_I2C_BATCH batch;
+    DRV_I2C_BATCH_ITEM batchItems[APP_TC74_SENSORS_MAX];
+    uint8_t batchSensors[APP_TC74_SENSORS_MAX]; // sensor index of each item
+    volatile DRV_I2C_TRANSFER_HANDLE batchHandle;
+    // batch statistics, bus and gap time in core timer ticks
+    uint32_t batches;
+    uint32_t batchItemsDone;
+    uint64_t batchBusTicks;
+    uint64_t batchGapTicks;
     uint32_t iter; // measurement iteration
+    // sensors (bit = index) to stop polling or to probe, APP_SensorEnable().
+    // Applied when the next scan starts.
+    uint32_t sensorsOff;
+    uint32_t sensorsProbe;
+    // sensors probed in the current scan
+    uint32_t sensorsProbing;
 } APP_DATA;
 
 // *****************************************************************************
@@ -200,6 +277,29 @@ void APP_Initialize ( void );
 
 void APP_Tasks( void );
 
+// Run-time settings, for the console shell (app_shell.h). They take effect
+// at the next pause or scan, never during a scan.
+
+// period of the samples, false below the 1 ms minimum
+bool APP_SamplePeriodSet(uint32_t us);
+uint32_t APP_SamplePeriodGet(void);
+
+/* Stops polling the TC74 at address, or probes it at the next scan and polls
+   it from then on when it answers. False when address is not 0x48..0x4F or
+   when it is the last sensor polled. */
+bool APP_SensorEnable(uint8_t address, bool enable);
+
+// sensor of index 0 .. APP_TC74_SENSORS_MAX - 1, NULL above
+const APP_TC74_SENSOR* APP_SensorGet(unsigned index);
+
+// samples taken so far
+uint32_t APP_SampleCountGet(void);
+
+/* True while a scan is running or the next one starts within us. Work that
+   may take longer than a SYS_Tasks() round waits, so that it neither delays
+   the start of a sample nor its completion. */
+bool APP_SampleSoon(uint32_t us);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
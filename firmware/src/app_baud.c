@@ -0,0 +1,267 @@
+/*******************************************************************************
+  Console Rate
+
+  File Name:
+    app_baud.c
+
+  Summary:
+    Start-up rate, auto-baud and negotiated rate switch of the UART2 console
+    (see app_baud.h).
+*******************************************************************************/
+
+#include "definitions.h"
+#include "app_baud.h"
+#include "app_log.h"
+
+// rates a host may ask for, with PBCLK = 48 MHz all within 0.2%
+static const uint32_t appBaudRates[] =
+{
+    9600u, 19200u, 38400u, 57600u, 115200u, 230400u, 460800u, 921600u,
+    1000000u, 1500000u, 2000000u, 3000000u
+};
+
+typedef enum
+{
+    APP_BAUD_STATE_START = 0,   // first call, sets APP_BAUD_RATE or starts auto-baud
+    APP_BAUD_STATE_AUTOBAUD,    // UART2 measures the host's 0x55
+    APP_BAUD_STATE_IDLE,        // waits for APP_BAUD_Request()
+    APP_BAUD_STATE_ACK,         // answers once the deferred log has stopped
+    APP_BAUD_STATE_DRAIN,       // waits for the answer to leave the TX buffer
+    APP_BAUD_STATE_CONFIRM,     // new rate set, waits for the host's 0x55
+} APP_BAUD_STATE;
+
+typedef struct
+{
+    APP_BAUD_STATE state;
+    bool autobaud;              // in the start-up auto-baud phase
+    uint32_t oldRate;           // restored when the host does not confirm
+    uint32_t newRate;
+    uint64_t deadline;          // SYS_TIME counter, of DRAIN and CONFIRM
+    uint64_t autobaudEnd;
+    APP_BAUD_STATS stats;
+} APP_BAUD_DATA;
+
+static APP_BAUD_DATA appBaud;
+
+static bool APP_BAUD_Supported(uint32_t baud)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(appBaudRates) / sizeof(appBaudRates[0]); i++)
+    {
+        if (appBaudRates[i] == baud)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool APP_BAUD_Set(uint32_t baud)
+{
+    UART_SERIAL_SETUP setup =
+    {
+        .baudRate = baud,
+        .parity = UART_PARITY_NONE,
+        .dataWidth = UART_DATA_8_BIT,
+        .stopBits = UART_STOP_1_BIT,
+    };
+
+    return UART2_SerialSetup(&setup, 0U);
+}
+
+static uint64_t APP_BAUD_DeadlineGet(uint32_t ms)
+{
+    return SYS_TIME_Counter64Get() + SYS_TIME_MSToCount(ms);
+}
+
+static bool APP_BAUD_Expired(uint64_t deadline)
+{
+    return SYS_TIME_Counter64Get() >= deadline;
+}
+
+// drops what arrived while the rate was changing, and its errors
+static void APP_BAUD_RxFlush(void)
+{
+    uint8_t c;
+
+    while (UART2_Read(&c, 1U) != 0U)
+    {
+    }
+    (void)UART2_ErrorGet();
+}
+
+static void APP_BAUD_AutobaudStart(void)
+{
+    // also cancels a measurement still pending
+    (void)APP_BAUD_Set(APP_BAUD_RATE);
+    APP_BAUD_RxFlush();
+    UART2_AutoBaudSet(true);
+    appBaud.state = APP_BAUD_STATE_AUTOBAUD;
+}
+
+static void APP_BAUD_ConfirmStart(void)
+{
+    APP_BAUD_RxFlush();
+    appBaud.deadline = APP_BAUD_DeadlineGet(APP_BAUD_CONFIRM_MS);
+    appBaud.state = APP_BAUD_STATE_CONFIRM;
+}
+
+static void APP_BAUD_Release(void)
+{
+    appBaud.state = APP_BAUD_STATE_IDLE;
+    APP_LOG_Hold(false);
+}
+
+static void APP_BAUD_Finish(bool confirmed)
+{
+    if (confirmed)
+    {
+        appBaud.stats.switches++;
+        appBaud.autobaud = false;
+        SYS_CONSOLE_PRINT("baud: %lu ok\r\n", (unsigned long)appBaud.newRate);
+        APP_BAUD_Release();
+        return;
+    }
+    appBaud.stats.failures++;
+    if (appBaud.autobaud && !APP_BAUD_Expired(appBaud.autobaudEnd))
+    {
+        // the host tries its next rate
+        APP_BAUD_AutobaudStart();
+        return;
+    }
+    (void)APP_BAUD_Set(appBaud.oldRate);
+    APP_BAUD_RxFlush();
+    if (!appBaud.autobaud)
+    {
+        SYS_CONSOLE_PRINT("baud: %lu failed\r\n", (unsigned long)appBaud.newRate);
+    }
+    appBaud.autobaud = false;
+    APP_BAUD_Release();
+}
+
+static void APP_BAUD_Start(uint32_t baud)
+{
+    appBaud.newRate = baud;
+    APP_LOG_Hold(true);
+    appBaud.state = APP_BAUD_STATE_ACK;
+}
+
+void APP_BAUD_Tasks(void)
+{
+    switch (appBaud.state)
+    {
+        case APP_BAUD_STATE_START:
+            appBaud.oldRate = APP_BAUD_RATE;
+#if APP_BAUD_AUTOBAUD
+            APP_LOG_Hold(true);
+            appBaud.autobaud = true;
+            appBaud.autobaudEnd = APP_BAUD_DeadlineGet(APP_BAUD_AUTOBAUD_MS);
+            APP_BAUD_AutobaudStart();
+#else
+            (void)APP_BAUD_Set(APP_BAUD_RATE);
+            appBaud.state = APP_BAUD_STATE_IDLE;
+#endif
+            break;
+
+        case APP_BAUD_STATE_AUTOBAUD:
+            if (!UART2_AutoBaudQuery())
+            {
+                // answered at the measured rate, the host confirms if it can read it
+                appBaud.stats.autobauds++;
+                appBaud.newRate = UART2_BaudRateGet();
+                SYS_CONSOLE_PRINT("baud: %lu\r\n", (unsigned long)appBaud.newRate);
+                APP_BAUD_ConfirmStart();
+            }
+            else if (APP_BAUD_Expired(appBaud.autobaudEnd))
+            {
+                // no host, stay at the start-up rate
+                (void)APP_BAUD_Set(APP_BAUD_RATE);
+                APP_BAUD_RxFlush();
+                appBaud.autobaud = false;
+                APP_BAUD_Release();
+            }
+            break;
+
+        case APP_BAUD_STATE_ACK:
+            if (!APP_LOG_Held())
+            {
+                break;
+            }
+            if (!APP_BAUD_Supported(appBaud.newRate))
+            {
+                SYS_CONSOLE_PRINT("baud: %lu not supported\r\n", (unsigned long)appBaud.newRate);
+                APP_BAUD_Release();
+                break;
+            }
+            appBaud.oldRate = UART2_BaudRateGet();
+            SYS_CONSOLE_PRINT("baud: %lu\r\n", (unsigned long)appBaud.newRate);
+            appBaud.deadline = APP_BAUD_DeadlineGet(APP_BAUD_DRAIN_MS);
+            appBaud.state = APP_BAUD_STATE_DRAIN;
+            break;
+
+        case APP_BAUD_STATE_DRAIN:
+            if (((UART2_WriteCountGet() != 0U) || !UART2_TransmitComplete())
+                && !APP_BAUD_Expired(appBaud.deadline))
+            {
+                break;
+            }
+            if (!APP_BAUD_Set(appBaud.newRate))
+            {
+                APP_BAUD_Finish(false);
+                break;
+            }
+            APP_BAUD_ConfirmStart();
+            break;
+
+        case APP_BAUD_STATE_CONFIRM:
+        {
+            // a character with a framing error never reaches the RX ring, the
+            // PLIB drops it and keeps the error
+            UART_ERROR errors = UART2_ErrorGet();
+            uint8_t c;
+
+            if (errors != UART_ERROR_NONE)
+            {
+                APP_BAUD_Finish(false);
+            }
+            else if (UART2_Read(&c, 1U) != 0U)
+            {
+                APP_BAUD_Finish(c == APP_BAUD_SYNC);
+            }
+            else if (APP_BAUD_Expired(appBaud.deadline))
+            {
+                APP_BAUD_Finish(false);
+            }
+            else
+            {
+                /* Nothing to do */
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+bool APP_BAUD_Ready(void)
+{
+    return appBaud.state == APP_BAUD_STATE_IDLE;
+}
+
+bool APP_BAUD_Request(uint32_t baud)
+{
+    if (appBaud.state != APP_BAUD_STATE_IDLE)
+    {
+        return false;
+    }
+    // an unsupported rate is answered in APP_BAUD_STATE_ACK
+    APP_BAUD_Start(baud);
+    return true;
+}
+
+void APP_BAUD_StatsGet(APP_BAUD_STATS* stats)
+{
+    *stats = appBaud.stats;
+}
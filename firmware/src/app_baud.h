@@ -0,0 +1,101 @@
+/*******************************************************************************
+  Console Rate Header File
+
+  File Name:
+    app_baud.h
+
+  Summary:
+    UART2 console rate: start-up rate, optional auto-baud and a rate switch
+    negotiated with the host.
+
+  Description:
+    UART2_Initialize() starts the console at 115200 Bd. APP_BAUD_Tasks(),
+    called from SYS_Tasks() before the application, then moves it to
+    APP_BAUD_RATE. With APP_BAUD_AUTOBAUD it measures the rate of the host
+    instead. UART2_SerialSetup() switches to the BRGH divider by itself
+    for the rates the 16 clock divider misses by more than 0.5%.
+
+    Rate switch, all text is plain ASCII whatever the log format. The
+    command line is read by the console shell (app_shell.h):
+
+      host:   "baud <rate>\r"             at the old rate
+      target: "baud: <rate>\r\n"          at the old rate, then the TX ring
+                                          drains and UART2 changes its rate
+      host:   0x55 ('U')                  at the new rate, within
+                                          APP_BAUD_CONFIRM_MS
+      target: "baud: <rate> ok\r\n"       at the new rate, or, without a
+              "baud: <rate> failed\r\n"   correct 0x55, at the old rate again
+
+    Only the rates of appBaudRates[] (app_baud.c) are accepted, a request for
+    any other rate is answered with "baud: <rate> not supported".
+
+    Auto-baud (APP_BAUD_AUTOBAUD 1): the host sends 0x55 at the highest rate
+    it supports. UART2 measures it (U2MODE.ABAUD) and the target answers
+    "baud: <measured rate>\r\n" at that rate. The host confirms with 0x55 as
+    above. When the measurement was wrong the host cannot read the answer
+    and sends nothing, so the target falls back to APP_BAUD_RATE and measures
+    again. The host should then try its next lower rate. After
+    APP_BAUD_AUTOBAUD_MS without success the console stays at APP_BAUD_RATE.
+
+    The deferred log (APP_LOG_Tasks()) and the application's start-up banner
+    wait while APP_BAUD_Ready() is false, so nothing is sent at a rate the
+    host is not listening on. Records queued meanwhile stay in the log ring,
+    and when it is full they are dropped and counted. With APP_LOG_DEFERRED=0
+    the messages printed directly by the application are not held back.
+*******************************************************************************/
+
+#ifndef _APP_BAUD_H
+#define _APP_BAUD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// console rate after start-up (UART2_Initialize() sets 115200)
+#ifndef APP_BAUD_RATE
+#define APP_BAUD_RATE 115200u
+#endif
+
+// 1 measures the host's rate at start-up
+#ifndef APP_BAUD_AUTOBAUD
+#define APP_BAUD_AUTOBAUD 0
+#endif
+
+// how long the start-up auto-baud phase keeps trying
+#define APP_BAUD_AUTOBAUD_MS 5000u
+// how long the host has to confirm a new rate with 0x55
+#define APP_BAUD_CONFIRM_MS 200u
+// longest wait for the TX ring to drain before the rate changes anyway
+#define APP_BAUD_DRAIN_MS 200u
+
+#define APP_BAUD_SYNC 0x55u
+
+typedef struct
+{
+    uint32_t switches;      // rate changes the host confirmed
+    uint32_t failures;      // rate changes not confirmed, the old rate was restored
+    uint32_t autobauds;     // auto-baud measurements
+} APP_BAUD_STATS;
+
+// called from SYS_Tasks() before the application tasks
+void APP_BAUD_Tasks(void);
+
+// false while the rate is being measured or changed
+bool APP_BAUD_Ready(void);
+
+// starts a rate switch (shell command "baud <rate>"), false while the rate
+// is being measured or changed. An unsupported rate gets its answer too.
+bool APP_BAUD_Request(uint32_t baud);
+
+void APP_BAUD_StatsGet(APP_BAUD_STATS* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_BAUD_H */
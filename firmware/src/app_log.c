@@ -0,0 +1,333 @@
+/*******************************************************************************
+  Deferred Log
+
+  File Name:
+    app_log.c
+
+  Summary:
+    Single producer single consumer ring of log records (see app_log.h).
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "app_log.h"
+#include "app_telemetry.h"
+
+#if (APP_LOG_RING_SIZE & (APP_LOG_RING_SIZE - 1)) != 0
+#error "APP_LOG_RING_SIZE must be a power of two"
+#endif
+
+// an encoded record must fit into the line buffer
+#if APP_LOG_DICT && (APP_LOG_LINE_SIZE < 2 + 10 * (APP_LOG_ARGS_MAX + 1))
+#error "APP_LOG_LINE_SIZE too small for a dictionary frame"
+#endif
+#if APP_LOG_LINE_SIZE < APP_TELEMETRY_FRAME_MAX
+#error "APP_LOG_LINE_SIZE too small for a telemetry frame"
+#endif
+
+#define APP_LOG_RING_MASK (APP_LOG_RING_SIZE - 1u)
+
+// The M4K is single core and executes in order, keeping the compiler from
+// moving the record stores past the index update is enough
+#define APP_LOG_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+typedef struct
+{
+    const char* fmt;
+    const char* file;
+    uint32_t timestamp;
+    uint16_t line;
+    uint8_t nArgs;      // payload size of a frame record
+    union
+    {
+        uintptr_t args[APP_LOG_ARGS_MAX];
+        uint8_t payload[APP_TELEMETRY_PAYLOAD_MAX];
+    };
+} APP_LOG_RECORD;
+
+static APP_LOG_RECORD appLogRing[APP_LOG_RING_SIZE];
+// free running, written only by the producer resp. the consumer
+static volatile uint32_t appLogHead;
+static volatile uint32_t appLogTail;
+static APP_LOG_STATS appLogStats;
+
+// record being written to the console
+static char appLogLine[APP_LOG_LINE_SIZE];
+static size_t appLogLineLen;
+static size_t appLogLinePos;
+// the last record written was a telemetry frame, the next frame needs no
+// leading delimiter
+static bool appLogFrameLast;
+// APP_LOG_Hold()
+static bool appLogHold;
+
+// reserves the next slot, NULL when the ring is full
+static APP_LOG_RECORD* APP_LOG_RecordGet(uint32_t* used)
+{
+    *used = appLogHead - appLogTail;
+    if (*used >= APP_LOG_RING_SIZE)
+    {
+        appLogStats.dropped++;
+        return NULL;
+    }
+    return &appLogRing[appLogHead & APP_LOG_RING_MASK];
+}
+
+// publishes the slot returned by APP_LOG_RecordGet()
+static void APP_LOG_RecordPut(uint32_t used)
+{
+    APP_LOG_BARRIER();
+    appLogHead = appLogHead + 1u;
+
+    appLogStats.records++;
+    if (used + 1u > appLogStats.maxUsed)
+    {
+        appLogStats.maxUsed = used + 1u;
+    }
+}
+
+void APP_LOG_Write(const char* file, uint16_t line, const char* fmt, unsigned nArgs, ...)
+{
+    uint32_t used;
+    APP_LOG_RECORD* rec = APP_LOG_RecordGet(&used);
+    va_list ap;
+    unsigned i;
+
+    if (rec == NULL)
+    {
+        return;
+    }
+    rec->fmt = fmt;
+    rec->file = file;
+    rec->timestamp = _CP0_GET_COUNT();
+    rec->line = line;
+    rec->nArgs = (uint8_t)nArgs;
+    va_start(ap, nArgs);
+    for (i = 0; i < nArgs; i++)
+    {
+        rec->args[i] = va_arg(ap, uintptr_t);
+    }
+    va_end(ap);
+    APP_LOG_RecordPut(used);
+}
+
+void APP_LOG_FrameWrite(const uint8_t* payload, size_t size)
+{
+    uint32_t used;
+    APP_LOG_RECORD* rec;
+
+    if (size > APP_TELEMETRY_PAYLOAD_MAX)
+    {
+        return;
+    }
+    rec = APP_LOG_RecordGet(&used);
+    if (rec == NULL)
+    {
+        return;
+    }
+    rec->fmt = NULL;
+    rec->timestamp = _CP0_GET_COUNT();
+    rec->nArgs = (uint8_t)size;
+    memcpy(rec->payload, payload, size);
+    APP_LOG_RecordPut(used);
+}
+
+#if APP_LOG_DICT
+
+static uint8_t* APP_LOG_Varint(uint8_t* p, uintptr_t value)
+{
+    while (value >= 0x80u)
+    {
+        *p++ = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+// the format string is not in memory, its address is the dictionary ID
+static size_t APP_LOG_Format(const APP_LOG_RECORD* rec)
+{
+    uint8_t* p = (uint8_t*)appLogLine;
+    unsigned i;
+
+    *p++ = (uint8_t)(APP_LOG_DICT_FRAME | rec->nArgs);
+    p = APP_LOG_Varint(p, (uintptr_t)rec->fmt);
+    for (i = 0; i < rec->nArgs; i++)
+    {
+        p = APP_LOG_Varint(p, rec->args[i]);
+    }
+    return (size_t)(p - (uint8_t*)appLogLine);
+}
+
+#else
+
+static size_t APP_LOG_Snprintf(char* buf, size_t size, const char* fmt, ...)
+{
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    // same formatter as SYS_CONSOLE_Print(), see configuration.h
+#if SYS_CONSOLE_PRINT_LITE
+    len = SYS_CONSOLE_Vsnprintf(buf, size, fmt, ap);
+#else
+    len = vsnprintf(buf, size, fmt, ap);
+#endif
+    va_end(ap);
+    if (len < 0)
+    {
+        return 0;
+    }
+    return ((size_t)len < size) ? (size_t)len : size - 1u;
+}
+
+static size_t APP_LOG_Format(const APP_LOG_RECORD* rec)
+{
+    const uintptr_t* a = rec->args;
+
+    // arguments past nArgs are stale, the format does not consume them
+    if (rec->file != NULL)
+    {
+        return APP_LOG_Snprintf(appLogLine, sizeof(appLogLine), rec->fmt, rec->file,
+                                (int)rec->line, a[0], a[1], a[2], a[3], a[4], a[5]);
+    }
+    return APP_LOG_Snprintf(appLogLine, sizeof(appLogLine), rec->fmt,
+                            a[0], a[1], a[2], a[3], a[4], a[5]);
+}
+
+#if SYS_CONSOLE_PRINT_ZERO_COPY
+
+static int APP_LOG_SpanPrintf(char* data[2], size_t size[2], const char* fmt, ...)
+{
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = SYS_CONSOLE_VsnprintfSpan(data, size, fmt, ap);
+    va_end(ap);
+    return len;
+}
+
+// formats straight into the UART2 TX ring, false when the line does not fit
+// (it then goes through appLogLine and is written as the ring drains)
+static bool APP_LOG_FormatInPlace(const APP_LOG_RECORD* rec)
+{
+    const uintptr_t* a = rec->args;
+    char* data[2];
+    size_t size[2];
+    ssize_t nFree = SYS_CONSOLE_WriteReserve(SYS_CONSOLE_DEFAULT_INSTANCE, data, size);
+    int len;
+
+    if (nFree <= 0)
+    {
+        return false;
+    }
+    if (rec->file != NULL)
+    {
+        len = APP_LOG_SpanPrintf(data, size, rec->fmt, rec->file, (int)rec->line,
+                                 a[0], a[1], a[2], a[3], a[4], a[5]);
+    }
+    else
+    {
+        len = APP_LOG_SpanPrintf(data, size, rec->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+    }
+    if ((len < 0) || (len > nFree))
+    {
+        return false;
+    }
+    SYS_CONSOLE_WriteCommit(SYS_CONSOLE_DEFAULT_INSTANCE, (size_t)len);
+    return true;
+}
+
+#endif
+
+#endif
+
+void APP_LOG_Tasks(void)
+{
+    while (true)
+    {
+        ssize_t written;
+
+        if (appLogLinePos == appLogLineLen)
+        {
+            uint32_t tail = appLogTail;
+            const APP_LOG_RECORD* rec;
+            uint32_t lag;
+
+            if (appLogHold || (tail == appLogHead))
+            {
+                return;
+            }
+            APP_LOG_BARRIER();
+            rec = &appLogRing[tail & APP_LOG_RING_MASK];
+            lag = _CP0_GET_COUNT() - rec->timestamp;
+            if (lag > appLogStats.maxLag)
+            {
+                appLogStats.maxLag = lag;
+            }
+            if (rec->fmt == NULL)
+            {
+                appLogLineLen = APP_TELEMETRY_FrameEncode((uint8_t*)appLogLine, rec->payload,
+                                                          rec->nArgs, !appLogFrameLast);
+                appLogFrameLast = true;
+            }
+#if !APP_LOG_DICT && SYS_CONSOLE_PRINT_ZERO_COPY
+            else if (APP_LOG_FormatInPlace(rec))
+            {
+                appLogLineLen = 0;
+                appLogFrameLast = false;
+            }
+#endif
+            else
+            {
+                appLogLineLen = APP_LOG_Format(rec);
+                appLogFrameLast = false;
+            }
+            appLogLinePos = 0;
+
+            // the record is copied out, its slot can be reused
+            APP_LOG_BARRIER();
+            appLogTail = tail + 1u;
+            continue;
+        }
+
+        written = SYS_CONSOLE_Write(SYS_CONSOLE_DEFAULT_INSTANCE, &appLogLine[appLogLinePos],
+                                    appLogLineLen - appLogLinePos);
+        if (written <= 0)
+        {
+            // console not ready or TX ring full, try again next time
+            return;
+        }
+        appLogLinePos += (size_t)written;
+    }
+}
+
+void APP_LOG_Hold(bool hold)
+{
+    if (appLogHold && !hold)
+    {
+        // others may have written to the console meanwhile, the next frame
+        // needs its leading delimiter
+        appLogFrameLast = false;
+    }
+    appLogHold = hold;
+}
+
+bool APP_LOG_Held(void)
+{
+    return appLogHold && (appLogLinePos == appLogLineLen);
+}
+
+bool APP_LOG_Pending(void)
+{
+    return (appLogTail != appLogHead) || (appLogLinePos != appLogLineLen);
+}
+
+void APP_LOG_StatsGet(APP_LOG_STATS* stats)
+{
+    *stats = appLogStats;
+}
@@ -0,0 +1,172 @@
+/*******************************************************************************
+  Deferred Log Header File
+
+  File Name:
+    app_log.h
+
+  Summary:
+    Log records queued in a lock-free ring, formatted later in SYS_Tasks().
+
+  Description:
+    APP_LOG_PRINT() does not format anything. It stores the format string
+    pointer, file and line, the core timer count and up to APP_LOG_ARGS_MAX
+    arguments (each cast to uintptr_t) into a single producer single consumer
+    ring. APP_LOG_Tasks(), called from SYS_Tasks() after the application,
+    formats the records with snprintf() and writes them to the console as the
+    UART2 TX ring has room.
+
+    Because formatting happens later:
+    - arguments must be integers up to 32 bits, chars or pointers. No double,
+      no 64 bit integers
+    - %s arguments must stay valid until the record is written, in practice
+      string literals
+
+    The producer is the application task, the consumer APP_LOG_Tasks(). When
+    the ring is full the record is dropped and counted, the producer never
+    waits.
+*******************************************************************************/
+
+#ifndef _APP_LOG_H
+#define _APP_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// records in the ring, power of two. The first sample with 8 sensors queues 16
+#ifndef APP_LOG_RING_SIZE
+#define APP_LOG_RING_SIZE 32
+#endif
+
+#define APP_LOG_ARGS_MAX 6
+
+// longest formatted record, longer ones are cut
+#define APP_LOG_LINE_SIZE 160
+
+typedef struct
+{
+    uint32_t records;   // records queued
+    uint32_t dropped;   // records lost because the ring was full
+    uint32_t maxUsed;   // most records in the ring at once
+    uint32_t maxLag;    // core timer ticks from queuing to formatting, worst case
+} APP_LOG_STATS;
+
+// number of arguments, 0 .. APP_LOG_ARGS_MAX
+#define APP_LOG_NARGS(...) APP_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define APP_LOG_NARGS_(z, a1, a2, a3, a4, a5, a6, n, ...) n
+
+// casts every argument to uintptr_t, APP_LOG_Write() reads them as such
+#define APP_LOG_CAST_0()
+#define APP_LOG_CAST_1(a)                , (uintptr_t)(a)
+#define APP_LOG_CAST_2(a, b)             APP_LOG_CAST_1(a) APP_LOG_CAST_1(b)
+#define APP_LOG_CAST_3(a, b, c)          APP_LOG_CAST_2(a, b) APP_LOG_CAST_1(c)
+#define APP_LOG_CAST_4(a, b, c, d)       APP_LOG_CAST_3(a, b, c) APP_LOG_CAST_1(d)
+#define APP_LOG_CAST_5(a, b, c, d, e)    APP_LOG_CAST_4(a, b, c, d) APP_LOG_CAST_1(e)
+#define APP_LOG_CAST_6(a, b, c, d, e, f) APP_LOG_CAST_5(a, b, c, d, e) APP_LOG_CAST_1(f)
+#define APP_LOG_CAST_N(n)                APP_LOG_CAST_N_(n)
+#define APP_LOG_CAST_N_(n)               APP_LOG_CAST_##n
+
+/* 0: the users of APP_LOG_PRINT() (app.c, app_shell.c) format and write
+   their messages inline with SYS_CONSOLE_Print() instead */
+#ifndef APP_LOG_DEFERRED
+#define APP_LOG_DEFERRED 1
+#endif
+
+/* Build time thresholds, SYS_DEBUG levels: 0 fatal (nothing), 1 error,
+   2 warning, 3 info, 4 debug. A message above the threshold of its module
+   is not compiled, neither its format string nor its arguments. The
+   run-time level of SYS_DEBUG (shell command "log") only filters the
+   messages that were compiled.
+   Modules of app.c: APP start-up, probe and fatal errors, TC74 the
+   messages of every sample and sensor. */
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL 4
+#endif
+#ifndef APP_LOG_LEVEL_APP
+#define APP_LOG_LEVEL_APP APP_LOG_LEVEL
+#endif
+#ifndef APP_LOG_LEVEL_TC74
+#define APP_LOG_LEVEL_TC74 APP_LOG_LEVEL
+#endif
+// highest level compiled in any module
+#if APP_LOG_LEVEL_APP > APP_LOG_LEVEL_TC74
+#define APP_LOG_LEVEL_MAX APP_LOG_LEVEL_APP
+#else
+#define APP_LOG_LEVEL_MAX APP_LOG_LEVEL_TC74
+#endif
+#if APP_LOG_LEVEL_APP < 0 || APP_LOG_LEVEL_APP > 4 || APP_LOG_LEVEL_TC74 < 0 || APP_LOG_LEVEL_TC74 > 4
+#error "APP_LOG_LEVEL_<module> must be a SYS_DEBUG level, 0 .. 4"
+#endif
+
+/* Dictionary mode: format strings go into the non-allocated ELF section
+   .app_log_dict instead of flash. The address of a string in it is its offset
+   in the section, that is the ID sent instead of the text. APP_LOG_Tasks()
+   writes one frame per record:
+
+     0xF0 | nArgs, varint ID, nArgs x varint argument
+
+   varint: 7 bits per byte, least significant first, bit 7 set when more
+   follow. firmware/host/tools/app_log_decode.c reads the dictionary (and
+   the strings of %s arguments) from the ELF and prints the text. */
+#ifndef APP_LOG_DICT
+#define APP_LOG_DICT 0
+#endif
+
+#define APP_LOG_DICT_FRAME 0xF0u
+
+#define APP_LOG_STR(x) #x
+#define APP_LOG_XSTR(x) APP_LOG_STR(x)
+
+#if APP_LOG_DICT
+// "#" comments out the section flags the compiler appends, so the section
+// is not allocated
+#define APP_LOG_DICT_SECTION ".app_log_dict,\"\",@progbits #"
+
+// fmt must be a string literal, file and line belong into it
+#define APP_LOG_DICT_PRINT(fmt, ...) \
+    do{ static const char appLogDictFmt[] \
+            __attribute__((section(APP_LOG_DICT_SECTION), used)) = fmt; \
+        APP_LOG_Write(NULL, 0, appLogDictFmt, APP_LOG_NARGS(__VA_ARGS__) \
+                      APP_LOG_CAST_N(APP_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)); \
+    }while(0)
+#endif
+
+/* file NULL: fmt is printed as is. Otherwise fmt starts with "%s:%d" (or has
+   them first among its conversions), which take file and the line number. */
+#define APP_LOG_PRINT(file, fmt, ...) \
+    APP_LOG_Write((file), __LINE__, (fmt), APP_LOG_NARGS(__VA_ARGS__) \
+                  APP_LOG_CAST_N(APP_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__))
+
+void APP_LOG_Write(const char* file, uint16_t line, const char* fmt, unsigned nArgs, ...);
+
+/* Queues a telemetry payload (app_telemetry.h, up to APP_TELEMETRY_PAYLOAD_MAX
+   bytes). APP_LOG_Tasks() adds CRC and COBS framing and writes it between
+   the text records, in order. */
+void APP_LOG_FrameWrite(const uint8_t* payload, size_t size);
+
+/* Formats and writes queued records while the console takes them. Called from
+   SYS_Tasks() after the application tasks. */
+void APP_LOG_Tasks(void);
+
+// true while records wait to be written
+bool APP_LOG_Pending(void);
+
+/* While held APP_LOG_Tasks() starts no new record, one it has begun to write
+   is finished. Records are still queued. APP_LOG_Held() is true once nothing
+   is being written, then the console can be used directly. */
+void APP_LOG_Hold(bool hold);
+bool APP_LOG_Held(void);
+
+void APP_LOG_StatsGet(APP_LOG_STATS* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_LOG_H */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+  Sampling Schedule
+
+  File Name:
+    app_sched.c
+
+  Summary:
+    Absolute deadlines of the samples and their lateness statistics (see
+    app_sched.h).
+*******************************************************************************/
+
+#include "definitions.h"
+#include "app_sched.h"
+
+typedef struct
+{
+    uint64_t deadline;          // of the next scheduled scan, SYS_TIME counter
+    uint32_t ticksPerUs;        // SYS_TIME counts per microsecond
+    bool consecutive;           // no deadline skipped since the last scan
+    uint32_t lastLateUs;
+    APP_SCHED_STATS stats;
+} APP_SCHED_DATA;
+
+static APP_SCHED_DATA appSched;
+
+void APP_SCHED_Start(uint64_t now)
+{
+    appSched.deadline = now;
+    appSched.ticksPerUs = SYS_TIME_FrequencyGet() / 1000000u;
+    appSched.consecutive = false;
+}
+
+void APP_SCHED_Started(uint64_t now)
+{
+    APP_SCHED_STATS *stats = &appSched.stats;
+    uint64_t late = (now > appSched.deadline) ? now - appSched.deadline : 0u;
+    uint32_t lateUs = (late < UINT32_MAX) ? (uint32_t)late / appSched.ticksPerUs
+                                          : UINT32_MAX / appSched.ticksPerUs;
+    uint32_t rest = lateUs >> 1;
+    unsigned bin = 0;
+
+    while (rest != 0u && bin < APP_SCHED_BINS - 1u)
+    {
+        rest >>= 1;
+        bin++;
+    }
+    stats->histogram[bin]++;
+    if (stats->samples == 0u)
+    {
+        stats->firstStart = now;
+    }
+    stats->samples++;
+    stats->lastStart = now;
+    stats->lateSumUs += lateUs;
+    stats->lateMaxUs = (lateUs > stats->lateMaxUs) ? lateUs : stats->lateMaxUs;
+    if (appSched.consecutive)
+    {
+        // both deadlines are exactly one period apart
+        int32_t jitterUs = (int32_t)(lateUs - appSched.lastLateUs);
+
+        if (stats->intervals == 0u || jitterUs < stats->jitterMinUs)
+        {
+            stats->jitterMinUs = jitterUs;
+        }
+        if (stats->intervals == 0u || jitterUs > stats->jitterMaxUs)
+        {
+            stats->jitterMaxUs = jitterUs;
+        }
+        stats->intervals++;
+    }
+    appSched.lastLateUs = lateUs;
+}
+
+uint64_t APP_SCHED_Next(uint64_t now, uint64_t period)
+{
+    appSched.deadline += period;
+    appSched.consecutive = true;
+    if (appSched.deadline <= now)
+    {
+        // the scan ran past these, the next one keeps to the grid
+        uint64_t skipped = (now - appSched.deadline) / period + 1u;
+
+        appSched.deadline += skipped * period;
+        appSched.stats.missed += (uint32_t)skipped;
+        appSched.consecutive = false;
+    }
+    return appSched.deadline;
+}
+
+void APP_SCHED_StatsGet(APP_SCHED_STATS* stats)
+{
+    *stats = appSched.stats;
+}
+
+uint32_t APP_SCHED_BinUs(unsigned bin)
+{
+    return (bin == 0u) ? 0u : 1u << bin;
+}
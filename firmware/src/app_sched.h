@@ -0,0 +1,83 @@
+/*******************************************************************************
+  Sampling Schedule Header File
+
+  File Name:
+    app_sched.h
+
+  Summary:
+    Absolute deadlines of the samples on SYS_TIME_Counter64Get(), and how
+    late each sample started.
+
+  Description:
+    The deadlines are a grid: the first scan after the probe is its origin,
+    every next deadline is the previous one plus the sample period. The
+    pause only waits for the deadline, so the time taken by the scan, the
+    report and the wake-up does not add to the period. A scan that starts
+    late does not move the deadlines after it. When a scan runs past one or
+    more deadlines they are skipped and counted as missed, the next scan
+    never starts early to catch up.
+
+    A new period (APP_SamplePeriodSet()) counts from the last deadline.
+    Retries of a busy or waking sensor (APP_TC74_RETRY_US) happen between
+    the deadlines and are not scheduled scans.
+
+    Statistics of the scheduled scans, in microseconds:
+    - lateness: start of the scan minus its deadline. The histogram has
+      powers of two bins, bin 0 below 2 us, bin i from 2^i up to 2^(i+1),
+      the last bin everything above.
+    - jitter: interval from the previous scheduled scan minus the period,
+      only between scans without a missed deadline in between. It is the
+      difference of the two latenesses.
+    - first and last start, (last - first) / (samples - 1) is the period
+      that was kept.
+*******************************************************************************/
+
+#ifndef _APP_SCHED_H
+#define _APP_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// lateness histogram bins, the last one from 2^(APP_SCHED_BINS-1) us up
+#define APP_SCHED_BINS 12u
+
+typedef struct
+{
+    uint32_t samples;       // scheduled scans started
+    uint32_t missed;        // deadlines skipped, the scan before ran past them
+    uint64_t lateSumUs;
+    uint32_t lateMaxUs;
+    uint32_t intervals;     // of the jitter, between consecutive scans
+    int32_t jitterMinUs;
+    int32_t jitterMaxUs;
+    uint64_t firstStart;    // SYS_TIME counter at the first and the last scan
+    uint64_t lastStart;
+    uint32_t histogram[APP_SCHED_BINS];
+} APP_SCHED_STATS;
+
+// the scan that starts now is the origin of the deadlines
+void APP_SCHED_Start(uint64_t now);
+
+// a scheduled scan started at now, SYS_TIME counter
+void APP_SCHED_Started(uint64_t now);
+
+/* Moves the deadline one period (SYS_TIME counts) on, skipping those not
+   after now. Returns the new deadline. */
+uint64_t APP_SCHED_Next(uint64_t now, uint64_t period);
+
+void APP_SCHED_StatsGet(APP_SCHED_STATS* stats);
+
+// lower bound of histogram bin, in microseconds
+uint32_t APP_SCHED_BinUs(unsigned bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_SCHED_H */
@@ -0,0 +1,550 @@
+/*******************************************************************************
+  Console Shell
+
+  File Name:
+    app_shell.c
+
+  Summary:
+    Command line on the UART2 console RX path (see app_shell.h).
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "app.h"
+#include "app_shell.h"
+#include "i2c_latency.h"
+
+// the answers go the way of the application's messages, they are plain
+// text in the telemetry stream too
+#if APP_LOG_DICT
+#define APP_SHELL_PRINT(fmt, ...) APP_LOG_DICT_PRINT(fmt "\r\n", ##__VA_ARGS__)
+#elif APP_LOG_DEFERRED
+#define APP_SHELL_PRINT(fmt, ...) APP_LOG_PRINT(NULL, fmt "\r\n", ##__VA_ARGS__)
+#else
+#define APP_SHELL_PRINT(fmt, ...) SYS_CONSOLE_PRINT(fmt "\r\n", ##__VA_ARGS__)
+#endif
+
+// the longest answer line, written inline UART2 must have room for it
+#define APP_SHELL_OUTPUT_MAX 80u
+
+// core timer ticks per micro-second
+#define APP_SHELL_TICKS_PER_US (CPU_CLOCK_FREQUENCY / 2000000u)
+
+typedef enum
+{
+    APP_SHELL_STATE_START = 0,  // first call, registers the RX callback
+    APP_SHELL_STATE_READ,       // collects a command line
+    APP_SHELL_STATE_EXECUTE,    // a complete line waits in line[]
+    APP_SHELL_STATE_ANSWER,     // the command writes its answer, a line per call
+} APP_SHELL_STATE;
+
+/* Writes answer line step of a command, false after the last one. Settings
+   are changed before the first step is called. */
+typedef bool (*APP_SHELL_ANSWER)(unsigned step);
+
+typedef struct
+{
+    APP_SHELL_STATE state;
+    volatile bool rxWake;       // set by the RX callback, the ring is not empty
+    volatile bool rxError;      // set by the RX callback, UART2 receive error
+    char line[APP_SHELL_LINE_SIZE + 1u];
+    size_t lineLen;
+    bool lineDropped;           // too long or damaged, skipped up to its end
+    APP_SHELL_ANSWER answer;
+    unsigned step;
+    uint32_t answerDeadline;    // core timer, the next line goes out anyway
+    uint32_t arg;               // parsed argument of the command
+    bool enable;                // "on" of the sensor command
+    bool ok;                    // the setting was accepted
+    APP_SHELL_STATS stats;
+} APP_SHELL_DATA;
+
+static APP_SHELL_DATA appShell;
+
+static const char* const appShellLevels[] =
+{
+    "fatal", "error", "warning", "info", "debug"
+};
+
+// runs in the UART2 RX interrupt
+static void APP_SHELL_RxCallback(UART_EVENT event, uintptr_t context)
+{
+    (void)context;
+    if (event == UART_EVENT_READ_ERROR)
+    {
+        appShell.rxError = true;
+    }
+    appShell.rxWake = true;
+}
+
+static bool APP_SHELL_HelpAnswer(unsigned step)
+{
+    switch (step)
+    {
+        case 0:
+            APP_SHELL_PRINT("commands: help, stats [i2c|sched], period [ms], sensors,");
+            return true;
+        default:
+            APP_SHELL_PRINT("  sensor <addr> on|off, log [0-4|name], baud <rate>");
+            return false;
+    }
+}
+
+static bool APP_SHELL_StatsAnswer(unsigned step)
+{
+    switch (step)
+    {
+        case 0:
+            APP_SHELL_PRINT("samples: %u, period %u ms",
+                            (unsigned)APP_SampleCountGet(),
+                            (unsigned)(APP_SamplePeriodGet() / 1000u));
+            return true;
+        case 1:
+        {
+            APP_LOG_STATS log;
+
+            APP_LOG_StatsGet(&log);
+            APP_SHELL_PRINT("log: %u records, %u dropped, %u max used, %u us max lag",
+                            (unsigned)log.records, (unsigned)log.dropped, (unsigned)log.maxUsed,
+                            (unsigned)(log.maxLag / APP_SHELL_TICKS_PER_US));
+            return true;
+        }
+        case 2:
+        {
+            UART2_TX_STATS tx;
+
+            UART2_TxStatsGet(&tx);
+            APP_SHELL_PRINT("uart2: %u Bd, %u bytes sent, %u TX interrupts",
+                            (unsigned)UART2_BaudRateGet(), (unsigned)tx.bytes,
+                            (unsigned)tx.interrupts);
+            return true;
+        }
+        case 3:
+        {
+            APP_BAUD_STATS baud;
+
+            APP_BAUD_StatsGet(&baud);
+            APP_SHELL_PRINT("baud: %u switches, %u failed, %u auto-baud",
+                            (unsigned)baud.switches, (unsigned)baud.failures,
+                            (unsigned)baud.autobauds);
+            return true;
+        }
+        case 4:
+        {
+            SYS_TIME_DEFERRED_STATS deferred;
+            uint32_t ticksPerUs = SYS_TIME_FrequencyGet() / 1000000u;
+
+            SYS_TIME_DeferredStatsGet(&deferred);
+            APP_SHELL_PRINT("timer: %u deferred, %u dropped, depth %u, avg %u max %u us late",
+                            (unsigned)deferred.run, (unsigned)deferred.dropped,
+                            (unsigned)deferred.maxDepth,
+                            (unsigned)((deferred.run != 0u) ? deferred.latencySum / deferred.run / ticksPerUs : 0u),
+                            (unsigned)(deferred.latencyMax / ticksPerUs));
+            return true;
+        }
+        default:
+            APP_SHELL_PRINT("shell: %u lines, %u unknown, %u too long, %u RX errors",
+                            (unsigned)appShell.stats.lines, (unsigned)appShell.stats.unknown,
+                            (unsigned)appShell.stats.overflows, (unsigned)appShell.stats.errors);
+            return false;
+    }
+}
+
+static bool APP_SHELL_I2cAnswer(unsigned step)
+{
+    I2C_LAT_STATS lat;
+
+    if (!I2C_LAT_StatsGet((I2C_LAT_STAGE)step, &lat))
+    {
+        APP_SHELL_PRINT("i2c: latency not compiled in (I2C_LATENCY_ENABLE)");
+        return false;
+    }
+    APP_SHELL_PRINT("i2c %s: %u, min %u avg %u max %u us",
+                    I2C_LAT_StageName((I2C_LAT_STAGE)step), (unsigned)lat.count,
+                    (unsigned)(lat.min / APP_SHELL_TICKS_PER_US),
+                    (unsigned)((lat.count != 0u) ? (lat.sum / lat.count / APP_SHELL_TICKS_PER_US) : 0u),
+                    (unsigned)(lat.max / APP_SHELL_TICKS_PER_US));
+    return (step + 1u) < (unsigned)I2C_LAT_STAGE_NUMBER;
+}
+
+static bool APP_SHELL_SchedAnswer(unsigned step)
+{
+    APP_SCHED_STATS sched;
+    uint32_t ticksPerUs = SYS_TIME_FrequencyGet() / 1000000u;
+
+    APP_SCHED_StatsGet(&sched);
+    switch (step)
+    {
+        case 0:
+            APP_SHELL_PRINT("sched: %u samples, %u missed, late avg %u max %u us",
+                            (unsigned)sched.samples, (unsigned)sched.missed,
+                            (unsigned)((sched.samples != 0u) ? sched.lateSumUs / sched.samples : 0u),
+                            (unsigned)sched.lateMaxUs);
+            return true;
+        case 1:
+        {
+            // period kept from the first to the last sample, 0.1 us resolution
+            uint64_t tenthsUs = (sched.samples > 1u)
+                    ? (sched.lastStart - sched.firstStart) * 10u / (sched.samples - 1u) / ticksPerUs
+                    : 0u;
+
+            APP_SHELL_PRINT("sched: period %u.%u us, jitter %d..%d us over %u intervals",
+                            (unsigned)(tenthsUs / 10u), (unsigned)(tenthsUs % 10u),
+                            (int)sched.jitterMinUs, (int)sched.jitterMaxUs,
+                            (unsigned)sched.intervals);
+            return true;
+        }
+        default:
+        {
+            // lateness histogram, a line per bin
+            unsigned bin = step - 2u;
+
+            if (bin + 1u < APP_SCHED_BINS)
+            {
+                APP_SHELL_PRINT("  late %u..%u us: %u", (unsigned)APP_SCHED_BinUs(bin),
+                                (unsigned)APP_SCHED_BinUs(bin + 1u), (unsigned)sched.histogram[bin]);
+                return true;
+            }
+            APP_SHELL_PRINT("  late >= %u us: %u", (unsigned)APP_SCHED_BinUs(bin),
+                            (unsigned)sched.histogram[bin]);
+            return false;
+        }
+    }
+}
+
+static bool APP_SHELL_PeriodAnswer(unsigned step)
+{
+    (void)step;
+    if (appShell.ok)
+    {
+        APP_SHELL_PRINT("period: %u ms", (unsigned)(APP_SamplePeriodGet() / 1000u));
+    }
+    else
+    {
+        APP_SHELL_PRINT("period: %u ms too short", (unsigned)appShell.arg);
+    }
+    return false;
+}
+
+static bool APP_SHELL_SensorsAnswer(unsigned step)
+{
+    const APP_TC74_SENSOR *sensor = APP_SensorGet(step);
+
+    if (sensor->state == APP_TC74_STATE_ABSENT)
+    {
+        APP_SHELL_PRINT("sensor 0x%x: not polled", (unsigned)sensor->address);
+    }
+    else
+    {
+        APP_SHELL_PRINT("sensor 0x%x: %d Celsius, CONFIG=0x%x, %u errors",
+                        (unsigned)sensor->address, (int)sensor->temp,
+                        (unsigned)sensor->config, (unsigned)sensor->errors);
+    }
+    return (step + 1u) < APP_TC74_SENSORS_MAX;
+}
+
+static bool APP_SHELL_SensorAnswer(unsigned step)
+{
+    (void)step;
+    if (!appShell.ok)
+    {
+        APP_SHELL_PRINT("sensor 0x%x: refused", (unsigned)appShell.arg);
+    }
+    else
+    {
+        // the application reports the probe of a sensor not polled so far
+        APP_SHELL_PRINT("sensor 0x%x: %s from the next scan", (unsigned)appShell.arg,
+                        appShell.enable ? "on" : "off");
+    }
+    return false;
+}
+
+static bool APP_SHELL_LogAnswer(unsigned step)
+{
+    SYS_ERROR_LEVEL level = SYS_DEBUG_ErrorLevelGet();
+
+    (void)step;
+    // messages above APP_LOG_LEVEL_MAX were not compiled at all
+    APP_SHELL_PRINT("log: %u (%s), built up to %u (%s)", (unsigned)level,
+                    (level <= SYS_ERROR_DEBUG) ? appShellLevels[level] : "?",
+                    (unsigned)APP_LOG_LEVEL_MAX, appShellLevels[APP_LOG_LEVEL_MAX]);
+    return false;
+}
+
+static bool APP_SHELL_BaudAnswer(unsigned step)
+{
+    (void)step;
+    // a started switch is answered by app_baud.c
+    if (!appShell.ok)
+    {
+        APP_SHELL_PRINT("baud: busy");
+    }
+    return false;
+}
+
+static bool APP_SHELL_UnknownAnswer(unsigned step)
+{
+    (void)step;
+    APP_SHELL_PRINT("unknown command, try help");
+    return false;
+}
+
+// parses a number that is all of text, base as for strtoul()
+static bool APP_SHELL_Number(const char *text, int base, uint32_t *value)
+{
+    char *end;
+    unsigned long n;
+
+    if (*text == '\0')
+    {
+        return false;
+    }
+    n = strtoul(text, &end, base);
+    if ((*end != '\0') || (n > UINT32_MAX))
+    {
+        return false;
+    }
+    *value = (uint32_t)n;
+    return true;
+}
+
+static APP_SHELL_ANSWER APP_SHELL_Execute(char *command)
+{
+    char *args = strchr(command, ' ');
+
+    appShell.ok = true;
+    if (args != NULL)
+    {
+        *args++ = '\0';
+    }
+    else
+    {
+        args = &command[strlen(command)];
+    }
+
+    if (strcmp(command, "help") == 0)
+    {
+        return APP_SHELL_HelpAnswer;
+    }
+    if (strcmp(command, "stats") == 0)
+    {
+        if (*args == '\0')
+        {
+            return APP_SHELL_StatsAnswer;
+        }
+        if (strcmp(args, "sched") == 0)
+        {
+            return APP_SHELL_SchedAnswer;
+        }
+        return (strcmp(args, "i2c") == 0) ? APP_SHELL_I2cAnswer : NULL;
+    }
+    if (strcmp(command, "period") == 0)
+    {
+        if (*args != '\0')
+        {
+            if (!APP_SHELL_Number(args, 10, &appShell.arg) || (appShell.arg > 3600000u))
+            {
+                return NULL;
+            }
+            appShell.ok = APP_SamplePeriodSet(appShell.arg * 1000u);
+        }
+        return APP_SHELL_PeriodAnswer;
+    }
+    if (strcmp(command, "sensors") == 0)
+    {
+        return (*args == '\0') ? APP_SHELL_SensorsAnswer : NULL;
+    }
+    if (strcmp(command, "sensor") == 0)
+    {
+        char *state = strchr(args, ' ');
+
+        if (state == NULL)
+        {
+            return NULL;
+        }
+        *state++ = '\0';
+        if (!APP_SHELL_Number(args, 0, &appShell.arg) || (appShell.arg > 0xffu))
+        {
+            return NULL;
+        }
+        appShell.enable = (strcmp(state, "on") == 0);
+        if (!appShell.enable && (strcmp(state, "off") != 0))
+        {
+            return NULL;
+        }
+        appShell.ok = APP_SensorEnable((uint8_t)appShell.arg, appShell.enable);
+        return APP_SHELL_SensorAnswer;
+    }
+    if (strcmp(command, "log") == 0)
+    {
+        if (*args != '\0')
+        {
+            uint32_t level;
+
+            for (level = 0; level <= (uint32_t)SYS_ERROR_DEBUG; level++)
+            {
+                if (strcmp(args, appShellLevels[level]) == 0)
+                {
+                    break;
+                }
+            }
+            if ((level > (uint32_t)SYS_ERROR_DEBUG)
+                && (!APP_SHELL_Number(args, 10, &level) || (level > (uint32_t)SYS_ERROR_DEBUG)))
+            {
+                return NULL;
+            }
+            SYS_DEBUG_ErrorLevelSet((SYS_ERROR_LEVEL)level);
+        }
+        return APP_SHELL_LogAnswer;
+    }
+    if (strcmp(command, "baud") == 0)
+    {
+        if (!APP_SHELL_Number(args, 10, &appShell.arg))
+        {
+            return NULL;
+        }
+        appShell.ok = APP_BAUD_Request(appShell.arg);
+        return APP_SHELL_BaudAnswer;
+    }
+    return NULL;
+}
+
+// takes up to APP_SHELL_RX_BUDGET characters, true when a line is complete
+static bool APP_SHELL_LineRead(void)
+{
+    unsigned budget = APP_SHELL_RX_BUDGET;
+    uint8_t c;
+
+    while ((budget-- != 0u) && (UART2_Read(&c, 1U) != 0U))
+    {
+        if ((c != '\r') && (c != '\n'))
+        {
+            if (appShell.lineLen < APP_SHELL_LINE_SIZE)
+            {
+                appShell.line[appShell.lineLen++] = (char)c;
+            }
+            else if (!appShell.lineDropped)
+            {
+                appShell.lineDropped = true;
+                appShell.stats.overflows++;
+            }
+            else
+            {
+                /* Nothing to do */
+            }
+            continue;
+        }
+        if (appShell.lineDropped || (appShell.lineLen == 0u))
+        {
+            // also the LF of CR LF
+            appShell.lineLen = 0;
+            appShell.lineDropped = false;
+            continue;
+        }
+        appShell.line[appShell.lineLen] = '\0';
+        appShell.lineLen = 0;
+        return true;
+    }
+    return false;
+}
+
+// the deferred log comes first, unless it has been busy for
+// APP_SHELL_ANSWER_WAIT_MS
+static bool APP_SHELL_OutputReady(void)
+{
+#if APP_LOG_DICT || APP_LOG_DEFERRED
+    // checked every round while the log drains, the core timer is cheaper
+    // than SYS_TIME
+    return !APP_LOG_Pending() || ((int32_t)(_CP0_GET_COUNT() - appShell.answerDeadline) >= 0);
+#else
+    // written inline, SYS_CONSOLE_Print() cuts what does not fit
+    return UART2_WriteFreeBufferCountGet() >= APP_SHELL_OUTPUT_MAX;
+#endif
+}
+
+static void APP_SHELL_AnswerWait(void)
+{
+    appShell.answerDeadline = _CP0_GET_COUNT() + (APP_SHELL_ANSWER_WAIT_MS * 1000u * APP_SHELL_TICKS_PER_US);
+}
+
+void APP_SHELL_Tasks(void)
+{
+    switch (appShell.state)
+    {
+        case APP_SHELL_STATE_START:
+            UART2_ReadCallbackRegister(APP_SHELL_RxCallback, 0);
+            // first character into the empty ring
+            UART2_ReadThresholdSet(1U);
+            (void)UART2_ReadNotificationEnable(true, false);
+            appShell.rxWake = true;
+            appShell.state = APP_SHELL_STATE_READ;
+            break;
+
+        case APP_SHELL_STATE_READ:
+            if (!appShell.rxWake || !APP_BAUD_Ready() || APP_SampleSoon(APP_SHELL_QUIET_US))
+            {
+                break;
+            }
+            // cleared before the ring is read, a character arriving meanwhile
+            // sets it again
+            appShell.rxWake = false;
+            if (appShell.rxError)
+            {
+                appShell.rxError = false;
+                (void)UART2_ErrorGet();
+                if (!appShell.lineDropped)
+                {
+                    appShell.lineDropped = true;
+                    appShell.stats.errors++;
+                }
+            }
+            if (APP_SHELL_LineRead())
+            {
+                appShell.state = APP_SHELL_STATE_EXECUTE;
+            }
+            if (UART2_ReadCountGet() != 0U)
+            {
+                // budget used up, the rest next time
+                appShell.rxWake = true;
+            }
+            break;
+
+        case APP_SHELL_STATE_EXECUTE:
+            if (APP_SampleSoon(APP_SHELL_QUIET_US))
+            {
+                break;
+            }
+            appShell.stats.lines++;
+            appShell.step = 0;
+            appShell.answer = APP_SHELL_Execute(appShell.line);
+            if (appShell.answer == NULL)
+            {
+                appShell.stats.unknown++;
+                appShell.answer = APP_SHELL_UnknownAnswer;
+            }
+            APP_SHELL_AnswerWait();
+            appShell.state = APP_SHELL_STATE_ANSWER;
+            break;
+
+        case APP_SHELL_STATE_ANSWER:
+            if (!APP_SHELL_OutputReady() || APP_SampleSoon(APP_SHELL_QUIET_US))
+            {
+                break;
+            }
+            if (!appShell.answer(appShell.step++))
+            {
+                appShell.state = APP_SHELL_STATE_READ;
+            }
+            APP_SHELL_AnswerWait();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void APP_SHELL_StatsGet(APP_SHELL_STATS* stats)
+{
+    *stats = appShell.stats;
+}
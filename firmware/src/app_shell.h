@@ -0,0 +1,93 @@
+/*******************************************************************************
+  Console Shell Header File
+
+  File Name:
+    app_shell.h
+
+  Summary:
+    Command line on the UART2 console RX path, serviced from SYS_Tasks()
+    without ever waiting.
+
+  Description:
+    The host types a command and ends it with CR or LF. There is no echo and
+    no prompt, every command answers with one or more lines:
+
+      help                      lists the commands
+      stats                     samples, log, UART2 TX, rate switch, deferred
+                                SYS_TIME callbacks, shell
+      stats i2c                 I2C latency per stage (I2C_LATENCY_ENABLE)
+      stats sched               lateness and jitter of the samples against
+                                their deadlines, histogram (app_sched.h)
+      period [ms]               shows or sets the period of the samples
+      sensors                   last reading of every sensor
+      sensor <addr> on|off      polls a TC74 again (after a probe) or stops
+      log [0-4|<name>]          shows or sets the SYS_DEBUG level, 3 (info)
+                                shows the samples, 1 (error) only errors.
+                                Nothing above APP_LOG_LEVEL_<module>
+                                (app_log.h) is in the build to be shown
+      baud <rate>               rate switch, see app_baud.h
+
+    A UART2 read callback (threshold 1, not persistent) only flags that the
+    RX ring is no longer empty. APP_SHELL_Tasks() then handles at most one of
+    these per call, so its cost per SYS_Tasks() round stays bounded however
+    fast the host types:
+    - APP_SHELL_RX_BUDGET characters into the line buffer, up to the end of
+      a line
+    - parsing and executing one complete line
+    - one line of output, when UART2 has room for it and the deferred log
+      has nothing pending. While the log is backed up (a slow console rate,
+      many sensors) a line goes out every APP_SHELL_ANSWER_WAIT_MS, so that
+      "log error" still gets through.
+
+    All of it waits while a scan is running or the next one is due within
+    APP_SHELL_QUIET_US (APP_SampleSoon()): the round that starts a sample
+    never carries shell work, nor the formatting of an answer.
+
+    Nothing is read while the console rate changes (APP_BAUD_Ready()), the
+    characters stay in the RX ring. A line longer than APP_SHELL_LINE_SIZE
+    or with a receive error is dropped and counted.
+*******************************************************************************/
+
+#ifndef _APP_SHELL_H
+#define _APP_SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// longest command line without its CR/LF
+#define APP_SHELL_LINE_SIZE 32u
+
+// characters taken from the RX ring per APP_SHELL_Tasks() call
+#define APP_SHELL_RX_BUDGET 16u
+
+// longest wait of an answer line for the deferred log
+#define APP_SHELL_ANSWER_WAIT_MS 50u
+
+// no shell work this close to the start of a sample, more than the longest
+// SYS_Tasks() round with an answer line to format
+#define APP_SHELL_QUIET_US 200u
+
+typedef struct
+{
+    uint32_t lines;         // command lines received
+    uint32_t unknown;       // lines that were no command, or had bad arguments
+    uint32_t overflows;     // lines dropped, longer than APP_SHELL_LINE_SIZE
+    uint32_t errors;        // lines dropped, UART2 receive errors
+} APP_SHELL_STATS;
+
+// called from SYS_Tasks() after the application, before APP_LOG_Tasks()
+void APP_SHELL_Tasks(void);
+
+void APP_SHELL_StatsGet(APP_SHELL_STATS* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_SHELL_H */
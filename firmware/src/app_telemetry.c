@@ -0,0 +1,98 @@
+/*******************************************************************************
+  Binary Telemetry
+
+  File Name:
+    app_telemetry.c
+
+  Summary:
+    CRC16, COBS framing and payload layout of telemetry frames (see
+    app_telemetry.h).
+*******************************************************************************/
+
+#include "app_telemetry.h"
+
+// CRC-16/CCITT-FALSE, 4 bits at a time
+static const uint16_t appTelemetryCrcTable[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+uint16_t APP_TELEMETRY_Crc16(const uint8_t* data, size_t size)
+{
+    uint16_t crc = 0xffffu;
+
+    while (size-- != 0u)
+    {
+        crc = (uint16_t)(crc << 4) ^ appTelemetryCrcTable[(crc >> 12) ^ (*data >> 4)];
+        crc = (uint16_t)(crc << 4) ^ appTelemetryCrcTable[(crc >> 12) ^ (*data & 0x0fu)];
+        data++;
+    }
+    return crc;
+}
+
+size_t APP_TELEMETRY_SamplePack(uint8_t* payload, const APP_TELEMETRY_SAMPLE* sample)
+{
+    unsigned i;
+
+    payload[0] = APP_TELEMETRY_TYPE_SAMPLE;
+    payload[1] = (uint8_t)sample->sequence;
+    payload[2] = (uint8_t)(sample->sequence >> 8);
+    payload[3] = sample->address;
+    for (i = 0; i < 8u; i++)
+    {
+        payload[4u + i] = (uint8_t)(sample->timestamp >> (8u * i));
+    }
+    payload[12] = (uint8_t)sample->temp;
+    payload[13] = sample->config;
+    payload[14] = sample->flags;
+    return APP_TELEMETRY_SAMPLE_SIZE;
+}
+
+size_t APP_TELEMETRY_InfoPack(uint8_t* payload, uint16_t version, uint32_t counterFrequency)
+{
+    payload[0] = APP_TELEMETRY_TYPE_INFO;
+    payload[1] = (uint8_t)version;
+    payload[2] = (uint8_t)(version >> 8);
+    payload[3] = 0;
+    payload[4] = (uint8_t)counterFrequency;
+    payload[5] = (uint8_t)(counterFrequency >> 8);
+    payload[6] = (uint8_t)(counterFrequency >> 16);
+    payload[7] = (uint8_t)(counterFrequency >> 24);
+    return APP_TELEMETRY_INFO_SIZE;
+}
+
+size_t APP_TELEMETRY_FrameEncode(uint8_t* frame, const uint8_t* payload, size_t size,
+                                 bool leadingZero)
+{
+    uint16_t crc = APP_TELEMETRY_Crc16(payload, size);
+    uint8_t* out = frame;
+    uint8_t* code;
+    size_t i;
+
+    if (leadingZero)
+    {
+        *out++ = 0;
+    }
+    // COBS: each block starts with the distance to the next zero. Frames are
+    // shorter than 254 bytes, so no block is ever full.
+    code = out++;
+    for (i = 0; i < size + 2u; i++)
+    {
+        uint8_t byte = (i < size) ? payload[i] :
+                       (i == size) ? (uint8_t)crc : (uint8_t)(crc >> 8);
+
+        if (byte == 0u)
+        {
+            *code = (uint8_t)(out - code);
+            code = out++;
+        }
+        else
+        {
+            *out++ = byte;
+        }
+    }
+    *code = (uint8_t)(out - code);
+    *out++ = 0;
+    return (size_t)(out - frame);
+}
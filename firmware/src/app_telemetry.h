@@ -0,0 +1,93 @@
+/*******************************************************************************
+  Binary Telemetry Header File
+
+  File Name:
+    app_telemetry.h
+
+  Summary:
+    Fixed layout sample frames with CRC16 and COBS framing.
+
+  Description:
+    With APP_TELEMETRY=1 the application sends one frame per sensor and sample
+    instead of the "#n ADDR=.. Temp=.." console line. Other messages stay text
+    on the same UART, frames are delimited by 0x00 bytes that text never
+    contains.
+
+    Frame on the wire:
+
+      [0x00] COBS(payload, CRC16) 0x00
+
+    The leading 0x00 is only sent after text, to end it. Payloads are little
+    endian:
+
+      SAMPLE (15 bytes)            INFO (8 bytes, once at start-up)
+      0  type  APP_TELEMETRY_TYPE_SAMPLE   0  type  APP_TELEMETRY_TYPE_INFO
+      1  sequence, uint16                  1  version (APP_VERSION), uint16
+      3  I2C address of the TC74           3  reserved, 0
+      4  SYS_TIME counter, uint64          4  SYS_TIME counter frequency, uint32
+      12 TEMP register (signed Celsius)
+      13 CONFIG register
+      14 flags, APP_TELEMETRY_FLAG_*
+
+    CRC16 is CRC-16/CCITT-FALSE (polynomial 0x1021, initial 0xFFFF) over the
+    payload, appended little endian.
+
+    Only CRC and framing are in this file, it has no Harmony dependencies so
+    that the host tools build it as well.
+*******************************************************************************/
+
+#ifndef _APP_TELEMETRY_H
+#define _APP_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+#define APP_TELEMETRY_TYPE_SAMPLE 0x01u
+#define APP_TELEMETRY_TYPE_INFO   0x02u
+
+#define APP_TELEMETRY_SAMPLE_SIZE 15u
+#define APP_TELEMETRY_INFO_SIZE   8u
+#define APP_TELEMETRY_PAYLOAD_MAX APP_TELEMETRY_SAMPLE_SIZE
+
+// CONFIG was read in the scan of this sample, else it is the last known value
+#define APP_TELEMETRY_FLAG_CONFIG_FRESH 0x01u
+
+// longest encoded frame: delimiters, COBS overhead byte, payload and CRC
+#define APP_TELEMETRY_FRAME_MAX (APP_TELEMETRY_PAYLOAD_MAX + 2u + 3u)
+
+typedef struct
+{
+    uint16_t sequence;
+    uint8_t address;
+    uint64_t timestamp;
+    int8_t temp;
+    uint8_t config;
+    uint8_t flags;
+} APP_TELEMETRY_SAMPLE;
+
+uint16_t APP_TELEMETRY_Crc16(const uint8_t* data, size_t size);
+
+// returns APP_TELEMETRY_SAMPLE_SIZE
+size_t APP_TELEMETRY_SamplePack(uint8_t* payload, const APP_TELEMETRY_SAMPLE* sample);
+
+// returns APP_TELEMETRY_INFO_SIZE
+size_t APP_TELEMETRY_InfoPack(uint8_t* payload, uint16_t version, uint32_t counterFrequency);
+
+/* Appends the CRC to payload (size up to APP_TELEMETRY_PAYLOAD_MAX), COBS
+   encodes it into frame and terminates it with 0x00, preceded by a 0x00 when
+   leadingZero. Returns the frame length, at most APP_TELEMETRY_FRAME_MAX. */
+size_t APP_TELEMETRY_FrameEncode(uint8_t* frame, const uint8_t* payload, size_t size,
+                                 bool leadingZero);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_TELEMETRY_H */
@@ -83,6 +83,21 @@ extern "C" {
 #define SYS_CONSOLE_UART_MAX_INSTANCES 	   			(1U)
 #define SYS_CONSOLE_USB_CDC_MAX_INSTANCES 	   		(0U)
 #define SYS_CONSOLE_PRINT_BUFFER_SIZE        		(1024U)
+/* SYS_CONSOLE_Print() formats with the integer only SYS_CONSOLE_Vsnprintf()
+   (sys_console_format.c) instead of vsnprintf() */
+#ifndef SYS_CONSOLE_PRINT_LITE
+#define SYS_CONSOLE_PRINT_LITE                      (1)
+#endif
+/* SYS_CONSOLE_Print() formats straight into the UART2 TX ring and
+   SYS_CONSOLE_Message() copies there, without the print buffer. Needs
+   SYS_CONSOLE_PRINT_LITE. Devices without writeReserve format into a
+   SYS_CONSOLE_PRINT_FALLBACK_SIZE buffer instead, longer prints are cut. */
+#ifndef SYS_CONSOLE_PRINT_ZERO_COPY
+#define SYS_CONSOLE_PRINT_ZERO_COPY                 SYS_CONSOLE_PRINT_LITE
+#endif
+#ifndef SYS_CONSOLE_PRINT_FALLBACK_SIZE
+#define SYS_CONSOLE_PRINT_FALLBACK_SIZE             (160U)
+#endif
 
 
 #define SYS_CONSOLE_INDEX_0                       0
@@ -99,7 +114,23 @@ extern "C" {
 
 /* TIME System Service Configuration Options */
 #define SYS_TIME_INDEX_0                            (0)
+#ifndef SYS_TIME_MAX_TIMERS
 #define SYS_TIME_MAX_TIMERS                         (5)
+#endif
+/* Active timers are kept in a binary min-heap of absolute deadlines
+   (O(log n) start, stop and expiry) instead of the sorted delta list
+   (O(n) start and stop) */
+#ifndef SYS_TIME_TIMER_HEAP
+#define SYS_TIME_TIMER_HEAP                         (1)
+#endif
+/* Deferred callbacks (SYS_TIME_CallbackRegisterDeferredMS()): queue size,
+   power of two, and callbacks run per SYS_TIME_DeferredTasks() call */
+#ifndef SYS_TIME_DEFERRED_QUEUE_SIZE
+#define SYS_TIME_DEFERRED_QUEUE_SIZE                (8)
+#endif
+#ifndef SYS_TIME_DEFERRED_BUDGET
+#define SYS_TIME_DEFERRED_BUDGET                    (2)
+#endif
 #define SYS_TIME_HW_COUNTER_WIDTH                   (32)
 #define SYS_TIME_HW_COUNTER_PERIOD                  (4294967295U)
 #define SYS_TIME_HW_COUNTER_HALF_PERIOD             (SYS_TIME_HW_COUNTER_PERIOD>>1)
@@ -115,8 +146,10 @@ extern "C" {
 // *****************************************************************************
 /* I2C Driver Instance 0 Configuration Options */
 #define DRV_I2C_INDEX_0                       0
-#define DRV_I2C_CLIENTS_NUMBER_IDX0           1
-#define DRV_I2C_QUEUE_SIZE_IDX0               2
+#define DRV_I2C_CLIENTS_NUMBER_IDX0           2
+#ifndef DRV_I2C_QUEUE_SIZE_IDX0
+#define DRV_I2C_QUEUE_SIZE_IDX0               8
+#endif
 #define DRV_I2C_CLOCK_SPEED_IDX0              100000
 
 /* I2C Driver Common Configuration Options */
@@ -232,6 +232,81 @@ typedef enum
 
 typedef void (*DRV_I2C_TRANSFER_EVENT_HANDLER )( DRV_I2C_TRANSFER_EVENT event, DRV_I2C_TRANSFER_HANDLE transferHandle, uintptr_t context );
 
+// *****************************************************************************
+/* I2C Driver Batch Item
+
+  Summary:
+    One transfer of a batch added by DRV_I2C_BatchTransferAdd.
+
+  Description:
+    An item with writeSize of 0 is a read, an item with readSize of 0 is a
+    write and an item with both sizes non-zero is a write followed by a read
+    with repeated START, as done by DRV_I2C_WriteReadTransferAdd.
+
+  Remarks:
+    The buffers must stay valid until the batch has completed.
+*/
+
+typedef struct
+{
+    /* Slave address */
+    uint16_t                address;
+
+    /* Data to be written, NULL when writeSize is 0 */
+    void*                   writeBuffer;
+
+    /* Number of bytes to be written */
+    size_t                  writeSize;
+
+    /* Buffer for the data read, NULL when readSize is 0 */
+    void*                   readBuffer;
+
+    /* Number of bytes to be read */
+    size_t                  readSize;
+
+} DRV_I2C_BATCH_ITEM;
+
+// *****************************************************************************
+/* I2C Driver Batch
+
+  Summary:
+    List of transfers executed back to back with a single completion event.
+
+  Description:
+    The client sets items and nItems. The driver starts each item from the
+    I2C interrupt as soon as the previous one has completed and updates the
+    other members. Times are in core timer ticks (SYSCLK/2).
+
+  Remarks:
+    The driver resets nDone, busTicks and gapTicks when the batch is added.
+    The batch object must stay valid until the batch has completed.
+*/
+
+typedef struct
+{
+    /* Transfers in execution order */
+    DRV_I2C_BATCH_ITEM*     items;
+
+    /* Number of items */
+    size_t                  nItems;
+
+    /* Number of items completed without error. After a
+     * DRV_I2C_TRANSFER_EVENT_ERROR the item items[nDone] is the one that
+     * failed, the items after it were not started. */
+    size_t                  nDone;
+
+    /* Sum of item durations, from the start of the item by the PLIB to its
+     * completion interrupt */
+    uint32_t                busTicks;
+
+    /* Sum of the times from completion of an item to the start of the next */
+    uint32_t                gapTicks;
+
+    /* Driver internal: core timer at the start of the current item */
+    uint32_t                itemStart;
+
+} DRV_I2C_BATCH;
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -506,6 +581,43 @@ void DRV_I2C_Close( const DRV_HANDLE handle );
 
 bool DRV_I2C_TransferSetup( const DRV_HANDLE handle, DRV_I2C_TRANSFER_SETUP* setup);
 
+// *****************************************************************************
+/*
+  Function:
+    uint32_t DRV_I2C_TransferSetupCountGet ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns how many times the driver instance changed the bus clock speed.
+
+  Description:
+    Each client keeps its own transfer setup (see DRV_I2C_TransferSetup).
+    Before a queued transfer is started, the driver reprograms the PLIB only
+    if the owning client uses a different clock speed than the previous
+    transfer. This function returns the number of such reconfigurations
+    since DRV_I2C_Initialize for the instance the client belongs to.
+
+  Preconditions:
+    DRV_I2C_Open must have been called to obtain a valid opened device handle.
+
+  Parameters:
+    handle      - A valid open-instance handle, returned from the driver's
+                   open routine
+
+  Returns:
+    Number of clock speed changes, 0 for an invalid handle.
+
+  Example:
+    <code>
+        uint32_t changes = DRV_I2C_TransferSetupCountGet ( myI2CHandle );
+    </code>
+
+  Remarks:
+    Clients sharing a clock speed can be interleaved in the queue without
+    any reconfiguration. Group transfers by speed to keep this count low.
+*/
+
+uint32_t DRV_I2C_TransferSetupCountGet( const DRV_HANDLE handle );
+
 
 // *****************************************************************************
 /* Function:
@@ -899,6 +1011,76 @@ void DRV_I2C_WriteReadTransferAdd (
     DRV_I2C_TRANSFER_HANDLE * const transferHandle
 );
 
+// *****************************************************************************
+/* Function:
+    void DRV_I2C_BatchTransferAdd(
+        const DRV_HANDLE handle,
+        DRV_I2C_BATCH * const batch,
+        DRV_I2C_TRANSFER_HANDLE * const transferHandle
+    )
+
+  Summary:
+    Queues a batch of transfers that completes with a single event.
+
+  Description:
+    The batch takes one entry of the driver queue. When it reaches the head
+    of the queue its items are executed in order, each one started from the
+    I2C interrupt right after the previous one has completed. The client
+    event handler is called once: with DRV_I2C_TRANSFER_EVENT_COMPLETE after
+    the last item, or with DRV_I2C_TRANSFER_EVENT_ERROR after the first item
+    that failed (batch->nDone tells which one). DRV_I2C_ErrorGet returns the
+    error of that item.
+
+    All items use the transfer setup (clock speed) of the client.
+
+  Precondition:
+    DRV_I2C_Open must have been called to obtain a valid opened device handle.
+
+  Parameters:
+    handle - A valid open-instance handle, returned from the driver's open routine
+    DRV_I2C_Open function.
+
+    batch - Batch with items and nItems set. Each item must have a non-zero
+    writeSize or readSize, with a buffer for each non-zero size.
+
+    transferHandle - Pointer to an argument that will contain the return
+    transfer handle. This will be DRV_I2C_TRANSFER_HANDLE_INVALID if the
+    function was not successful.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    uint8_t reg = 0;
+    uint8_t temp[2];
+    DRV_I2C_BATCH_ITEM items[2] = {
+        { 0x48, &reg, 1, &temp[0], 1 },
+        { 0x49, NULL, 0, &temp[1], 1 },
+    };
+    DRV_I2C_BATCH batch = { .items = items, .nItems = 2 };
+    DRV_I2C_TRANSFER_HANDLE transferHandle;
+
+    DRV_I2C_BatchTransferAdd(myI2CHandle, &batch, &transferHandle);
+
+    if(transferHandle == DRV_I2C_TRANSFER_HANDLE_INVALID)
+    {
+
+    }
+    </code>
+
+  Remarks:
+    Same calling rules as DRV_I2C_WriteReadTransferAdd. Transfers of other
+    clients queued after the batch wait until the whole batch has completed.
+    This function is available only in the asynchronous mode.
+*/
+
+void DRV_I2C_BatchTransferAdd(
+    const DRV_HANDLE handle,
+    DRV_I2C_BATCH * const batch,
+    DRV_I2C_TRANSFER_HANDLE * const transferHandle
+);
+
 // *****************************************************************************
 /* Function:
     void DRV_I2C_TransferEventHandlerSet
@@ -231,6 +231,9 @@ typedef struct
     /* Pointer to the buffer pool */
     uintptr_t                               transferObjPool;
 
+    /* Storage for the transfer queue ring, transferObjPoolSize pointers */
+    uintptr_t                               transferQueue;
+
 
     const DRV_I2C_INTERRUPT_SOURCES*        interruptSources;
 
@@ -214,32 +214,58 @@ static void lDRV_I2C_ResourceUnlock(DRV_I2C_OBJ * dObj)
     }
 }
 
+/* The transfer object pool is a free list (linked through the next member)
+ * plus a FIFO ring of queued objects. Get, put, enqueue and dequeue are
+ * O(1); only DRV_I2C_QueuePurge() walks the ring. All of them are called
+ * either with lDRV_I2C_ResourceLock() held or from the I2C interrupt, so the
+ * I2C interrupt sources are disabled while the pool is modified. */
+
+static void lDRV_I2C_TransferObjFree(DRV_I2C_OBJ* dObj, DRV_I2C_TRANSFER_OBJ* transferObj)
+{
+    transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_FREE;
+    transferObj->inUse = false;
+    transferObj->next = dObj->transferObjFree;
+    dObj->transferObjFree = transferObj;
+}
+
 static DRV_I2C_TRANSFER_OBJ* lDRV_I2C_FreeTransferObjGet(DRV_I2C_CLIENT_OBJ* clientObj)
 {
-    uint32_t index;
     DRV_I2C_OBJ* dObj = (DRV_I2C_OBJ* )&gDrvI2CObj[clientObj->drvIndex];
-    DRV_I2C_TRANSFER_OBJ* pTransferObj = dObj->transferObjPool;
+    DRV_I2C_TRANSFER_OBJ* pTransferObj = dObj->transferObjFree;
+    uint32_t index;
 
-    for (index = 0; index < dObj->transferObjPoolSize; index++)
+    if (pTransferObj == NULL)
     {
-        if (pTransferObj[index].inUse == false)
-        {
-            pTransferObj[index].inUse = true;
-            pTransferObj[index].next = NULL;
+        return NULL;
+    }
 
-            /* Generate a unique buffer handle consisting of an incrementing
-             * token counter, driver index and the buffer index.
-             */
-            pTransferObj[index].transferHandle = (DRV_I2C_TRANSFER_HANDLE)lDRV_I2C_MAKE_HANDLE(
-                dObj->i2cTokenCount, (uint8_t)clientObj->drvIndex, (uint8_t)index);
+    dObj->transferObjFree = pTransferObj->next;
+    pTransferObj->inUse = true;
+    pTransferObj->next = NULL;
 
-            /* Update the token for next time */
-            dObj->i2cTokenCount = lDRV_I2C_UPDATE_TOKEN(dObj->i2cTokenCount);
+    /* Generate a unique buffer handle consisting of an incrementing
+     * token counter, driver index and the buffer index.
+     */
+    index = (uint32_t)(pTransferObj - dObj->transferObjPool);
+    pTransferObj->transferHandle = (DRV_I2C_TRANSFER_HANDLE)lDRV_I2C_MAKE_HANDLE(
+        dObj->i2cTokenCount, (uint8_t)clientObj->drvIndex, (uint8_t)index);
 
-            return &pTransferObj[index];
-        }
+    /* Update the token for next time */
+    dObj->i2cTokenCount = lDRV_I2C_UPDATE_TOKEN(dObj->i2cTokenCount);
+
+    return pTransferObj;
+}
+
+static inline uint32_t lDRV_I2C_QueueIndex(DRV_I2C_OBJ* dObj, uint32_t offset)
+{
+    uint32_t index = dObj->transferQueueHead + offset;
+
+    if (index >= dObj->transferObjPoolSize)
+    {
+        index -= dObj->transferObjPoolSize;
     }
-    return NULL;
+
+    return index;
 }
 
 static bool lDRV_I2C_TransferObjAddToList(
@@ -247,65 +273,37 @@ static bool lDRV_I2C_TransferObjAddToList(
     DRV_I2C_TRANSFER_OBJ* transferObj
 )
 {
-    DRV_I2C_TRANSFER_OBJ** pTransferObjList;
-    bool isFirstTransferInList = false;
-
-    pTransferObjList = (DRV_I2C_TRANSFER_OBJ**)&(dObj->transferObjList);
-
-    // Is the buffer object list empty?
-    if (*pTransferObjList == NULL)
-    {
-        *pTransferObjList = transferObj;
-        isFirstTransferInList = true;
-    }
-    else
-    {
-        // List is not empty. Iterate to the end of the buffer object list.
-        while (*pTransferObjList != NULL)
-        {
-            if ((*pTransferObjList)->next == NULL)
-            {
-                // End of the list reached, add the buffer here.
-                (*pTransferObjList)->next = transferObj;
-                break;
-            }
-            else
-            {
-                pTransferObjList = (DRV_I2C_TRANSFER_OBJ**)&((*pTransferObjList)->next);
-            }
-        }
-    }
+    /* The ring has as many entries as the pool has objects, so an object
+     * obtained from the free list always fits */
+    dObj->transferQueue[lDRV_I2C_QueueIndex(dObj, dObj->transferQueueCount)] = transferObj;
+    dObj->transferQueueCount++;
 
-    return isFirstTransferInList;
+    return (dObj->transferQueueCount == 1U);
 }
 
 static DRV_I2C_TRANSFER_OBJ* lDRV_I2C_TransferObjListGet( DRV_I2C_OBJ* dObj )
 {
     DRV_I2C_TRANSFER_OBJ* pTransferObj = NULL;
 
-    // Return the element at the head of the linked list
-    pTransferObj = (DRV_I2C_TRANSFER_OBJ*)dObj->transferObjList;
+    // Return the element at the head of the ring
+    if (dObj->transferQueueCount != 0U)
+    {
+        pTransferObj = dObj->transferQueue[dObj->transferQueueHead];
+    }
 
     return pTransferObj;
 }
 
 static void lDRV_I2C_RemoveTransferObjFromList( DRV_I2C_OBJ* dObj )
 {
-    DRV_I2C_TRANSFER_OBJ** pTransferObjList;
-
-    pTransferObjList = (DRV_I2C_TRANSFER_OBJ**)&(dObj->transferObjList);
-
-    // Remove the element at the head of the linked list
-    if (*pTransferObjList != NULL)
+    // Remove the element at the head of the ring and return it to the free list
+    if (dObj->transferQueueCount != 0U)
     {
-        /* Save the buffer object to be removed. Set the next buffer object as
-         * the new head of the linked list. Reset the removed buffer object. */
+        DRV_I2C_TRANSFER_OBJ* temp = dObj->transferQueue[dObj->transferQueueHead];
 
-        DRV_I2C_TRANSFER_OBJ* temp = *pTransferObjList;
-        *pTransferObjList = (*pTransferObjList)->next;
-        temp->currentState = DRV_I2C_TRANSFER_OBJ_IS_FREE;
-        temp->next = NULL;
-        temp->inUse = false;
+        dObj->transferQueueHead = lDRV_I2C_QueueIndex(dObj, 1U);
+        dObj->transferQueueCount--;
+        lDRV_I2C_TransferObjFree(dObj, temp);
     }
 }
 
@@ -314,35 +312,31 @@ static void lDRV_I2C_RemoveClientTransfersFromList(
     DRV_I2C_CLIENT_OBJ* clientObj
 )
 {
-    DRV_I2C_TRANSFER_OBJ** pTransferObjList;
-    DRV_I2C_TRANSFER_OBJ* delTransferObj = NULL;
-
-    pTransferObjList = (DRV_I2C_TRANSFER_OBJ**)&(dObj->transferObjList);
+    DRV_I2C_TRANSFER_OBJ* transferObj;
+    uint32_t count = dObj->transferQueueCount;
+    uint32_t kept = 0;
+    uint32_t i;
 
-    while (*pTransferObjList != NULL)
+    /* Compact the ring in place, keeping the order of the remaining objects */
+    for (i = 0; i < count; i++)
     {
+        transferObj = dObj->transferQueue[lDRV_I2C_QueueIndex(dObj, i)];
+
         // Do not remove the buffer object that is already in process
-        if (((*pTransferObjList)->clientHandle == clientObj->clientHandle) &&
-            ((*pTransferObjList)->currentState == DRV_I2C_TRANSFER_OBJ_IS_IN_QUEUE))
+        if ((transferObj->clientHandle == clientObj->clientHandle) &&
+            (transferObj->currentState == DRV_I2C_TRANSFER_OBJ_IS_IN_QUEUE))
         {
-            // Save the node to be deleted off the list
-            delTransferObj = *pTransferObjList;
-
-            // Update the current node to point to the deleted node's next
-            *pTransferObjList = (DRV_I2C_TRANSFER_OBJ*)(*pTransferObjList)->next;
-
-            // Reset the deleted node
-            delTransferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_FREE;
-            delTransferObj->event = DRV_I2C_TRANSFER_EVENT_COMPLETE;
-            delTransferObj->next = NULL;
-            delTransferObj->inUse = false;
+            transferObj->event = DRV_I2C_TRANSFER_EVENT_COMPLETE;
+            lDRV_I2C_TransferObjFree(dObj, transferObj);
         }
         else
         {
-            // Move to the next node
-            pTransferObjList = (DRV_I2C_TRANSFER_OBJ**)&((*pTransferObjList)->next);
+            dObj->transferQueue[lDRV_I2C_QueueIndex(dObj, kept)] = transferObj;
+            kept++;
         }
     }
+
+    dObj->transferQueueCount = kept;
 }
 
 static void lDRV_I2C_ClientCallback(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ* clientObj, DRV_I2C_TRANSFER_OBJ* transferObj)
@@ -350,8 +344,7 @@ static void lDRV_I2C_ClientCallback(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ* clien
     DRV_I2C_TRANSFER_EVENT event;
     DRV_I2C_TRANSFER_HANDLE transferHandle;
 
-    transferObj->errors = dObj->i2cPlib->errorGet();
-
+    /* transferObj->errors was set by the caller */
     if(transferObj->errors == DRV_I2C_ERROR_NONE)
     {
         transferObj->event = DRV_I2C_TRANSFER_EVENT_COMPLETE;
@@ -375,12 +368,120 @@ static void lDRV_I2C_ClientCallback(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ* clien
     {
         dObj->interruptNestingCount ++;
 
+        I2C_LAT_MARK(I2C_LAT_POINT_CLIENT_CB);
         clientObj->eventHandler(event, transferHandle, clientObj->context);
 
         dObj->interruptNestingCount -- ;
     }
 }
 
+static void lDRV_I2C_TransferSetupApply(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ* clientObj)
+{
+    /* Reprogram the PLIB only when the client owning the next transfer uses a
+     * different clock speed than the one currently set. Clients sharing a
+     * speed can be interleaved without touching the baud rate generator. */
+    if (dObj->currentTransferSetup.clockSpeed != clientObj->transferSetup.clockSpeed)
+    {
+        /* Keep the old setting if the PLIB rejected the new one, so that the
+         * next transfer of this client tries again */
+        if (dObj->i2cPlib->transferSetup(&clientObj->transferSetup, 0) == true)
+        {
+            dObj->currentTransferSetup.clockSpeed = clientObj->transferSetup.clockSpeed;
+            dObj->transferSetupCount++;
+        }
+    }
+}
+
+static bool lDRV_I2C_TransferObjStart(DRV_I2C_OBJ* dObj, DRV_I2C_TRANSFER_OBJ* transferObj)
+{
+    DRV_I2C_TRANSFER_OBJ_FLAGS flag = transferObj->flag;
+
+#if I2C_LATENCY_ENABLE
+    if ((flag != DRV_I2C_TRANSFER_OBJ_FLAG_BATCH) || (transferObj->batch->nDone == 0U))
+    {
+        I2C_LAT_TransferBegin(transferObj->submitTicks);
+    }
+#endif
+
+    if (flag == DRV_I2C_TRANSFER_OBJ_FLAG_BATCH)
+    {
+        /* Load the next item of the batch into the transfer object */
+        const DRV_I2C_BATCH_ITEM* item = &transferObj->batch->items[transferObj->batch->nDone];
+
+        transferObj->slaveAddress = item->address;
+        transferObj->writeBuffer  = item->writeBuffer;
+        transferObj->writeSize    = item->writeSize;
+        transferObj->readBuffer   = item->readBuffer;
+        transferObj->readSize     = item->readSize;
+
+        if (item->writeSize == 0U)
+        {
+            flag = DRV_I2C_TRANSFER_OBJ_FLAG_RD;
+        }
+        else if (item->readSize == 0U)
+        {
+            flag = DRV_I2C_TRANSFER_OBJ_FLAG_WR;
+        }
+        else
+        {
+            flag = DRV_I2C_TRANSFER_OBJ_FLAG_WR_RD;
+        }
+
+        transferObj->batch->itemStart = _CP0_GET_COUNT();
+    }
+
+    transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_PROCESSING;
+
+    switch(flag)
+    {
+        case DRV_I2C_TRANSFER_OBJ_FLAG_RD:
+            return dObj->i2cPlib->read_t(transferObj->slaveAddress, transferObj->readBuffer, transferObj->readSize);
+
+        case DRV_I2C_TRANSFER_OBJ_FLAG_WR:
+            return dObj->i2cPlib->write_t(transferObj->slaveAddress, transferObj->writeBuffer, transferObj->writeSize);
+
+        case DRV_I2C_TRANSFER_OBJ_FLAG_WR_RD:
+            return dObj->i2cPlib->writeRead(transferObj->slaveAddress, transferObj->writeBuffer, transferObj->writeSize, transferObj->readBuffer, transferObj->readSize);
+
+        default:
+            /* Execution should never enter the default case */
+            return true;
+    }
+}
+
+/* Called from the PLIB callback when an item of a batch has completed without
+ * error. Starts the next item and returns true, or returns false when the batch
+ * is finished (last item done or the next one could not be started) and the
+ * client has to be notified. */
+static bool lDRV_I2C_BatchNext(DRV_I2C_OBJ* dObj, DRV_I2C_TRANSFER_OBJ* transferObj)
+{
+    DRV_I2C_BATCH* batch = transferObj->batch;
+    uint32_t itemEnd = _CP0_GET_COUNT();
+
+    batch->busTicks += itemEnd - batch->itemStart;
+    batch->nDone++;
+
+    if (batch->nDone == batch->nItems)
+    {
+        return false;
+    }
+
+    if (lDRV_I2C_TransferObjStart(dObj, transferObj) == false)
+    {
+        transferObj->errors = dObj->i2cPlib->errorGet();
+        if (transferObj->errors == DRV_I2C_ERROR_NONE)
+        {
+            /* The batch is not complete, report it as failed */
+            transferObj->errors = DRV_I2C_ERROR_BUS;
+        }
+        return false;
+    }
+
+    batch->gapTicks += batch->itemStart - itemEnd;
+
+    return true;
+}
+
 static void lDRV_I2C_NextTransferInitiate(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ* clientObj)
 {
     DRV_I2C_TRANSFER_OBJ* transferObj = NULL;
@@ -400,36 +501,12 @@ static void lDRV_I2C_NextTransferInitiate(DRV_I2C_OBJ* dObj, DRV_I2C_CLIENT_OBJ*
             clientObj = &((DRV_I2C_CLIENT_OBJ *)gDrvI2CObj[((transferObj->clientHandle & DRV_I2C_INSTANCE_MASK) >> 8)].clientObjPool)
                         [transferObj->clientHandle & DRV_I2C_INDEX_MASK];
 
-            /* Check if the transfer setup for this client is different than the current transfer setup */
-            if (dObj->currentTransferSetup.clockSpeed != clientObj->transferSetup.clockSpeed)
-            {
-                /* Set the new transfer setup */
-                (void) dObj->i2cPlib->transferSetup(&clientObj->transferSetup, 0);
-
-                dObj->currentTransferSetup.clockSpeed = clientObj->transferSetup.clockSpeed;
-            }
+            lDRV_I2C_TransferSetupApply(dObj, clientObj);
 
-            switch(transferObj->flag)
-            {
-                case DRV_I2C_TRANSFER_OBJ_FLAG_RD:
-                    transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_PROCESSING;
-                    transferStatus = dObj->i2cPlib->read_t(transferObj->slaveAddress, transferObj->readBuffer, transferObj->readSize);
-                    break;
-
-                case DRV_I2C_TRANSFER_OBJ_FLAG_WR:
-                    transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_PROCESSING;
-                    transferStatus = dObj->i2cPlib->write_t(transferObj->slaveAddress, transferObj->writeBuffer, transferObj->writeSize);
-                    break;
-                    case DRV_I2C_TRANSFER_OBJ_FLAG_WR_RD:
-                    transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_PROCESSING;
-                    transferStatus = dObj->i2cPlib->writeRead(transferObj->slaveAddress, transferObj->writeBuffer, transferObj->writeSize, transferObj->readBuffer, transferObj->readSize);
-                    break;
-                default:
-                    /* Execution should never enter the default case */
-                    break;
-            }
+            transferStatus = lDRV_I2C_TransferObjStart(dObj, transferObj);
             if (transferStatus == false)
             {
+                transferObj->errors = dObj->i2cPlib->errorGet();
                 lDRV_I2C_ClientCallback(dObj, clientObj, transferObj);
             }
         }
@@ -449,6 +526,8 @@ static void lDRV_I2C_PLibCallbackHandler( uintptr_t contextHandle )
         return;
     }
 
+    I2C_LAT_MARK(I2C_LAT_POINT_PLIB_CB);
+
     // Get the transfer object at the head of the list
     transferObj = lDRV_I2C_TransferObjListGet(dObj);
 
@@ -456,9 +535,19 @@ static void lDRV_I2C_PLibCallbackHandler( uintptr_t contextHandle )
     clientObj = &((DRV_I2C_CLIENT_OBJ *)gDrvI2CObj[((transferObj->clientHandle & DRV_I2C_INSTANCE_MASK) >> 8)].clientObjPool)
                 [transferObj->clientHandle & DRV_I2C_INDEX_MASK];
 
+    transferObj->errors = dObj->i2cPlib->errorGet();
+
     /* Check if the client that submitted the request is active? */
     if (clientObj->clientHandle == transferObj->clientHandle)
     {
+        /* Items of a batch follow each other without a client callback */
+        if ((transferObj->flag == DRV_I2C_TRANSFER_OBJ_FLAG_BATCH) &&
+            (transferObj->errors == DRV_I2C_ERROR_NONE) &&
+            (lDRV_I2C_BatchNext(dObj, transferObj) == true))
+        {
+            return;
+        }
+
         lDRV_I2C_ClientCallback(dObj, clientObj, transferObj);
     }
     else
@@ -481,6 +570,7 @@ SYS_MODULE_OBJ DRV_I2C_Initialize(
 )
 {
     DRV_I2C_OBJ* dObj     = NULL;
+    uint32_t index;
 /* MISRA C-2012 Rule 11.3, 11.8 deviated below. Deviation record ID -  H3_MISRAC_2012_R_11_3_DR_1 & H3_MISRAC_2012_R_11_8_DR_1*/
 
     DRV_I2C_INIT* i2cInit = (DRV_I2C_INIT*)init;
@@ -499,6 +589,13 @@ SYS_MODULE_OBJ DRV_I2C_Initialize(
         return SYS_MODULE_OBJ_INVALID;
     }
 
+    /* The transfer handle holds the pool index in DRV_I2C_INDEX_MASK */
+    if((i2cInit->transferObjPoolSize == 0U) ||
+       (i2cInit->transferObjPoolSize > (DRV_I2C_INDEX_MASK + 1U)))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
     /* Allocate the driver object */
     dObj = &gDrvI2CObj[drvIndex];
 
@@ -521,13 +618,24 @@ SYS_MODULE_OBJ DRV_I2C_Initialize(
     dObj->nClientsMax                       = i2cInit->numClients;
     dObj->transferObjPool                   = (DRV_I2C_TRANSFER_OBJ*)i2cInit->transferObjPool;
     dObj->transferObjPoolSize               = i2cInit->transferObjPoolSize;
-    dObj->transferObjList                   = (DRV_I2C_TRANSFER_OBJ*)NULL;
+    dObj->transferObjFree                   = (DRV_I2C_TRANSFER_OBJ*)NULL;
+    dObj->transferQueue                     = (DRV_I2C_TRANSFER_OBJ**)i2cInit->transferQueue;
+    dObj->transferQueueHead                 = 0;
+    dObj->transferQueueCount                = 0;
     dObj->nClients                          = 0;
     dObj->isExclusive                       = false;
     dObj->interruptNestingCount             = 0;
     dObj->i2cTokenCount                     = 1;
     dObj->initI2CClockSpeed                 = i2cInit->clockSpeed;
     dObj->currentTransferSetup.clockSpeed   = i2cInit->clockSpeed;
+    dObj->transferSetupCount                = 0;
+
+    /* Put all transfer objects on the free list */
+    for(index = dObj->transferObjPoolSize; index > 0U; index--)
+    {
+        dObj->transferObjPool[index - 1U].inUse = false;
+        lDRV_I2C_TransferObjFree(dObj, &dObj->transferObjPool[index - 1U]);
+    }
 
     /* Register a callback with the underlying PLIB.
      * dObj as a context parameter will be used to distinguish the events
@@ -747,6 +855,21 @@ bool DRV_I2C_TransferSetup( const DRV_HANDLE handle, DRV_I2C_TRANSFER_SETUP* set
     return true;
 }
 
+uint32_t DRV_I2C_TransferSetupCountGet( const DRV_HANDLE handle )
+{
+    DRV_I2C_CLIENT_OBJ* clientObj = NULL;
+
+    /* Validate the driver handle */
+    clientObj = lDRV_I2C_DriverHandleValidate(handle);
+
+    if(clientObj == NULL)
+    {
+        return 0;
+    }
+
+    return gDrvI2CObj[clientObj->drvIndex].transferSetupCount;
+}
+
 DRV_I2C_ERROR DRV_I2C_ErrorGet( const DRV_I2C_TRANSFER_HANDLE transferHandle )
 {
     DRV_I2C_OBJ* dObj = NULL;
@@ -787,6 +910,30 @@ DRV_I2C_ERROR DRV_I2C_ErrorGet( const DRV_I2C_TRANSFER_HANDLE transferHandle )
     return errors;
 }
 
+static bool lDRV_I2C_BatchValidate(const DRV_I2C_BATCH* batch)
+{
+    size_t i;
+
+    if ((batch == NULL) || (batch->items == NULL) || (batch->nItems == 0U))
+    {
+        return false;
+    }
+
+    for (i = 0; i < batch->nItems; i++)
+    {
+        const DRV_I2C_BATCH_ITEM* item = &batch->items[i];
+
+        if (((item->writeSize == 0U) && (item->readSize == 0U)) ||
+            ((item->writeSize != 0U) && (item->writeBuffer == NULL)) ||
+            ((item->readSize != 0U) && (item->readBuffer == NULL)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static void lDRV_I2C_WriteReadTransferAdd (
     const DRV_HANDLE handle,
     const uint16_t address,
@@ -795,7 +942,8 @@ static void lDRV_I2C_WriteReadTransferAdd (
     void* const readBuffer,
     const size_t readSize,
     DRV_I2C_TRANSFER_HANDLE* const transferHandle,
-    DRV_I2C_TRANSFER_OBJ_FLAGS transferFlags
+    DRV_I2C_TRANSFER_OBJ_FLAGS transferFlags,
+    DRV_I2C_BATCH* const batch
 )
 {
     DRV_I2C_CLIENT_OBJ* clientObj = NULL;
@@ -832,6 +980,13 @@ static void lDRV_I2C_WriteReadTransferAdd (
             return;
         }
     }
+    else if (transferFlags == DRV_I2C_TRANSFER_OBJ_FLAG_BATCH)
+    {
+        if(lDRV_I2C_BatchValidate(batch) == false)
+        {
+            return;
+        }
+    }
     else
     {
         if((writeSize == 0U) || (writeBuffer == NULL) || (readSize == 0U) || (readBuffer == NULL))
@@ -869,6 +1024,17 @@ static void lDRV_I2C_WriteReadTransferAdd (
     transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_IN_QUEUE;
     transferObj->event        = DRV_I2C_TRANSFER_EVENT_PENDING;
     transferObj->flag         = transferFlags;
+    transferObj->batch        = batch;
+#if I2C_LATENCY_ENABLE
+    transferObj->submitTicks  = _CP0_GET_COUNT();
+#endif
+
+    if (batch != NULL)
+    {
+        batch->nDone    = 0;
+        batch->busTicks = 0;
+        batch->gapTicks = 0;
+    }
 
     *transferHandle = transferObj->transferHandle;
 
@@ -877,51 +1043,11 @@ static void lDRV_I2C_WriteReadTransferAdd (
     {
         /* This is the first request in the queue, hence initiate a PLIB transfer */
 
-        /* Check if the transfer setup for this client is different than the current transfer setup */
-        if (dObj->currentTransferSetup.clockSpeed != clientObj->transferSetup.clockSpeed)
-        {
-            /* Set the new transfer setup */
-            (void) dObj->i2cPlib->transferSetup(&clientObj->transferSetup, 0);
+        lDRV_I2C_TransferSetupApply(dObj, clientObj);
 
-            dObj->currentTransferSetup.clockSpeed = clientObj->transferSetup.clockSpeed;
-        }
-
-        transferObj->currentState = DRV_I2C_TRANSFER_OBJ_IS_PROCESSING;
-
-        if (transferFlags == DRV_I2C_TRANSFER_OBJ_FLAG_RD)
+        if (lDRV_I2C_TransferObjStart(dObj, transferObj) == false)
         {
-            if (dObj->i2cPlib->read_t(
-                transferObj->slaveAddress,
-                transferObj->readBuffer,
-                transferObj->readSize
-            ) == false)
-            {
-                transferError = true;
-            }
-        }
-        else if (transferFlags == DRV_I2C_TRANSFER_OBJ_FLAG_WR)
-        {
-            if (dObj->i2cPlib->write_t(
-                transferObj->slaveAddress,
-                transferObj->writeBuffer,
-                transferObj->writeSize
-            ) == false)
-            {
-                transferError = true;
-            }
-        }
-        else
-        {
-            if (dObj->i2cPlib->writeRead(
-                transferObj->slaveAddress,
-                transferObj->writeBuffer,
-                transferObj->writeSize,
-                transferObj->readBuffer,
-                transferObj->readSize
-            ) == false)
-            {
-                transferError = true;
-            }
+            transferError = true;
         }
 
         if (transferError == true)
@@ -954,7 +1080,7 @@ void DRV_I2C_ReadTransferAdd(
 )
 {
     lDRV_I2C_WriteReadTransferAdd(handle, address, NULL, 0,
-        buffer, size, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_RD);
+        buffer, size, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_RD, NULL);
 }
 
 void DRV_I2C_WriteTransferAdd(
@@ -966,7 +1092,7 @@ void DRV_I2C_WriteTransferAdd(
 )
 {
     lDRV_I2C_WriteReadTransferAdd(handle, address, buffer, size,
-        NULL, 0, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_WR);
+        NULL, 0, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_WR, NULL);
 }
 
 void DRV_I2C_WriteReadTransferAdd (
@@ -980,7 +1106,17 @@ void DRV_I2C_WriteReadTransferAdd (
 )
 {
     lDRV_I2C_WriteReadTransferAdd(handle, address, writeBuffer, writeSize,
-        readBuffer, readSize, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_WR_RD);
+        readBuffer, readSize, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_WR_RD, NULL);
+}
+
+void DRV_I2C_BatchTransferAdd(
+    const DRV_HANDLE handle,
+    DRV_I2C_BATCH* const batch,
+    DRV_I2C_TRANSFER_HANDLE* const transferHandle
+)
+{
+    lDRV_I2C_WriteReadTransferAdd(handle, 0, NULL, 0,
+        NULL, 0, transferHandle, DRV_I2C_TRANSFER_OBJ_FLAG_BATCH, batch);
 }
 
 void DRV_I2C_QueuePurge(const DRV_HANDLE handle)
@@ -50,6 +50,7 @@
 // *****************************************************************************
 #include "driver/i2c/drv_i2c_definitions.h"
 #include "osal/osal.h"
+#include "i2c_latency.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -91,6 +92,9 @@ typedef enum
     /* Indicates this buffer was submitted by a force write function */
     DRV_I2C_TRANSFER_OBJ_FLAG_WR_FRCD = 1 << 3,
 
+    /* Indicates this buffer is a batch of transfers (DRV_I2C_BatchTransferAdd) */
+    DRV_I2C_TRANSFER_OBJ_FLAG_BATCH = 1 << 4,
+
 } DRV_I2C_TRANSFER_OBJ_FLAGS;
 
 // *****************************************************************************
@@ -168,7 +172,16 @@ typedef struct DRV_I2C_TRANSFER_OBJ_T
     /* Errors associated with the I2C transfer */
     volatile DRV_I2C_ERROR          errors;
 
-    /* Next buffer pointer */
+    /* Batch of transfers, when flag is DRV_I2C_TRANSFER_OBJ_FLAG_BATCH. The
+     * fields above then describe its current item. */
+    DRV_I2C_BATCH*                  batch;
+
+#if I2C_LATENCY_ENABLE
+    /* Core timer count when the transfer was added (i2c_latency.h) */
+    uint32_t                        submitTicks;
+#endif
+
+    /* Next object in the free list (not used while the object is queued) */
     struct DRV_I2C_TRANSFER_OBJ_T*   next;
 
 } DRV_I2C_TRANSFER_OBJ;
@@ -212,6 +225,9 @@ typedef struct
     /* Current transfer setup will be used to verify change in the transfer setup by client */
     DRV_I2C_TRANSFER_SETUP      currentTransferSetup;
 
+    /* Number of times the PLIB was reconfigured for a different client clock speed */
+    uint32_t                    transferSetupCount;
+
     /* Interrupt Sources of I2C */
     const DRV_I2C_INTERRUPT_SOURCES* interruptSources;
 
@@ -224,8 +240,18 @@ typedef struct
     /* Pointer to the transfer pool */
     DRV_I2C_TRANSFER_OBJ*       transferObjPool;
 
-    /* Linked list of transfer objects */
-    DRV_I2C_TRANSFER_OBJ*       transferObjList;
+    /* Free transfer objects, linked through their next member */
+    DRV_I2C_TRANSFER_OBJ*       transferObjFree;
+
+    /* FIFO ring of queued transfer objects with transferObjPoolSize entries.
+     * The entry at transferQueueHead is the one processed by the PLIB. */
+    DRV_I2C_TRANSFER_OBJ**      transferQueue;
+
+    /* Ring index of the oldest queued transfer object */
+    uint32_t                    transferQueueHead;
+
+    /* Number of transfer objects in the ring */
+    uint32_t                    transferQueueCount;
 
     /* Instance specific token counter used to generate unique client/transfer handles */
     uint16_t                    i2cTokenCount;
@@ -112,6 +112,9 @@ static DRV_I2C_CLIENT_OBJ drvI2C0ClientObjPool[DRV_I2C_CLIENTS_NUMBER_IDX0];
 /* I2C Transfer Objects Pool */
 static DRV_I2C_TRANSFER_OBJ drvI2C0TransferObj[DRV_I2C_QUEUE_SIZE_IDX0];
 
+/* I2C Transfer Queue Ring */
+static DRV_I2C_TRANSFER_OBJ* drvI2C0TransferQueue[DRV_I2C_QUEUE_SIZE_IDX0];
+
 /* I2C PLib Interface Initialization */
 static const DRV_I2C_PLIB_INTERFACE drvI2C0PLibAPI = {
 
@@ -169,6 +172,9 @@ static const DRV_I2C_INIT drvI2C0InitData =
     /* I2C Transfer Objects */
     .transferObjPool = (uintptr_t)&drvI2C0TransferObj[0],
 
+    /* I2C Transfer Queue Ring */
+    .transferQueue = (uintptr_t)&drvI2C0TransferQueue[0],
+
     /* I2C interrupt sources */
     .interruptSources = &drvI2C0InterruptSources,
 
@@ -211,6 +217,8 @@ static const SYS_CONSOLE_UART_PLIB_INTERFACE sysConsole0UARTPlibAPI =
     .write_t = (SYS_CONSOLE_UART_PLIB_WRITE)UART2_Write,
     .writeCountGet = (SYS_CONSOLE_UART_PLIB_WRITE_COUNT_GET)UART2_WriteCountGet,
     .writeFreeBufferCountGet = (SYS_CONSOLE_UART_PLIB_WRITE_FREE_BUFFER_COUNT_GET)UART2_WriteFreeBufferCountGet,
+    .writeReserve = (SYS_CONSOLE_UART_PLIB_WRITE_RESERVE)UART2_WriteReserve,
+    .writeCommit = (SYS_CONSOLE_UART_PLIB_WRITE_COMMIT)UART2_WriteCommit,
 };
 
 static const SYS_CONSOLE_UART_INIT_DATA sysConsole0UARTInitData =
@@ -303,6 +311,7 @@ void SYS_Initialize ( void* data )
 
     I2C1_Initialize();
     CORETIMER_Initialize();
+    DMAC_Initialize();
 	UART2_Initialize();
 
 
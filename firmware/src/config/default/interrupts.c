@@ -70,6 +70,7 @@
 void CORE_TIMER_Handler (void);
 void I2C_1_Handler (void);
 void UART_2_Handler (void);
+void DMA_0_Handler (void);
 
 
 // *****************************************************************************
@@ -92,6 +93,11 @@ void __ISR(_UART_2_VECTOR, ipl1SOFT) UART_2_Handler (void)
     UART_2_InterruptHandler();
 }
 
+void __ISR(_DMA_0_VECTOR, ipl1SOFT) DMA_0_Handler (void)
+{
+    DMA0_InterruptHandler();
+}
+
 
 
 
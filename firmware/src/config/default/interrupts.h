@@ -60,6 +60,7 @@
 void CORE_TIMER_InterruptHandler( void );
 void I2C_1_InterruptHandler( void );
 void UART_2_InterruptHandler( void );
+void DMA0_InterruptHandler( void );
 
 
 
@@ -0,0 +1,172 @@
+/*******************************************************************************
+  DMAC PLIB
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_dmac.c
+
+  Summary:
+    DMAC PLIB Implementation File
+
+  Description:
+    None
+
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#include <sys/kmem.h>
+#include "plib_dmac.h"
+#include "interrupts.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DMAC Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    DMAC_CHANNEL_CALLBACK  callback;
+    uintptr_t              context;
+    bool                   inUse;
+} DMAC_CHANNEL_OBJECT;
+
+volatile static DMAC_CHANNEL_OBJECT dmacChannelObj[1];
+
+/* The DMA controller works with physical addresses */
+static uint32_t DMAC_PhysicalAddressGet(const void* addr)
+{
+    return KVA_TO_PA((uint32_t)(uintptr_t)addr);
+}
+
+void DMAC_Initialize( void )
+{
+    /* Enable the DMA module */
+    DMACONSET = _DMACON_ON_MASK;
+
+    /* DMA channel 0 configuration */
+    /* CHPRI = 0, CHAEN = 0 (disable after the block), CHCHN = 0 */
+    DCH0CON = 0x0U;
+
+    /* Start on the UART2 TX request, no abort IRQ, no pattern match */
+    DCH0ECON = ((uint32_t)_UART2_TX_IRQ << _DCH0ECON_CHSIRQ_POSITION) | _DCH0ECON_SIRQEN_MASK;
+
+    /* Clear the channel flags, enable the block complete and address error
+       interrupts */
+    DCH0INT = _DCH0INT_CHBCIE_MASK | _DCH0INT_CHERIE_MASK;
+
+    dmacChannelObj[0].callback = NULL;
+    dmacChannelObj[0].context = 0U;
+    dmacChannelObj[0].inUse = false;
+
+    /* Enable DMA channel 0 interrupt */
+    IEC1SET = _IEC1_DMA0IE_MASK;
+}
+
+void DMAC_ChannelCallbackRegister(DMAC_CHANNEL channel, const DMAC_CHANNEL_CALLBACK eventHandler, const uintptr_t contextHandle)
+{
+    if (channel == DMAC_CHANNEL_0)
+    {
+        dmacChannelObj[channel].callback = eventHandler;
+        dmacChannelObj[channel].context = contextHandle;
+    }
+}
+
+bool DMAC_ChannelTransfer( DMAC_CHANNEL channel, const void *srcAddr, size_t srcSize, const void *destAddr, size_t destSize, size_t cellSize)
+{
+    if ((channel != DMAC_CHANNEL_0) || (dmacChannelObj[channel].inUse == true))
+    {
+        return false;
+    }
+    if ((srcSize == 0U) || (srcSize > UINT16_MAX) || (destSize == 0U) || (destSize > UINT16_MAX) || (cellSize == 0U) || (cellSize > UINT16_MAX))
+    {
+        return false;
+    }
+
+    dmacChannelObj[channel].inUse = true;
+
+    DCH0SSA = DMAC_PhysicalAddressGet(srcAddr);
+    DCH0DSA = DMAC_PhysicalAddressGet(destAddr);
+    DCH0SSIZ = srcSize;
+    DCH0DSIZ = destSize;
+    DCH0CSIZ = cellSize;
+
+    /* Clear the flags of the previous transfer */
+    DCH0INTCLR = 0x000000FFU;
+
+    /* Enable the channel, the transfer waits for the start IRQ */
+    DCH0CONSET = _DCH0CON_CHEN_MASK;
+
+    return true;
+}
+
+void DMAC_ChannelDisable (DMAC_CHANNEL channel)
+{
+    if (channel == DMAC_CHANNEL_0)
+    {
+        DCH0CONCLR = _DCH0CON_CHEN_MASK;
+        dmacChannelObj[channel].inUse = false;
+    }
+}
+
+bool DMAC_ChannelIsBusy (DMAC_CHANNEL channel)
+{
+    return (channel == DMAC_CHANNEL_0) ? dmacChannelObj[channel].inUse : false;
+}
+
+void __attribute__((used)) DMA0_InterruptHandler (void)
+{
+    DMAC_TRANSFER_EVENT event = DMAC_TRANSFER_EVENT_NONE;
+    uint32_t status = DCH0INT;
+
+    if ((status & _DCH0INT_CHERIF_MASK) != 0U)
+    {
+        /* Address error, the channel was disabled by the hardware */
+        event = DMAC_TRANSFER_EVENT_ERROR;
+    }
+    else if ((status & _DCH0INT_CHBCIF_MASK) != 0U)
+    {
+        event = DMAC_TRANSFER_EVENT_COMPLETE;
+    }
+    else
+    {
+        /* Nothing to report */
+    }
+
+    DCH0INTCLR = 0x000000FFU;
+    IFS1CLR = _IFS1_DMA0IF_MASK;
+
+    if (event != DMAC_TRANSFER_EVENT_NONE)
+    {
+        dmacChannelObj[0].inUse = false;
+
+        if (dmacChannelObj[0].callback != NULL)
+        {
+            dmacChannelObj[0].callback(event, dmacChannelObj[0].context);
+        }
+    }
+}
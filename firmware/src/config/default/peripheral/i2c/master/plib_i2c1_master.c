@@ -51,6 +51,7 @@
 #include "device.h"
 #include "plib_i2c1_master.h"
 #include "interrupts.h"
+#include "i2c_latency.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -100,6 +101,7 @@ static void I2C1_TransferSM(void)
     {
         case I2C_STATE_START_CONDITION:
             /* Generate Start Condition */
+            I2C_LAT_MARK(I2C_LAT_POINT_START);
             I2C1CONSET = _I2C1CON_SEN_MASK;
             IEC1SET = _IEC1_I2C1MIE_MASK;
             IEC1SET = _IEC1_I2C1BIE_MASK;
@@ -335,6 +337,11 @@ static void I2C1_TransferSM(void)
             break;
     }
 
+    /* Every state that sets PEN moves to WAIT_STOP_CONDITION_COMPLETE */
+    if (i2c1Obj.state == I2C_STATE_WAIT_STOP_CONDITION_COMPLETE)
+    {
+        I2C_LAT_MARK(I2C_LAT_POINT_STOP);
+    }
 }
 
 
@@ -384,6 +391,7 @@ bool I2C1_Read(uint16_t address, uint8_t* rdata, size_t rlength)
     i2c1Obj.error               = I2C_ERROR_NONE;
     i2c1Obj.state               = I2C_STATE_ADDR_BYTE_1_SEND;
 
+    I2C_LAT_MARK(I2C_LAT_POINT_START);
     I2C1CONSET                  = _I2C1CON_SEN_MASK;
     IEC1SET                     = _IEC1_I2C1MIE_MASK;
     IEC1SET                     = _IEC1_I2C1BIE_MASK;
@@ -412,6 +420,7 @@ bool I2C1_Write(uint16_t address, uint8_t* wdata, size_t wlength)
     i2c1Obj.error               = I2C_ERROR_NONE;
     i2c1Obj.state               = I2C_STATE_ADDR_BYTE_1_SEND;
 
+    I2C_LAT_MARK(I2C_LAT_POINT_START);
     I2C1CONSET                  = _I2C1CON_SEN_MASK;
     IEC1SET                     = _IEC1_I2C1MIE_MASK;
     IEC1SET                     = _IEC1_I2C1BIE_MASK;
@@ -440,6 +449,7 @@ bool I2C1_WriteRead(uint16_t address, uint8_t* wdata, size_t wlength, uint8_t* r
     i2c1Obj.error               = I2C_ERROR_NONE;
     i2c1Obj.state               = I2C_STATE_ADDR_BYTE_1_SEND;
 
+    I2C_LAT_MARK(I2C_LAT_POINT_START);
     I2C1CONSET                  = _I2C1CON_SEN_MASK;
     IEC1SET                     = _IEC1_I2C1MIE_MASK;
     IEC1SET                     = _IEC1_I2C1BIE_MASK;
@@ -471,7 +481,7 @@ bool I2C1_TransferSetup(I2C_TRANSFER_SETUP* setup, uint32_t srcClkFreq )
     i2cClkSpeed = setup->clkSpeed;
 
     /* Maximum I2C clock speed cannot be greater than 1 MHz */
-    if (i2cClkSpeed > 1000000U)
+    if ((i2cClkSpeed == 0U) || (i2cClkSpeed > 1000000U))
     {
         return false;
     }
@@ -492,16 +502,10 @@ bool I2C1_TransferSetup(I2C_TRANSFER_SETUP* setup, uint32_t srcClkFreq )
 
     I2C1BRG = baudValue;
 
-    /* Enable slew rate for 400 kHz clock speed; disable for all other speeds */
-
-    if (i2cClkSpeed == 400000U)
-    {
-        I2C1CONCLR = _I2C1CON_DISSLW_MASK;;
-    }
-    else
-    {
-        I2C1CONSET = _I2C1CON_DISSLW_MASK;;
-    }
+    /* MCC enables slew rate control for 400 kHz. We keep it disabled for
+     * all speeds: on silicon revision A1 RA0/RA1 stop working when DISSLW
+     * is cleared with I2C1 on (errata workaround, see I2C1_Initialize) */
+    I2C1CONSET = _I2C1CON_DISSLW_MASK;
 
     return true;
 }
@@ -550,6 +554,8 @@ void __attribute__((used)) I2C_1_InterruptHandler(void)
 {
     uint32_t iec_bus_reg_read = IEC1;
     uint32_t iec_master_reg_read = IEC1;
+
+    I2C_LAT_MARK(I2C_LAT_POINT_ISR);
     if (((IFS1 & _IFS1_I2C1BIF_MASK) != 0U) &&
          ((iec_bus_reg_read & _IEC1_I2C1BIE_MASK) != 0U))
     {
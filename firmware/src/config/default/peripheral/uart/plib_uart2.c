@@ -38,9 +38,19 @@
 * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
 *******************************************************************************/
 
+#include <string.h>
 #include "device.h"
 #include "plib_uart2.h"
+
+/* 1 moves the TX ring to U2TXREG with DMA channel 0 instead of the TX
+   interrupt (8-bit mode only, 9-bit mode keeps the interrupt) */
+#ifndef UART2_TX_DMA
+#define UART2_TX_DMA                 (0)
+#endif
 #include "interrupts.h"
+#if (UART2_TX_DMA != 0)
+#include "peripheral/dmac/plib_dmac.h"
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -64,6 +74,35 @@ volatile static uint8_t UART2_ReadBuffer[UART2_READ_BUFFER_SIZE];
 
 volatile static uint8_t UART2_WriteBuffer[UART2_WRITE_BUFFER_SIZE];
 
+/* Characters the TX buffer holds. With UTXISEL = 10 (UART2_Initialize()) the
+   TX interrupt is asserted while the buffer is empty, so the handler loads
+   up to this many without polling UTXBF. */
+#define UART2_TX_FIFO_DEPTH          (8U)
+
+static UART2_TX_STATS uart2TxStats;
+
+#if (UART2_TX_DMA != 0)
+/* Longest span of the ring per DMA block. The space of a block is given back
+   to UART2_Write() only when the whole block is in the TX buffer, so a longer
+   block means fewer interrupts but a longer wait for a writer when the ring
+   is full. */
+#define UART2_TX_DMA_BLOCK_MAX       (128U)
+
+/* Bytes of the transfer in flight, 0 while the channel is idle */
+static volatile uint32_t uart2TxDmaSize;
+
+static void UART2_TxDmaHandler(DMAC_TRANSFER_EVENT event, uintptr_t context);
+#endif
+
+/* The ring indices wrap with a mask, both buffer sizes must be powers of two */
+#if ((UART2_READ_BUFFER_SIZE & (UART2_READ_BUFFER_SIZE - 1U)) != 0U) || ((UART2_WRITE_BUFFER_SIZE & (UART2_WRITE_BUFFER_SIZE - 1U)) != 0U)
+#error "UART2 ring buffer sizes must be powers of two"
+#endif
+
+/* Orders the copy into or out of a ring against the index update that hands
+   the bytes over to the ISR (or gives the space back to it) */
+#define UART2_RING_BARRIER()            __asm__ volatile ("" ::: "memory")
+
 #define UART2_IS_9BIT_MODE_ENABLED()    ( (U2MODE) & (_U2MODE_PDSEL0_MASK | _U2MODE_PDSEL1_MASK)) == (_U2MODE_PDSEL0_MASK | _U2MODE_PDSEL1_MASK) ? true:false
 
 void static UART2_ErrorClear( void )
@@ -138,6 +177,15 @@ void UART2_Initialize( void )
 
     uart2Obj.errors = UART_ERROR_NONE;
 
+    uart2TxStats.interrupts = 0U;
+    uart2TxStats.bytes = 0U;
+    uart2TxStats.ticks = 0U;
+
+#if (UART2_TX_DMA != 0)
+    uart2TxDmaSize = 0U;
+    DMAC_ChannelCallbackRegister(DMAC_CHANNEL_0, UART2_TxDmaHandler, 0U);
+#endif
+
     if (UART2_IS_9BIT_MODE_ENABLED())
     {
         uart2Obj.rdBufferSize = UART2_READ_BUFFER_SIZE_9BIT;
@@ -160,12 +208,32 @@ void UART2_Initialize( void )
     IEC1SET = _IEC1_U2RXIE_MASK;
 }
 
+/* Distance of the rate a divider gives from the requested one, UINT32_MAX
+   when the divider does not fit U2BRG */
+static uint32_t UART2_BaudErrorGet(uint32_t clkPerBitFreq, uint32_t divider, uint32_t baud)
+{
+    uint32_t actual;
+
+    if ((divider < 1U) || (divider > (UINT16_MAX + 1U)))
+    {
+        return UINT32_MAX;
+    }
+    actual = clkPerBitFreq / divider;
+
+    return (actual > baud) ? (actual - baud) : (baud - actual);
+}
+
 bool UART2_SerialSetup( UART_SERIAL_SETUP *setup, uint32_t srcClkFreq )
 {
     bool status = false;
     uint32_t baud;
     uint32_t status_ctrl;
     uint32_t uxbrg = 0;
+    uint32_t brgLow;
+    uint32_t brgHigh;
+    uint32_t errLow;
+    uint32_t errHigh;
+    uint32_t brgh = 0U;
 
     if (setup != NULL)
     {
@@ -181,20 +249,28 @@ bool UART2_SerialSetup( UART_SERIAL_SETUP *setup, uint32_t srcClkFreq )
             srcClkFreq = UART2_FrequencyGet();
         }
 
-        /* Calculate BRG value */
-        uxbrg = (((srcClkFreq >> 4) + (baud >> 1)) / baud);
+        /* Calculate BRG value for 16 (BRGH = 0) and 4 (BRGH = 1) clocks per
+           bit. BRGH = 0 samples each bit three times, the high speed divider
+           is taken only when the other is more than 0.5% off and it is closer
+           to the requested rate. */
+        brgLow = (((srcClkFreq >> 4) + (baud >> 1)) / baud);
+        brgHigh = (((srcClkFreq >> 2) + (baud >> 1)) / baud);
+        errLow = UART2_BaudErrorGet(srcClkFreq >> 4, brgLow, baud);
+        errHigh = UART2_BaudErrorGet(srcClkFreq >> 2, brgHigh, baud);
 
-        /* Check if the baud value can be set with low baud settings */
-        if (uxbrg < 1U)
+        if ((errLow == UINT32_MAX) && (errHigh == UINT32_MAX))
         {
             return status;
         }
 
-        uxbrg -= 1U;
-
-        if (uxbrg > UINT16_MAX)
+        if ((errLow > (baud / 200U)) && (errHigh < errLow))
         {
-            return status;
+            brgh = _U2MODE_BRGH_MASK;
+            uxbrg = brgHigh - 1U;
+        }
+        else
+        {
+            uxbrg = brgLow - 1U;
         }
 
         /* Turn OFF UART2. Save UTXEN, URXEN and UTXBRK bits as these are cleared upon disabling UART */
@@ -217,6 +293,9 @@ bool UART2_SerialSetup( UART_SERIAL_SETUP *setup, uint32_t srcClkFreq )
         /* Configure UART2 mode */
         U2MODE = (U2MODE & (~_U2MODE_STSEL_MASK)) | setup->stopBits;
 
+        /* Select the divider, a pending auto-baud measurement is cancelled */
+        U2MODE = (U2MODE & (~(_U2MODE_BRGH_MASK | _U2MODE_ABAUD_MASK))) | brgh;
+
         /* Configure UART2 Baud Rate */
         U2BRG = uxbrg;
 
@@ -249,12 +328,7 @@ static inline bool UART2_RxPushByte(uint16_t rdByte)
     bool isSuccess = false;
     uint32_t rdInIdx;
 
-    tempInIndex = uart2Obj.rdInIndex + 1U;
-
-    if (tempInIndex >= uart2Obj.rdBufferSize)
-    {
-        tempInIndex = 0U;
-    }
+    tempInIndex = (uart2Obj.rdInIndex + 1U) & (uart2Obj.rdBufferSize - 1U);
 
     if (tempInIndex == uart2Obj.rdOutIndex)
     {
@@ -266,12 +340,7 @@ static inline bool UART2_RxPushByte(uint16_t rdByte)
             uart2Obj.rdCallback(UART_EVENT_READ_BUFFER_FULL, rdContext);
 
             /* Read the indices again in case application has freed up space in RX ring buffer */
-            tempInIndex = uart2Obj.rdInIndex + 1U;
-
-            if (tempInIndex >= uart2Obj.rdBufferSize)
-            {
-                tempInIndex = 0U;
-            }
+            tempInIndex = (uart2Obj.rdInIndex + 1U) & (uart2Obj.rdBufferSize - 1U);
         }
     }
 
@@ -334,7 +403,8 @@ static void UART2_ReadNotificationSend(void)
     }
 }
 
-size_t UART2_Read(uint8_t* pRdBuffer, const size_t size)
+/* 9-bit mode, one character (two bytes) at a time */
+static size_t UART2_Read9Bit(uint8_t* pRdBuffer, const size_t size)
 {
     size_t nBytesRead = 0;
     uint32_t rdOutIndex = 0;
@@ -346,35 +416,16 @@ size_t UART2_Read(uint8_t* pRdBuffer, const size_t size)
     rdOutIndex = uart2Obj.rdOutIndex;
     rdInIndex = uart2Obj.rdInIndex;
 
-    while (nBytesRead < size)
+    while ((nBytesRead < size) && (rdOutIndex != rdInIndex))
     {
-        if (rdOutIndex != rdInIndex)
-        {
-            if (UART2_IS_9BIT_MODE_ENABLED())
-            {
-                rdOut16Idx = rdOutIndex << 1U;
-                nBytesRead16Idx = nBytesRead << 1U;
+        rdOut16Idx = rdOutIndex << 1U;
+        nBytesRead16Idx = nBytesRead << 1U;
 
-                pRdBuffer[nBytesRead16Idx] = UART2_ReadBuffer[rdOut16Idx];
-                pRdBuffer[nBytesRead16Idx + 1U] = UART2_ReadBuffer[rdOut16Idx + 1U];
-            }
-            else
-            {
-                pRdBuffer[nBytesRead] = UART2_ReadBuffer[rdOutIndex];
-            }
-            nBytesRead++;
-            rdOutIndex++;
+        pRdBuffer[nBytesRead16Idx] = UART2_ReadBuffer[rdOut16Idx];
+        pRdBuffer[nBytesRead16Idx + 1U] = UART2_ReadBuffer[rdOut16Idx + 1U];
 
-            if (rdOutIndex >= uart2Obj.rdBufferSize)
-            {
-                rdOutIndex = 0U;
-            }
-        }
-        else
-        {
-            /* No more data available in the RX buffer */
-            break;
-        }
+        nBytesRead++;
+        rdOutIndex = (rdOutIndex + 1U) & (uart2Obj.rdBufferSize - 1U);
     }
 
     uart2Obj.rdOutIndex = rdOutIndex;
@@ -382,26 +433,54 @@ size_t UART2_Read(uint8_t* pRdBuffer, const size_t size)
     return nBytesRead;
 }
 
-size_t UART2_ReadCountGet(void)
+size_t UART2_Read(uint8_t* pRdBuffer, const size_t size)
 {
-    size_t nUnreadBytesAvailable;
-    uint32_t rdInIndex;
+    size_t nBytesRead;
+    size_t nFirst;
     uint32_t rdOutIndex;
+    uint32_t rdInIndex;
+    uint32_t mask = uart2Obj.rdBufferSize - 1U;
 
-    /* Take a snapshot of indices to avoid processing in critical section */
-    rdInIndex = uart2Obj.rdInIndex;
+    if (UART2_IS_9BIT_MODE_ENABLED())
+    {
+        return UART2_Read9Bit(pRdBuffer, size);
+    }
+
+    /* Take a snapshot of indices to avoid creation of critical section. The
+       RX interrupt only moves rdInIndex, which can only add data. */
     rdOutIndex = uart2Obj.rdOutIndex;
+    rdInIndex = uart2Obj.rdInIndex;
 
-    if ( rdInIndex >=  rdOutIndex)
+    nBytesRead = (rdInIndex - rdOutIndex) & mask;
+    if (nBytesRead > size)
     {
-        nUnreadBytesAvailable =  rdInIndex -  rdOutIndex;
+        nBytesRead = size;
     }
-    else
+
+    /* At most two contiguous spans: up to the end of the buffer, then from
+       its start */
+    nFirst = (mask + 1U) - rdOutIndex;
+    if (nFirst > nBytesRead)
     {
-        nUnreadBytesAvailable =  (uart2Obj.rdBufferSize -  rdOutIndex) + rdInIndex;
+        nFirst = nBytesRead;
     }
+    (void) memcpy(pRdBuffer, (const uint8_t*)&UART2_ReadBuffer[rdOutIndex], nFirst);
+    (void) memcpy(&pRdBuffer[nFirst], (const uint8_t*)&UART2_ReadBuffer[0], nBytesRead - nFirst);
+
+    UART2_RING_BARRIER();
+
+    uart2Obj.rdOutIndex = (rdOutIndex + nBytesRead) & mask;
 
-    return nUnreadBytesAvailable;
+    return nBytesRead;
+}
+
+size_t UART2_ReadCountGet(void)
+{
+    /* Take a snapshot of indices to avoid processing in critical section */
+    uint32_t rdInIndex = uart2Obj.rdInIndex;
+    uint32_t rdOutIndex = uart2Obj.rdOutIndex;
+
+    return (rdInIndex - rdOutIndex) & (uart2Obj.rdBufferSize - 1U);
 }
 
 size_t UART2_ReadFreeBufferCountGet(void)
@@ -440,41 +519,7 @@ void UART2_ReadCallbackRegister( UART_RING_BUFFER_CALLBACK callback, uintptr_t c
     uart2Obj.rdContext = context;
 }
 
-/* This routine is only called from ISR. Hence do not disable/enable USART interrupts. */
-static bool UART2_TxPullByte(uint16_t* pWrByte)
-{
-    bool isSuccess = false;
-    uint32_t wrOutIndex = uart2Obj.wrOutIndex;
-    uint32_t wrInIndex = uart2Obj.wrInIndex;
-    uint32_t wrOut16Idx;
-
-    if (wrOutIndex != wrInIndex)
-    {
-        if (UART2_IS_9BIT_MODE_ENABLED())
-        {
-            wrOut16Idx = wrOutIndex << 1U;
-            pWrByte[0] = UART2_WriteBuffer[wrOut16Idx];
-            pWrByte[1] = UART2_WriteBuffer[wrOut16Idx + 1U];
-        }
-        else
-        {
-            *pWrByte = UART2_WriteBuffer[wrOutIndex];
-        }
-        wrOutIndex++;
-
-        if (wrOutIndex >= uart2Obj.wrBufferSize)
-        {
-            wrOutIndex = 0U;
-        }
-
-        uart2Obj.wrOutIndex = wrOutIndex;
-
-        isSuccess = true;
-    }
-
-    return isSuccess;
-}
-
+/* 9-bit mode only, 8-bit data is copied by UART2_Write() in spans */
 static inline bool UART2_TxPushByte(uint16_t wrByte)
 {
     uint32_t tempInIndex;
@@ -483,24 +528,13 @@ static inline bool UART2_TxPushByte(uint16_t wrByte)
     uint32_t wrInIndex = uart2Obj.wrInIndex;
     uint32_t wrIn16Idx;
 
-    tempInIndex = wrInIndex + 1U;
+    tempInIndex = (wrInIndex + 1U) & (uart2Obj.wrBufferSize - 1U);
 
-    if (tempInIndex >= uart2Obj.wrBufferSize)
-    {
-        tempInIndex = 0U;
-    }
     if (tempInIndex != wrOutIndex)
     {
-        if (UART2_IS_9BIT_MODE_ENABLED())
-        {
-            wrIn16Idx = wrInIndex << 1U;
-            UART2_WriteBuffer[wrIn16Idx] = (uint8_t)wrByte;
-            UART2_WriteBuffer[wrIn16Idx + 1U] = (uint8_t)(wrByte >> 8U);
-        }
-        else
-        {
-            UART2_WriteBuffer[wrInIndex] = (uint8_t)wrByte;
-        }
+        wrIn16Idx = wrInIndex << 1U;
+        UART2_WriteBuffer[wrIn16Idx] = (uint8_t)wrByte;
+        UART2_WriteBuffer[wrIn16Idx + 1U] = (uint8_t)(wrByte >> 8U);
 
         uart2Obj.wrInIndex = tempInIndex;
 
@@ -514,15 +548,13 @@ static inline bool UART2_TxPushByte(uint16_t wrByte)
     return isSuccess;
 }
 
-/* This routine is only called from ISR. Hence do not disable/enable USART interrupts. */
-static void UART2_WriteNotificationSend(void)
+/* This routine is only called from ISR. Hence do not disable/enable USART interrupts.
+   Called once per interrupt with the free space before and after it; a
+   non-persistent notification is sent when the threshold was crossed. */
+static void UART2_WriteNotificationSend(uint32_t nFreeBefore, uint32_t nFreeWrBufferCount)
 {
-    uint32_t nFreeWrBufferCount;
-
     if (uart2Obj.isWrNotificationEnabled == true)
     {
-        nFreeWrBufferCount = UART2_WriteFreeBufferCountGet();
-
         if(uart2Obj.wrCallback != NULL)
         {
             uintptr_t wrContext = uart2Obj.wrContext;
@@ -536,7 +568,7 @@ static void UART2_WriteNotificationSend(void)
             }
             else
             {
-                if (nFreeWrBufferCount == uart2Obj.wrThreshold)
+                if ((nFreeBefore < uart2Obj.wrThreshold) && (nFreeWrBufferCount >= uart2Obj.wrThreshold))
                 {
                     uart2Obj.wrCallback(UART_EVENT_WRITE_THRESHOLD_REACHED, wrContext);
                 }
@@ -547,24 +579,65 @@ static void UART2_WriteNotificationSend(void)
 
 static size_t UART2_WritePendingBytesGet(void)
 {
-    size_t nPendingTxBytes;
-
     /* Take a snapshot of indices to avoid processing in critical section */
-
     uint32_t wrOutIndex = uart2Obj.wrOutIndex;
     uint32_t wrInIndex = uart2Obj.wrInIndex;
 
-    if ( wrInIndex >=  wrOutIndex)
+    return (wrInIndex - wrOutIndex) & (uart2Obj.wrBufferSize - 1U);
+}
+
+#if (UART2_TX_DMA != 0)
+/* Starts a transfer of the contiguous data at wrOutIndex, if there is any.
+   Called while the channel is idle. The channel moves UART2_TX_FIFO_DEPTH
+   bytes each time the TX buffer empty request (UTXISEL = 10) is asserted.
+   The request is held while the buffer is empty, so a transfer that is
+   started on an idle UART begins at once. */
+static void UART2_TxDmaStart(void)
+{
+    uint32_t wrOutIndex = uart2Obj.wrOutIndex;
+    uint32_t nSpan = UART2_WritePendingBytesGet();
+
+    if (nSpan > (uart2Obj.wrBufferSize - wrOutIndex))
     {
-        nPendingTxBytes =  wrInIndex - wrOutIndex;
+        nSpan = uart2Obj.wrBufferSize - wrOutIndex;
     }
-    else
+    if (nSpan > UART2_TX_DMA_BLOCK_MAX)
+    {
+        nSpan = UART2_TX_DMA_BLOCK_MAX;
+    }
+    if (nSpan != 0U)
     {
-        nPendingTxBytes =  (uart2Obj.wrBufferSize -  wrOutIndex) + wrInIndex;
+        uart2TxDmaSize = nSpan;
+        (void) DMAC_ChannelTransfer(DMAC_CHANNEL_0, (const void*)&UART2_WriteBuffer[wrOutIndex], nSpan,
+                                    (const void*)&U2TXREG, 1U, UART2_TX_FIFO_DEPTH);
     }
+}
 
-    return nPendingTxBytes;
+/* DMA channel 0 block interrupt: the span is in the TX buffer, give its space
+   back and start on the next one */
+static void UART2_TxDmaHandler(DMAC_TRANSFER_EVENT event, uintptr_t context)
+{
+    uint32_t startTicks = _CP0_GET_COUNT();
+    uint32_t mask = uart2Obj.wrBufferSize - 1U;
+    uint32_t nSent = uart2TxDmaSize;
+    uint32_t nFree = mask - UART2_WritePendingBytesGet();
+
+    /* After an address error the span is dropped as well, retrying it would
+       stall the ring */
+    (void)event;
+    (void)context;
+
+    uart2Obj.wrOutIndex = (uart2Obj.wrOutIndex + nSent) & mask;
+    uart2TxDmaSize = 0U;
+    UART2_TxDmaStart();
+
+    UART2_WriteNotificationSend(nFree, nFree + nSent);
+
+    uart2TxStats.interrupts++;
+    uart2TxStats.bytes += nSent;
+    uart2TxStats.ticks += _CP0_GET_COUNT() - startTicks;
 }
+#endif
 
 size_t UART2_WriteCountGet(void)
 {
@@ -579,10 +652,12 @@ size_t UART2_Write(uint8_t* pWrBuffer, const size_t size )
 {
     size_t nBytesWritten  = 0;
     uint16_t halfWordData = 0U;
+    uint8_t* data[2];
+    size_t spanSize[2];
 
-    while (nBytesWritten < size)
+    if (UART2_IS_9BIT_MODE_ENABLED())
     {
-        if (UART2_IS_9BIT_MODE_ENABLED())
+        while (nBytesWritten < size)
         {
             halfWordData = pWrBuffer[(2U * nBytesWritten) + 1U];
             halfWordData <<= 8U;
@@ -597,29 +672,89 @@ size_t UART2_Write(uint8_t* pWrBuffer, const size_t size )
                 break;
             }
         }
-        else
+
+        /* Check if any data is pending for transmission */
+        if (UART2_WritePendingBytesGet() > 0U)
         {
-            if (UART2_TxPushByte(pWrBuffer[nBytesWritten]) == true)
-            {
-                nBytesWritten++;
-            }
-            else
-            {
-                /* Queue is full, exit the loop */
-                break;
-            }
+            /* Enable TX interrupt as data is pending for transmission */
+            UART2_TX_INT_ENABLE();
         }
 
+        return nBytesWritten;
+    }
+
+    /* Copy what fits into the free space, at most two contiguous spans */
+    nBytesWritten = UART2_WriteReserve(data, spanSize);
+    if (nBytesWritten > size)
+    {
+        nBytesWritten = size;
+    }
+    if (spanSize[0] > nBytesWritten)
+    {
+        spanSize[0] = nBytesWritten;
+    }
+    (void) memcpy(data[0], pWrBuffer, spanSize[0]);
+    (void) memcpy(data[1], &pWrBuffer[spanSize[0]], nBytesWritten - spanSize[0]);
+
+    UART2_WriteCommit(nBytesWritten);
+
+    return nBytesWritten;
+}
+
+size_t UART2_WriteReserve(uint8_t* data[2], size_t size[2])
+{
+    /* Take a snapshot of indices. The TX interrupt only moves wrOutIndex,
+       which can only make more room. */
+    uint32_t wrInIndex = uart2Obj.wrInIndex;
+    uint32_t wrOutIndex = uart2Obj.wrOutIndex;
+    size_t nFree;
+
+    data[0] = (uint8_t*)&UART2_WriteBuffer[wrInIndex];
+    data[1] = (uint8_t*)&UART2_WriteBuffer[0];
+    size[0] = 0U;
+    size[1] = 0U;
+
+    if (UART2_IS_9BIT_MODE_ENABLED())
+    {
+        return 0U;
     }
 
-    /* Check if any data is pending for transmission */
+    nFree = (wrOutIndex - wrInIndex - 1U) & (uart2Obj.wrBufferSize - 1U);
+
+    size[0] = uart2Obj.wrBufferSize - wrInIndex;
+    if (size[0] > nFree)
+    {
+        size[0] = nFree;
+    }
+    size[1] = nFree - size[0];
+
+    return nFree;
+}
+
+void UART2_WriteCommit(size_t count)
+{
+    uint32_t wrInIndex = (uart2Obj.wrInIndex + count) & (uart2Obj.wrBufferSize - 1U);
+
+    /* The bytes were written through a non-volatile pointer, they must be in
+       the buffer before the ISR can see the new index */
+    UART2_RING_BARRIER();
+
+    uart2Obj.wrInIndex = wrInIndex;
+
+#if (UART2_TX_DMA != 0)
+    /* With a transfer in flight its completion picks up the new data. While
+       the channel is idle its interrupt cannot come in between. */
+    if (uart2TxDmaSize == 0U)
+    {
+        UART2_TxDmaStart();
+    }
+#else
     if (UART2_WritePendingBytesGet() > 0U)
     {
         /* Enable TX interrupt as data is pending for transmission */
         UART2_TX_INT_ENABLE();
     }
-
-    return nBytesWritten;
+#endif
 }
 
 size_t UART2_WriteFreeBufferCountGet(void)
@@ -668,6 +803,11 @@ void UART2_WriteCallbackRegister( UART_RING_BUFFER_CALLBACK callback, uintptr_t
     uart2Obj.wrContext = context;
 }
 
+void UART2_TxStatsGet(UART2_TX_STATS* stats)
+{
+    *stats = uart2TxStats;
+}
+
 UART_ERROR UART2_ErrorGet( void )
 {
     UART_ERROR errors = uart2Obj.errors;
@@ -688,11 +828,20 @@ bool UART2_AutoBaudQuery( void )
      return autobaudq_check;
 }
 
+uint32_t UART2_BaudRateGet( void )
+{
+    uint32_t clocksPerBit = ((U2MODE & _U2MODE_BRGH_MASK) != 0U) ? 4U : 16U;
+
+    return UART2_FrequencyGet() / (clocksPerBit * ((U2BRG & 0xFFFFU) + 1U));
+}
+
 void UART2_AutoBaudSet( bool enable )
 {
     if( enable == true )
     {
-        U2MODESET = _U2MODE_ABAUD_MASK;
+        /* Measure with 4 clocks per bit, so that U2BRG has enough resolution
+           for the high rates as well */
+        U2MODESET = _U2MODE_BRGH_MASK | _U2MODE_ABAUD_MASK;
     }
 
     /* Turning off ABAUD if it was on can lead to unpredictable behavior, so that
@@ -736,47 +885,55 @@ static void __attribute__((used)) UART2_RX_InterruptHandler (void)
 
 static void __attribute__((used)) UART2_TX_InterruptHandler (void)
 {
-    uint16_t wrByte;
+    uint32_t startTicks = _CP0_GET_COUNT();
+    /* One snapshot of the indices for the whole FIFO load. Only this handler
+       moves wrOutIndex, UART2_Write() can only add data. */
+    uint32_t wrOutIndex = uart2Obj.wrOutIndex;
+    uint32_t wrInIndex = uart2Obj.wrInIndex;
+    uint32_t mask = uart2Obj.wrBufferSize - 1U;
+    uint32_t nPending = (wrInIndex - wrOutIndex) & mask;
+    uint32_t nLoad = (nPending < UART2_TX_FIFO_DEPTH) ? nPending : UART2_TX_FIFO_DEPTH;
+    uint32_t n;
+    uint32_t wrOut16Idx;
 
-    /* Check if any data is pending for transmission */
-    if (UART2_WritePendingBytesGet() > 0U)
+    if (UART2_IS_9BIT_MODE_ENABLED())
     {
-        /* Keep writing to the TX FIFO as long as there is space */
-        while((U2STA & _U2STA_UTXBF_MASK) == 0U)
+        for (n = 0U; n < nLoad; n++)
         {
-            if (UART2_TxPullByte(&wrByte) == true)
-            {
-                if (UART2_IS_9BIT_MODE_ENABLED())
-                {
-                    U2TXREG = wrByte;
-                }
-                else
-                {
-                    U2TXREG = (uint8_t)wrByte;
-                }
-
-                /* Send notification */
-                UART2_WriteNotificationSend();
-            }
-            else
-            {
-                /* Nothing to transmit. Disable the data register empty interrupt. */
-                UART2_TX_INT_DISABLE();
-                break;
-            }
+            wrOut16Idx = wrOutIndex << 1U;
+            U2TXREG = (uint32_t)UART2_WriteBuffer[wrOut16Idx] | ((uint32_t)UART2_WriteBuffer[wrOut16Idx + 1U] << 8U);
+            wrOutIndex = (wrOutIndex + 1U) & mask;
         }
-
-        /* Clear UART2TX Interrupt flag */
-        IFS1CLR = _IFS1_U2TXIF_MASK;
     }
     else
     {
-        /* Nothing to transmit. Disable the data register empty interrupt. */
+        for (n = 0U; n < nLoad; n++)
+        {
+            U2TXREG = UART2_WriteBuffer[wrOutIndex];
+            wrOutIndex = (wrOutIndex + 1U) & mask;
+        }
+    }
+
+    uart2Obj.wrOutIndex = wrOutIndex;
+
+    if (nLoad == nPending)
+    {
+        /* Nothing more to transmit. Disable the data register empty interrupt. */
         UART2_TX_INT_DISABLE();
+    }
 
-        /* Clear UART2TX Interrupt flag */
-        IFS1CLR = _IFS1_U2TXIF_MASK;
+    /* Clear UART2TX Interrupt flag */
+    IFS1CLR = _IFS1_U2TXIF_MASK;
+
+    /* Send notification, at most one per interrupt */
+    if (nLoad != 0U)
+    {
+        UART2_WriteNotificationSend(mask - nPending, (mask - nPending) + nLoad);
     }
+
+    uart2TxStats.interrupts++;
+    uart2TxStats.bytes += nLoad;
+    uart2TxStats.ticks += _CP0_GET_COUNT() - startTicks;
 }
 
 void __attribute__((used)) UART_2_InterruptHandler (void)
@@ -75,12 +75,24 @@ bool UART2_AutoBaudQuery( void );
 
 void UART2_AutoBaudSet( bool enable );
 
+/* Rate set by UART2_SerialSetup() or measured by auto-baud, in bits/s */
+uint32_t UART2_BaudRateGet( void );
+
 size_t UART2_Write(uint8_t* pWrBuffer, const size_t size );
 
 size_t UART2_WriteCountGet(void);
 
 size_t UART2_WriteFreeBufferCountGet(void);
 
+/* Free space of the TX ring for writing in place: data[0]/size[0] up to the
+   end of the buffer, data[1]/size[1] the part after the wrap-around. Returns
+   size[0] + size[1], 0 in 9-bit mode. */
+size_t UART2_WriteReserve(uint8_t* data[2], size_t size[2]);
+
+/* Queues count bytes (at most the UART2_WriteReserve() result) written in
+   place and starts transmission. */
+void UART2_WriteCommit(size_t count);
+
 size_t UART2_WriteBufferSizeGet(void);
 
 bool UART2_TransmitComplete(void);
@@ -91,6 +103,17 @@ void UART2_WriteThresholdSet(uint32_t nBytesThreshold);
 
 void UART2_WriteCallbackRegister( UART_RING_BUFFER_CALLBACK callback, uintptr_t context);
 
+/* TX interrupt counters since UART2_Initialize(). They wrap, use differences.
+   With UART2_TX_DMA they count the DMA block interrupts instead. */
+typedef struct
+{
+    uint32_t interrupts;    /* TX (or DMA block) interrupt handler entries */
+    uint32_t bytes;         /* characters loaded into the TX buffer */
+    uint32_t ticks;         /* core timer ticks (2 CPU cycles) in the handler */
+} UART2_TX_STATS;
+
+void UART2_TxStatsGet(UART2_TX_STATS* stats);
+
 size_t UART2_Read(uint8_t* pRdBuffer, const size_t size);
 
 size_t UART2_ReadCountGet(void);
@@ -61,7 +61,15 @@
 #include <stdarg.h>
 
 static SYS_CONSOLE_OBJECT_INSTANCE consoleDeviceInstance[SYS_CONSOLE_DEVICE_MAX_INSTANCES];
+#if SYS_CONSOLE_PRINT_ZERO_COPY
+#if !SYS_CONSOLE_PRINT_LITE
+#error "SYS_CONSOLE_PRINT_ZERO_COPY needs SYS_CONSOLE_PRINT_LITE"
+#endif
+/* Only for devices without writeReserve */
+static char consolePrintBuffer[SYS_CONSOLE_PRINT_FALLBACK_SIZE];
+#else
 static char consolePrintBuffer[SYS_CONSOLE_PRINT_BUFFER_SIZE];
+#endif
 static bool isConsoleMutexCreated = false;
 static OSAL_MUTEX_DECLARE(consolePrintBufferMutex);
 
@@ -258,6 +266,37 @@ ssize_t SYS_CONSOLE_ReadCountGet(const SYS_CONSOLE_HANDLE handle)
     }
 }
 
+ssize_t SYS_CONSOLE_WriteReserve(const SYS_CONSOLE_HANDLE handle, char* data[2], size_t size[2])
+{
+    SYS_CONSOLE_OBJECT_INSTANCE* pConsoleObj = SYS_CONSOLE_GET_INSTANCE(handle);
+
+    if (pConsoleObj != NULL)
+    {
+        if ((pConsoleObj->status == SYS_STATUS_UNINITIALIZED) || (pConsoleObj->devDesc == NULL) ||
+            (pConsoleObj->devDesc->writeReserve == NULL))
+        {
+            return -1;
+        }
+
+        return pConsoleObj->devDesc->writeReserve(pConsoleObj->devIndex, data, size);
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+void SYS_CONSOLE_WriteCommit(const SYS_CONSOLE_HANDLE handle, size_t count)
+{
+    SYS_CONSOLE_OBJECT_INSTANCE* pConsoleObj = SYS_CONSOLE_GET_INSTANCE(handle);
+
+    if ((pConsoleObj != NULL) && (pConsoleObj->devDesc != NULL) &&
+        (pConsoleObj->devDesc->writeCommit != NULL))
+    {
+        pConsoleObj->devDesc->writeCommit(pConsoleObj->devIndex, count);
+    }
+}
+
 ssize_t SYS_CONSOLE_Write(
     const SYS_CONSOLE_HANDLE handle,
     const void* buf,
@@ -326,6 +365,11 @@ void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
 {
     size_t len = 0;
     va_list args;
+#if SYS_CONSOLE_PRINT_ZERO_COPY
+    char* data[2];
+    size_t size[2];
+    ssize_t nFree;
+#endif
     SYS_CONSOLE_OBJECT_INSTANCE* pConsoleObj = SYS_CONSOLE_GET_INSTANCE(handle);
 
     if (pConsoleObj == NULL)
@@ -347,7 +391,41 @@ void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
     /* Get the variable arguments in va_list */
     va_start( args, format );
 
+#if SYS_CONSOLE_PRINT_ZERO_COPY
+    /* Format straight into the free space of the device buffer. Like
+       SYS_CONSOLE_Write(), what does not fit is lost. */
+    nFree = SYS_CONSOLE_WriteReserve(handle, data, size);
+    if (nFree > 0)
+    {
+        len = (uint32_t)SYS_CONSOLE_VsnprintfSpan(data, size, format, args);
+        SYS_CONSOLE_WriteCommit(handle, (len < (size_t)nFree) ? len : (size_t)nFree);
+    }
+    else if (nFree < 0)
+    {
+        /* The device has no writeReserve: format into the small fallback
+           buffer, a longer print is cut to its size */
+        len = (uint32_t)SYS_CONSOLE_Vsnprintf(consolePrintBuffer, SYS_CONSOLE_PRINT_FALLBACK_SIZE, format, args);
+        if (len >= SYS_CONSOLE_PRINT_FALLBACK_SIZE)
+        {
+            len = SYS_CONSOLE_PRINT_FALLBACK_SIZE - 1U;
+        }
+        if (len > 0U)
+        {
+            (void) pConsoleObj->devDesc->write_t(pConsoleObj->devIndex, consolePrintBuffer, len);
+        }
+    }
+    else
+    {
+        /* Device buffer full, the print is lost like SYS_CONSOLE_Write() */
+    }
+
+    va_end( args );
+#else
+#if SYS_CONSOLE_PRINT_LITE
+    len = (uint32_t)SYS_CONSOLE_Vsnprintf(consolePrintBuffer, SYS_CONSOLE_PRINT_BUFFER_SIZE, format, args);
+#else
     len = (uint32_t)vsnprintf(consolePrintBuffer, SYS_CONSOLE_PRINT_BUFFER_SIZE, format, args);
+#endif
 
     va_end( args );
 
@@ -357,6 +435,7 @@ void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
 
         (void) pConsoleObj->devDesc->write_t(pConsoleObj->devIndex, consolePrintBuffer, len);
     }
+#endif
 
     /* Release mutex */
     (void) OSAL_MUTEX_Unlock(&consolePrintBufferMutex);
@@ -378,6 +457,26 @@ void SYS_CONSOLE_Message(const SYS_CONSOLE_HANDLE handle, const char *message)
         return;
     }
 
+#if SYS_CONSOLE_PRINT_ZERO_COPY
+    {
+        char* data[2];
+        size_t size[2];
+        size_t len = strlen(message);
+        ssize_t nFree = SYS_CONSOLE_WriteReserve(handle, data, size);
+
+        if (nFree >= 0)
+        {
+            /* Copy straight into the device buffer, what does not fit is lost */
+            size_t n0 = (len < size[0]) ? len : size[0];
+            size_t n1 = ((len - n0) < size[1]) ? (len - n0) : size[1];
+
+            (void) memcpy(data[0], message, n0);
+            (void) memcpy(data[1], &message[n0], n1);
+            SYS_CONSOLE_WriteCommit(handle, n0 + n1);
+            return;
+        }
+    }
+#endif
     (void) pConsoleObj->devDesc->write_t(pConsoleObj->devIndex, message, strlen(message));
 }
 
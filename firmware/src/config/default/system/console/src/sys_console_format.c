@@ -0,0 +1,285 @@
+/*******************************************************************************
+  Console System Service Integer Formatter
+
+  File Name:
+    sys_console_format.c
+
+  Summary:
+    Small printf style formatter used by SYS_CONSOLE_Print() when
+    SYS_CONSOLE_PRINT_LITE is 1.
+
+  Description:
+    Supports the conversions the console users need and nothing else:
+
+      %d %i %u %x %X %c %s %%
+      flags '-' and '0', a field width (digits or '*'), length modifier 'l'
+
+    There is no floating point, no precision and no %n. Other conversions are
+    copied to the output as written. The formatter keeps no state between
+    calls, so it is safe to call from several tasks, and it needs no heap.
+
+    The output may be split in two parts, so that SYS_CONSOLE_Print() can
+    format straight into the free space of a ring buffer that wraps around.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "system/console/sys_console.h"
+
+typedef struct
+{
+    char *data[2];
+    size_t size[2];
+    size_t len;     // characters produced, also those that did not fit
+} SYS_CONSOLE_FORMAT_OUT;
+
+// count characters of str, or count times fill when str is NULL
+static void lSYS_CONSOLE_FormatWrite(SYS_CONSOLE_FORMAT_OUT *out, const char *str, char fill,
+                                     int count)
+{
+    size_t pos = out->len;
+    unsigned part;
+
+    if (count <= 0)
+    {
+        return;
+    }
+    out->len += (size_t)count;
+    for (part = 0U; part < 2U; part++)
+    {
+        size_t room;
+        size_t n;
+        char *dst;
+
+        if (pos >= out->size[part])
+        {
+            pos -= out->size[part];
+            continue;
+        }
+        room = out->size[part] - pos;
+        n = ((size_t)count < room) ? (size_t)count : room;
+        dst = &out->data[part][pos];
+        count -= (int)n;
+        if (str != NULL)
+        {
+            while (n-- != 0U)
+            {
+                *dst++ = *str++;
+            }
+        }
+        else
+        {
+            while (n-- != 0U)
+            {
+                *dst++ = fill;
+            }
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        pos = 0U;
+    }
+}
+
+// str is count characters long, sign (0 for none) goes before the zero padding
+static void lSYS_CONSOLE_FormatField(SYS_CONSOLE_FORMAT_OUT *out, const char *str, int count,
+                                     char sign, int width, bool left, bool zero)
+{
+    int pad = width - count - ((sign != '\0') ? 1 : 0);
+
+    if (pad > 0)
+    {
+        if (!left && !zero)
+        {
+            lSYS_CONSOLE_FormatWrite(out, NULL, ' ', pad);
+        }
+        if (sign != '\0')
+        {
+            lSYS_CONSOLE_FormatWrite(out, &sign, '\0', 1);
+        }
+        if (!left && zero)
+        {
+            lSYS_CONSOLE_FormatWrite(out, NULL, '0', pad);
+        }
+        lSYS_CONSOLE_FormatWrite(out, str, '\0', count);
+        if (left)
+        {
+            lSYS_CONSOLE_FormatWrite(out, NULL, ' ', pad);
+        }
+        return;
+    }
+    if (sign != '\0')
+    {
+        lSYS_CONSOLE_FormatWrite(out, &sign, '\0', 1);
+    }
+    lSYS_CONSOLE_FormatWrite(out, str, '\0', count);
+}
+
+int SYS_CONSOLE_VsnprintfSpan(char *data[2], size_t size[2], const char *format, va_list args)
+{
+    SYS_CONSOLE_FORMAT_OUT out = { { data[0], data[1] }, { size[0], size[1] }, 0U };
+    // a 64 bit long has up to 20 decimal digits
+    char digits[20];
+
+    while (*format != '\0')
+    {
+        const char *spec = format;
+        bool left = false;
+        bool zero = false;
+        bool isLong = false;
+        int width = 0;
+        unsigned long value;
+        unsigned base;
+        const char *hex;
+        char sign = '\0';
+        int n;
+
+        if (*format != '%')
+        {
+            // literal text up to the next conversion, the first part of the
+            // output is filled while looking for it
+            n = 0;
+            while ((out.len < out.size[0]) && (format[n] != '\0') && (format[n] != '%'))
+            {
+                out.data[0][out.len++] = format[n++];
+            }
+            format += n;
+            n = 0;
+            while ((format[n] != '\0') && (format[n] != '%'))
+            {
+                n++;
+            }
+            lSYS_CONSOLE_FormatWrite(&out, format, '\0', n);
+            format += n;
+            continue;
+        }
+        format++;
+        for (;; format++)
+        {
+            if (*format == '-')
+            {
+                left = true;
+            }
+            else if (*format == '0')
+            {
+                zero = true;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (*format == '*')
+        {
+            width = va_arg(args, int);
+            if (width < 0)
+            {
+                left = true;
+                width = -width;
+            }
+            format++;
+        }
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = (width * 10) + (*format++ - '0');
+        }
+        if (*format == 'l')
+        {
+            isLong = true;
+            format++;
+        }
+
+        switch (*format)
+        {
+            case 'd':
+            case 'i':
+            {
+                long v = isLong ? va_arg(args, long) : (long)va_arg(args, int);
+
+                if (v < 0)
+                {
+                    sign = '-';
+                    value = 0UL - (unsigned long)v;
+                }
+                else
+                {
+                    value = (unsigned long)v;
+                }
+                base = 10U;
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+                value = isLong ? va_arg(args, unsigned long) : (unsigned long)va_arg(args, unsigned int);
+                base = (*format == 'u') ? 10U : 16U;
+                break;
+            case 'c':
+                digits[0] = (char)va_arg(args, int);
+                lSYS_CONSOLE_FormatField(&out, digits, 1, '\0', width, left, false);
+                format++;
+                continue;
+            case 's':
+            {
+                const char *str = va_arg(args, const char *);
+
+                if (str == NULL)
+                {
+                    str = "(null)";
+                }
+                for (n = 0; str[n] != '\0'; n++)
+                {
+                }
+                lSYS_CONSOLE_FormatField(&out, str, n, '\0', width, left, false);
+                format++;
+                continue;
+            }
+            case '%':
+                lSYS_CONSOLE_FormatWrite(&out, format, '\0', 1);
+                format++;
+                continue;
+            default:
+                // not supported, copy the conversion as written
+                lSYS_CONSOLE_FormatWrite(&out, spec, '\0', (int)(format - spec));
+                continue;
+        }
+
+        // digits are produced backwards from the end of the buffer. The
+        // constant divisors let the compiler avoid the M4K divide unit.
+        hex = (*format == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+        n = 0;
+        do
+        {
+            if (base == 16U)
+            {
+                digits[sizeof(digits) - 1U - (size_t)n] = hex[value & 0xFUL];
+                value >>= 4;
+            }
+            else
+            {
+                digits[sizeof(digits) - 1U - (size_t)n] = (char)('0' + (value % 10UL));
+                value /= 10UL;
+            }
+            n++;
+        } while (value != 0UL);
+        lSYS_CONSOLE_FormatField(&out, &digits[sizeof(digits) - (size_t)n], n, sign, width,
+                                 left, zero);
+        format++;
+    }
+    return (int)out.len;
+}
+
+int SYS_CONSOLE_Vsnprintf(char *buf, size_t size, const char *format, va_list args)
+{
+    char *data[2] = { buf, NULL };
+    size_t spanSize[2] = { (size != 0U) ? size - 1U : 0U, 0U };
+    int len = SYS_CONSOLE_VsnprintfSpan(data, spanSize, format, args);
+
+    if (size != 0U)
+    {
+        buf[((size_t)len < size) ? (size_t)len : size - 1U] = '\0';
+    }
+    return len;
+}
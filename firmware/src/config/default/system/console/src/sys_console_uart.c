@@ -64,6 +64,8 @@ const SYS_CONSOLE_DEV_DESC sysConsoleUARTDevDesc =
     .write_t                    = Console_UART_Write,
     .writeFreeBufferCountGet    = Console_UART_WriteFreeBufferCountGet,
     .writeCountGet              = Console_UART_WriteCountGet,
+    .writeReserve               = Console_UART_WriteReserve,
+    .writeCommit                = Console_UART_WriteCommit,
     .task                       = Console_UART_Tasks,
     .status                     = Console_UART_Status,
     .flush                      = Console_UART_Flush,
@@ -255,6 +257,49 @@ ssize_t Console_UART_WriteCountGet(uint32_t index)
     return nPendingTxBytes;
 }
 
+/* Free space of the TX ring buffer to format into, see UART2_WriteReserve() */
+ssize_t Console_UART_WriteReserve(uint32_t index, char* data[2], size_t size[2])
+{
+    ssize_t nFreeBytes = 0;
+
+    CONSOLE_UART_DATA* pConsoleUartData = CONSOLE_UART_GET_INSTANCE(index);
+
+    if ((pConsoleUartData == NULL) || (pConsoleUartData->uartPLIB->writeReserve == NULL))
+    {
+        return -1;
+    }
+
+    if (Console_UART_ResourceLock(pConsoleUartData) == false)
+    {
+        return -1;
+    }
+
+    nFreeBytes = (ssize_t)pConsoleUartData->uartPLIB->writeReserve((uint8_t**)data, size);
+
+    Console_UART_ResourceUnlock(pConsoleUartData);
+
+    return nFreeBytes;
+}
+
+void Console_UART_WriteCommit(uint32_t index, size_t count)
+{
+    CONSOLE_UART_DATA* pConsoleUartData = CONSOLE_UART_GET_INSTANCE(index);
+
+    if ((pConsoleUartData == NULL) || (pConsoleUartData->uartPLIB->writeCommit == NULL))
+    {
+        return;
+    }
+
+    if (Console_UART_ResourceLock(pConsoleUartData) == false)
+    {
+        return;
+    }
+
+    pConsoleUartData->uartPLIB->writeCommit(count);
+
+    Console_UART_ResourceUnlock(pConsoleUartData);
+}
+
 bool Console_UART_Flush(uint32_t index)
 {
     /* Data is not buffered, nothing to flush */
@@ -89,6 +89,8 @@ ssize_t Console_UART_ReadFreeBufferCountGet(uint32_t index);
 ssize_t Console_UART_Write(uint32_t index, const void* pWrBuffer, size_t count );
 ssize_t Console_UART_WriteFreeBufferCountGet(uint32_t index);
 ssize_t Console_UART_WriteCountGet(uint32_t index);
+ssize_t Console_UART_WriteReserve(uint32_t index, char* data[2], size_t size[2]);
+void Console_UART_WriteCommit(uint32_t index, size_t count);
 bool Console_UART_Flush(uint32_t index);
 
 // DOM-IGNORE-BEGIN
@@ -64,6 +64,8 @@ typedef size_t (*SYS_CONSOLE_UART_PLIB_READ_FREE_BUFFFER_COUNT_GET)(void);
 typedef size_t (*SYS_CONSOLE_UART_PLIB_WRITE)(uint8_t* pWrBuffer, const size_t size );
 typedef size_t (*SYS_CONSOLE_UART_PLIB_WRITE_COUNT_GET)(void);
 typedef size_t (*SYS_CONSOLE_UART_PLIB_WRITE_FREE_BUFFER_COUNT_GET)(void);
+typedef size_t (*SYS_CONSOLE_UART_PLIB_WRITE_RESERVE)(uint8_t* data[2], size_t size[2]);
+typedef void (*SYS_CONSOLE_UART_PLIB_WRITE_COMMIT)(size_t count);
 
 typedef struct
 {
@@ -73,6 +75,9 @@ typedef struct
 	SYS_CONSOLE_UART_PLIB_WRITE 						write_t;
 	SYS_CONSOLE_UART_PLIB_WRITE_COUNT_GET				writeCountGet;
 	SYS_CONSOLE_UART_PLIB_WRITE_FREE_BUFFER_COUNT_GET	writeFreeBufferCountGet;
+    /* optional, NULL when the PLIB cannot be written in place */
+    SYS_CONSOLE_UART_PLIB_WRITE_RESERVE                 writeReserve;
+    SYS_CONSOLE_UART_PLIB_WRITE_COMMIT                  writeCommit;
     
 } SYS_CONSOLE_UART_PLIB_INTERFACE;
 
@@ -53,6 +53,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdarg.h>
 
 #include "configuration.h"
 #include "system/system.h"
@@ -268,6 +269,10 @@ typedef SYS_CONSOLE_STATUS (*SYS_CONSOLE_STATUS_FPTR) (uint32_t index);
 
 typedef bool (*SYS_CONSOLE_FLUSH_FPTR) (uint32_t index);
 
+typedef ssize_t (*SYS_CONSOLE_WRITE_RESERVE_FPTR) (uint32_t index, char* data[2], size_t size[2]);
+
+typedef void (*SYS_CONSOLE_WRITE_COMMIT_FPTR) (uint32_t index, size_t count);
+
 // *****************************************************************************
 /*  Console device descriptor
 
@@ -309,6 +314,11 @@ typedef struct
 
     SYS_CONSOLE_FLUSH_FPTR flush;
 
+    /* Optional (NULL), in place writes into the device buffer */
+    SYS_CONSOLE_WRITE_RESERVE_FPTR writeReserve;
+
+    SYS_CONSOLE_WRITE_COMMIT_FPTR writeCommit;
+
 } SYS_CONSOLE_DEV_DESC;
 
 // *****************************************************************************
@@ -911,6 +921,71 @@ ssize_t SYS_CONSOLE_WriteFreeBufferCountGet(const SYS_CONSOLE_HANDLE handle);
 */
 ssize_t SYS_CONSOLE_WriteCountGet(const SYS_CONSOLE_HANDLE handle);
 
+// *****************************************************************************
+/* Function:
+    ssize_t SYS_CONSOLE_WriteReserve(const SYS_CONSOLE_HANDLE handle,
+                                     char* data[2], size_t size[2])
+
+  Summary:
+    Returns the free space of the transmit buffer for writing in place.
+
+  Description:
+    The free space may wrap around the end of the device ring buffer, so it
+    is returned in two parts: data[0] with size[0] bytes, then data[1] with
+    size[1] bytes. Write the message there and queue it with
+    SYS_CONSOLE_WriteCommit(). This saves the copy of SYS_CONSOLE_Write().
+
+  Precondition:
+    SYS_CONSOLE_Initialize must have returned a valid object handle.
+
+  Parameters:
+    handle          - Handle to a console instance
+    data            - Receives the start of both parts
+    size            - Receives the size of both parts
+
+  Returns:
+    size[0] + size[1], or -1 when the device does not support in place
+    writes (use SYS_CONSOLE_Write()).
+
+  Example:
+    None.
+
+  Remarks:
+    Only one task may have a reservation at a time.
+*/
+
+ssize_t SYS_CONSOLE_WriteReserve(const SYS_CONSOLE_HANDLE handle, char* data[2], size_t size[2]);
+
+// *****************************************************************************
+/* Function:
+    void SYS_CONSOLE_WriteCommit(const SYS_CONSOLE_HANDLE handle, size_t count)
+
+  Summary:
+    Queues bytes written in place for transmission.
+
+  Description:
+    Transmits the first count bytes of the space returned by
+    SYS_CONSOLE_WriteReserve(), in order data[0], then data[1].
+
+  Precondition:
+    SYS_CONSOLE_WriteReserve must have returned at least count.
+
+  Parameters:
+    handle          - Handle to a console instance
+    count           - Number of bytes written
+
+  Returns:
+    None.
+
+  Example:
+    None.
+
+  Remarks:
+    None.
+*/
+
+void SYS_CONSOLE_WriteCommit(const SYS_CONSOLE_HANDLE handle, size_t count);
+
 // *****************************************************************************
 /* Function:
     void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
@@ -958,6 +1033,76 @@ ssize_t SYS_CONSOLE_WriteCountGet(const SYS_CONSOLE_HANDLE handle);
 void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
     __attribute__ ((format (printf, 2, 3)));
 
+// *****************************************************************************
+/* Function:
+    int SYS_CONSOLE_Vsnprintf(char *buf, size_t size, const char *format,
+                              va_list args)
+
+  Summary:
+    Integer only replacement for vsnprintf()
+
+  Description:
+    This function formats a message like vsnprintf() but only supports
+    %d %i %u %x %X %c %s and %%, the flags '-' and '0', a field width and the
+    length modifier 'l'. It is used by SYS_CONSOLE_Print() when
+    SYS_CONSOLE_PRINT_LITE is 1.
+
+  Precondition:
+    None.
+
+  Parameters:
+    buf             - Output buffer, always NUL terminated when size > 0
+    size            - Size of buf
+    format          - printf style format string
+    args            - Arguments of format
+
+  Returns:
+    The length of the complete message. A value of size or more means the
+    message was truncated.
+
+  Example:
+    None.
+
+  Remarks:
+    Keeps no state between calls and may be called from several tasks.
+*/
+
+int SYS_CONSOLE_Vsnprintf(char *buf, size_t size, const char *format, va_list args);
+
+// *****************************************************************************
+/* Function:
+    int SYS_CONSOLE_VsnprintfSpan(char *data[2], size_t size[2],
+                                  const char *format, va_list args)
+
+  Summary:
+    SYS_CONSOLE_Vsnprintf() into two buffers, without NUL terminator
+
+  Description:
+    Fills data[0] (size[0] bytes), then data[1] (size[1] bytes), as returned
+    by SYS_CONSOLE_WriteReserve(). No NUL terminator is written.
+
+  Precondition:
+    None.
+
+  Parameters:
+    data            - The two output buffers
+    size            - Their sizes, either may be 0
+    format          - printf style format string
+    args            - Arguments of format
+
+  Returns:
+    The length of the complete message, more than size[0] + size[1] when it
+    was truncated.
+
+  Example:
+    None.
+
+  Remarks:
+    None.
+*/
+
+int SYS_CONSOLE_VsnprintfSpan(char *data[2], size_t size[2], const char *format, va_list args);
+
 // *****************************************************************************
 /* Function:
     void SYS_CONSOLE_Message(const SYS_CONSOLE_HANDLE handle, const char *message)
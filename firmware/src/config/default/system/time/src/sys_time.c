@@ -51,6 +51,15 @@
 #include "configuration.h"
 #include "sys_time_local.h"
 
+#if (SYS_TIME_DEFERRED_QUEUE_SIZE & (SYS_TIME_DEFERRED_QUEUE_SIZE - 1)) != 0
+#error "SYS_TIME_DEFERRED_QUEUE_SIZE must be a power of two"
+#endif
+
+/* The deferred queue items are not volatile, only its indices are. The M4K
+ * is single core and executes in order, keeping the compiler from moving
+ * the item accesses past an index access is enough. */
+#define SYS_TIME_BARRIER() __asm__ __volatile__("" ::: "memory")
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Data
@@ -64,6 +73,21 @@ static SYS_TIME_TIMER_OBJ timers[SYS_TIME_MAX_TIMERS];
 /* This a global token counter used to generate unique timer handles */
 static uint16_t gSysTimeTokenCount = 1;
 
+#if SYS_TIME_TIMER_HEAP
+/* Active timers, a binary min-heap ordered by expiry. tmrActive of the
+ * counter object is always timerHeap[0]. */
+static SYS_TIME_TIMER_OBJ* timerHeap[SYS_TIME_MAX_TIMERS];
+static uint32_t timerHeapSize;
+#endif
+
+/* Callbacks of deferred timers, queued by the core timer interrupt for
+ * SYS_TIME_DeferredTasks(). One producer and one consumer, each writes only
+ * its own free running index, so neither locks. */
+static SYS_TIME_DEFERRED_ITEM deferredQueue[SYS_TIME_DEFERRED_QUEUE_SIZE];
+static volatile uint32_t deferredHead;
+static volatile uint32_t deferredTail;
+static SYS_TIME_DEFERRED_STATS deferredStats;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Local Functions
@@ -153,6 +177,97 @@ static SYS_TIME_TIMER_OBJ* SYS_TIME_GetTimerObject(SYS_TIME_HANDLE handle)
     return NULL;
 }
 
+#if SYS_TIME_TIMER_HEAP
+static void SYS_TIME_HeapPlace(SYS_TIME_TIMER_OBJ* tmr, uint32_t index)
+{
+    timerHeap[index] = tmr;
+    tmr->heapIndex = (uint16_t)(index + 1U);
+}
+
+static void SYS_TIME_HeapSiftUp(uint32_t index)
+{
+    SYS_TIME_TIMER_OBJ* tmr = timerHeap[index];
+
+    while (index > 0U)
+    {
+        uint32_t parent = (index - 1U) >> 1;
+
+        if (timerHeap[parent]->expiry <= tmr->expiry)
+        {
+            break;
+        }
+        SYS_TIME_HeapPlace(timerHeap[parent], index);
+        index = parent;
+    }
+    SYS_TIME_HeapPlace(tmr, index);
+}
+
+static void SYS_TIME_HeapSiftDown(uint32_t index)
+{
+    SYS_TIME_TIMER_OBJ* tmr = timerHeap[index];
+    uint32_t child = (2U * index) + 1U;
+
+    while (child < timerHeapSize)
+    {
+        if (((child + 1U) < timerHeapSize)
+            && (timerHeap[child + 1U]->expiry < timerHeap[child]->expiry))
+        {
+            child++;
+        }
+        if (tmr->expiry <= timerHeap[child]->expiry)
+        {
+            break;
+        }
+        SYS_TIME_HeapPlace(timerHeap[child], index);
+        index = child;
+        child = (2U * index) + 1U;
+    }
+    SYS_TIME_HeapPlace(tmr, index);
+}
+#endif
+
+/* swCounter64 without the steps of SYS_TIME_CounterSet(). Heap expiries and
+ * deferred stamps are kept on it, so setting the counter does not move them. */
+static inline uint64_t SYS_TIME_MonotonicGet(void)
+{
+    return gSystemCounterObj.swCounter64 - gSystemCounterObj.swCounterShift;
+}
+
+/* Counts from hwTimerPreviousValue until the timer expires, 0 once it has */
+static inline uint32_t SYS_TIME_HeadPendingGet(SYS_TIME_TIMER_OBJ* tmr)
+{
+#if SYS_TIME_TIMER_HEAP
+    /* swCounter64 stands for hwTimerPreviousValue */
+    uint64_t now = SYS_TIME_MonotonicGet();
+    uint64_t pending = (tmr->expiry > now) ? (tmr->expiry - now) : 0U;
+
+    return (pending > SYS_TIME_HW_COUNTER_PERIOD) ? SYS_TIME_HW_COUNTER_PERIOD : (uint32_t)pending;
+#else
+    return tmr->relativeTimePending;
+#endif
+}
+
+/* SYS_TIME_HeadPendingGet() of any timer in the list */
+static uint32_t SYS_TIME_PendingCountGet(SYS_TIME_TIMER_OBJ* tmr)
+{
+#if SYS_TIME_TIMER_HEAP
+    return SYS_TIME_HeadPendingGet(tmr);
+#else
+    SYS_TIME_TIMER_OBJ* tmrActive = gSystemCounterObj.tmrActive;
+    uint32_t pendingCount = 0;
+
+    /* Add time from all timers in the front */
+    while ((tmrActive != NULL) && (tmrActive != tmr))
+    {
+        pendingCount += tmrActive->relativeTimePending;
+        tmrActive = tmrActive->tmrNext;
+    }
+    /* Add the pending time of the requested timer */
+    pendingCount += tmrActive->relativeTimePending;
+    return pendingCount;
+#endif
+}
+
 static void SYS_TIME_HwTimerCompareUpdate(void)
 {
     uint64_t nextHwCounterValue = 0;
@@ -164,14 +279,15 @@ static void SYS_TIME_HwTimerCompareUpdate(void)
 
     if (tmrActive != NULL)
     {
-        if (tmrActive->relativeTimePending > SYS_TIME_HW_COUNTER_HALF_PERIOD)
+        /* Use a non-volatile intermediate to prevent dual volatile access in single statement */
+        uint32_t relativeTimePending = SYS_TIME_HeadPendingGet(tmrActive);
+
+        if (relativeTimePending > SYS_TIME_HW_COUNTER_HALF_PERIOD)
         {
             nextHwCounterValue = (uint64_t)counterObj->hwTimerCurrentValue + SYS_TIME_HW_COUNTER_HALF_PERIOD;
         }
         else
         {
-            /* Use a non-volatile intermediate to prevent dual volatile access in single statement */
-            uint32_t relativeTimePending = tmrActive->relativeTimePending;
             nextHwCounterValue = (uint64_t)counterObj->hwTimerCurrentValue + relativeTimePending;
         }
     }
@@ -207,6 +323,64 @@ static void SYS_TIME_HwTimerCompareUpdate(void)
     counterObj->timePlib->timerCompareSet(counterObj->hwTimerCompareValue);
 }
 
+#if SYS_TIME_TIMER_HEAP
+static bool SYS_TIME_RemoveFromList(SYS_TIME_TIMER_OBJ* delTimer)
+{
+    SYS_TIME_COUNTER_OBJ* counter = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
+    SYS_TIME_TIMER_OBJ* last;
+    uint32_t index;
+
+    /* Not in the heap? return */
+    if (delTimer->heapIndex == 0U)
+    {
+        return false;
+    }
+    index = (uint32_t)delTimer->heapIndex - 1U;
+    delTimer->heapIndex = 0U;
+    timerHeapSize--;
+
+    /* The last timer of the heap takes the place of the deleted one */
+    if (index < timerHeapSize)
+    {
+        last = timerHeap[timerHeapSize];
+        SYS_TIME_HeapPlace(last, index);
+        if ((index > 0U) && (timerHeap[(index - 1U) >> 1]->expiry > last->expiry))
+        {
+            SYS_TIME_HeapSiftUp(index);
+        }
+        else
+        {
+            SYS_TIME_HeapSiftDown(index);
+        }
+    }
+    counter->tmrActive = (timerHeapSize != 0U) ? timerHeap[0] : NULL;
+
+    return index == 0U;
+}
+
+static bool SYS_TIME_AddToList(SYS_TIME_TIMER_OBJ* newTimer)
+{
+    SYS_TIME_COUNTER_OBJ* counter = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    /* Use a non-volatile intermediate to prevent dual volatile access in single statement */
+    uint32_t newTimerTime;
+
+    if ((newTimer == NULL) || (newTimer->heapIndex != 0U))
+    {
+        return false;
+    }
+
+    /* relativeTimePending counts from hwTimerPreviousValue, which swCounter64
+     * stands for */
+    newTimerTime = newTimer->relativeTimePending;
+    newTimer->expiry = SYS_TIME_MonotonicGet() + newTimerTime;
+    timerHeapSize++;
+    timerHeap[timerHeapSize - 1U] = newTimer;
+    SYS_TIME_HeapSiftUp(timerHeapSize - 1U);
+    counter->tmrActive = timerHeap[0];
+
+    return newTimer->heapIndex == 1U;
+}
+#else
 static bool SYS_TIME_RemoveFromList(SYS_TIME_TIMER_OBJ* delTimer)
 {
     SYS_TIME_COUNTER_OBJ* counter = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
@@ -318,6 +492,7 @@ static bool SYS_TIME_AddToList(SYS_TIME_TIMER_OBJ* newTimer)
     }
     return isHeadTimerUpdated;
 }
+#endif
 
 static uint32_t SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
 {
@@ -340,10 +515,25 @@ static uint32_t SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
 
 }
 
+/* Publishes swCounter64 at hwCount for SYS_TIME_TimestampGet(). There is one
+ * writer at a time: the core timer interrupt, or a task that has it disabled
+ * (SYS_TIME_ResourceLock()) or all interrupts off. Readers use the copy the
+ * sequence does not point away from, so neither side waits for the other. */
+static void SYS_TIME_StampPublish(uint32_t hwCount, uint64_t swCount)
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+
+    counterObj->stampSequence++;
+    counterObj->stamp[0].hwCount = hwCount;
+    counterObj->stamp[0].swCount = swCount;
+    counterObj->stampSequence++;
+    counterObj->stamp[1].hwCount = hwCount;
+    counterObj->stamp[1].swCount = swCount;
+}
+
 static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
-    SYS_TIME_TIMER_OBJ* tmrActive = counterObj->tmrActive;
     uint32_t pendingCount = 0;
     uint32_t elapsedCount = 0;
     uint32_t hwTimerCurrentValue;
@@ -354,14 +544,7 @@ static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
     }
     else
     {
-        /* Add time from all timers in the front */
-        while ((tmrActive != NULL) && (tmrActive != tmr))
-        {
-            pendingCount += tmrActive->relativeTimePending;
-            tmrActive = tmrActive->tmrNext;
-        }
-        /* Add the pending time of the requested timer */
-        pendingCount += tmrActive->relativeTimePending;
+        pendingCount = SYS_TIME_PendingCountGet(tmr);
         hwTimerCurrentValue = counterObj->timePlib->timerCounterGet();
         elapsedCount = SYS_TIME_GetElapsedCount(hwTimerCurrentValue);
 
@@ -374,9 +557,9 @@ static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
             pendingCount = 0;
         }
 
-        if (tmrActive->requestedTime >= pendingCount)
+        if (tmr->requestedTime >= pendingCount)
         {
-            elapsedCount = tmrActive->requestedTime - pendingCount;
+            elapsedCount = tmr->requestedTime - pendingCount;
         }
         else
         {
@@ -390,6 +573,10 @@ static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
 static void SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+#if SYS_TIME_TIMER_HEAP
+    /* Expiries are absolute, only the reference point moves on */
+    (void)elapsedCount;
+#else
     SYS_TIME_TIMER_OBJ* tmr = NULL;
 
     tmr = counterObj->tmrActive;
@@ -409,6 +596,7 @@ static void SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
         }
         tmr = tmr->tmrNext;
     }
+#endif
 
     counterObj->hwTimerPreviousValue = counterObj->hwTimerCurrentValue;
 }
@@ -428,6 +616,7 @@ static void SYS_TIME_TimerAdd(SYS_TIME_TIMER_OBJ* newTimer)
 
     interruptState = SYS_INT_Disable();
     counterObj->swCounter64 = counterObj->swCounter64 + elapsedCount;
+    SYS_TIME_StampPublish(counterObj->hwTimerCurrentValue, counterObj->swCounter64);
     SYS_INT_Restore(interruptState);
 
     isHeadTimerUpdated = SYS_TIME_AddToList(newTimer);
@@ -440,18 +629,67 @@ static void SYS_TIME_TimerAdd(SYS_TIME_TIMER_OBJ* newTimer)
     }
 }
 
-static void SYS_TIME_ClientNotify(void)
+static void SYS_TIME_DeferredQueue(SYS_TIME_TIMER_OBJ* tmr)
+{
+    uint32_t head = deferredHead;
+    uint32_t depth = head - deferredTail;
+    SYS_TIME_DEFERRED_ITEM* item;
+
+    if (depth >= (uint32_t)SYS_TIME_DEFERRED_QUEUE_SIZE)
+    {
+        deferredStats.dropped++;
+        return;
+    }
+    item = &deferredQueue[head & ((uint32_t)SYS_TIME_DEFERRED_QUEUE_SIZE - 1U)];
+    item->callback = tmr->callback;
+    item->context = tmr->context;
+    item->expiry = SYS_TIME_MonotonicGet();
+    SYS_TIME_BARRIER();
+    deferredHead = head + 1U;
+    deferredStats.queued++;
+    if (depth + 1U > deferredStats.maxDepth)
+    {
+        deferredStats.maxDepth = depth + 1U;
+    }
+}
+
+/* Returns the chain (tmrExpiredNext) of the periodic timers that expired,
+ * in order of expiry */
+static SYS_TIME_TIMER_OBJ* SYS_TIME_ClientNotify(void)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
     SYS_TIME_TIMER_OBJ* tmrActive = counterObj->tmrActive;
+    SYS_TIME_TIMER_OBJ* expired = NULL;
+    SYS_TIME_TIMER_OBJ* expiredTail = NULL;
 
     while (tmrActive != NULL)
     {
-        if(tmrActive->relativeTimePending == 0U)
+        if(SYS_TIME_HeadPendingGet(tmrActive) == 0U)
         {
+#if SYS_TIME_TIMER_HEAP
+            /* as the list leaves it, SYS_TIME_TimerStart() reloads it */
+            tmrActive->relativeTimePending = 0U;
+#endif
             tmrActive->tmrElapsedFlag = true;
             tmrActive->tmrElapsed = true;
 
+            /* A callback that reloads its timer with count == period makes
+             * it expire again in this loop, it is queued only once */
+            if ((tmrActive->type == SYS_TIME_PERIODIC) && (tmrActive->tmrExpiredQueued == false))
+            {
+                tmrActive->tmrExpiredQueued = true;
+                tmrActive->tmrExpiredNext = NULL;
+                if (expiredTail == NULL)
+                {
+                    expired = tmrActive;
+                }
+                else
+                {
+                    expiredTail->tmrExpiredNext = tmrActive;
+                }
+                expiredTail = tmrActive;
+            }
+
             if ((tmrActive->type == SYS_TIME_SINGLE) && (tmrActive->callback != NULL))
             {
                 /* Destroy single shot timer for which the callback is registered */
@@ -471,7 +709,15 @@ static void SYS_TIME_ClientNotify(void)
 
             if(tmrActive->callback != NULL)
             {
-                tmrActive->callback(tmrActive->context);
+                /* A destroyed single shot timer still holds its callback */
+                if (tmrActive->deferred == true)
+                {
+                    SYS_TIME_DeferredQueue(tmrActive);
+                }
+                else
+                {
+                    tmrActive->callback(tmrActive->context);
+                }
             }
 
             tmrActive = counterObj->tmrActive;
@@ -481,18 +727,22 @@ static void SYS_TIME_ClientNotify(void)
             break;
         }
     }
+
+    return expired;
 }
 
 static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
 {
-    uint8_t i;
+    SYS_TIME_TIMER_OBJ* tmr;
+    SYS_TIME_TIMER_OBJ* tmrNext;
 
     SYS_TIME_UpdateTimerList(elapsedCounts);
 
-    SYS_TIME_ClientNotify();
+    tmr = SYS_TIME_ClientNotify();
 
-    /* Add the removed timers back into the linked list if the timer type is periodic. */
-    for ( i = 0U; i < (uint32_t)SYS_TIME_MAX_TIMERS; i++)
+    /* Add the removed timers back into the linked list if the timer type is
+     * periodic. Only the timers that expired are visited, not the pool. */
+    while (tmr != NULL)
     {
         /* tmrElapsed is cleared anytime a timer is stopped, started, reloaded
          * or destroyed.
@@ -503,17 +753,22 @@ static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
          * Note: tmrElapsedFlag is cleared when the application reads the status
          * by calling the SYS_TIME_TimerPeriodHasExpired API.
          */
-        if (timers[i].tmrElapsed == true)
+        tmrNext = tmr->tmrExpiredNext;
+        tmr->tmrExpiredNext = NULL;
+        tmr->tmrExpiredQueued = false;
+
+        if (tmr->tmrElapsed == true)
         {
-            timers[i].tmrElapsed = false;
+            tmr->tmrElapsed = false;
 
-            if (timers[i].type == SYS_TIME_PERIODIC)
+            if (tmr->type == SYS_TIME_PERIODIC)
             {
                 /* Reload the relative pending time with the requested time */
-                timers[i].relativeTimePending = timers[i].requestedTime;
-               (void) SYS_TIME_AddToList(&timers[i]);
+                tmr->relativeTimePending = tmr->requestedTime;
+               (void) SYS_TIME_AddToList(tmr);
             }
         }
+        tmr = tmrNext;
     }
 }
 
@@ -529,6 +784,7 @@ static void SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
     elapsedCount = SYS_TIME_GetElapsedCount(counterObj->hwTimerCurrentValue);
 
     counterObj->swCounter64 = counterObj->swCounter64 + elapsedCount;
+    SYS_TIME_StampPublish(counterObj->hwTimerCurrentValue, counterObj->swCounter64);
 
     if (tmrActive != NULL)
     {
@@ -574,6 +830,7 @@ static SYS_TIME_HANDLE SYS_TIME_TimerObjectCreate(
                 tmr->requestedTime = period;
                 tmr->callback = callBack;
                 tmr->context = context;
+                tmr->deferred = false;
                 tmr->relativeTimePending = period - count;
 
                 /* Assign a handle to this request. The timer handle must be unique. */
@@ -615,6 +872,8 @@ static void SYS_TIME_CounterInit(SYS_MODULE_INIT* init)
     counterObj->hwTimerCompareValue = SYS_TIME_HW_COUNTER_HALF_PERIOD;
 
     counterObj->swCounter64 = 0;
+    counterObj->swCounterShift = 0;
+    SYS_TIME_StampPublish(0, 0);
     counterObj->tmrActive = NULL;
     counterObj->interruptNestingCount = 0;
 
@@ -650,6 +909,12 @@ SYS_MODULE_OBJ SYS_TIME_Initialize( const SYS_MODULE_INDEX index, const SYS_MODU
 
     SYS_TIME_CounterInit((SYS_MODULE_INIT *)init);
     (void) memset(timers, 0, sizeof(timers));
+#if SYS_TIME_TIMER_HEAP
+    timerHeapSize = 0;
+#endif
+    deferredHead = 0;
+    deferredTail = 0;
+    (void) memset(&deferredStats, 0, sizeof(deferredStats));
 
     gSystemCounterObj.status = SYS_STATUS_READY;
 
@@ -671,6 +936,11 @@ void SYS_TIME_Deinitialize ( SYS_MODULE_OBJ object )
 
    (void) memset(&timers, 0, sizeof(timers));
    (void) memset(&gSystemCounterObj, 0, sizeof(gSystemCounterObj));
+#if SYS_TIME_TIMER_HEAP
+   timerHeapSize = 0;
+#endif
+   deferredHead = 0;
+   deferredTail = 0;
 
     counterObj->status = SYS_STATUS_UNINITIALIZED;
 
@@ -718,6 +988,55 @@ uint64_t SYS_TIME_Counter64Get ( void )
     return counter64;
 }
 
+/* SYS_TIME_Counter64Get() on SYS_TIME_MonotonicGet() */
+static uint64_t SYS_TIME_MonotonicCounter64Get ( void )
+{
+    SYS_TIME_COUNTER_OBJ * counterObj = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
+    uint64_t counter64;
+    uint32_t elapsedCount;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    elapsedCount = SYS_TIME_GetElapsedCount(counterObj->timePlib->timerCounterGet());
+
+    counter64 = SYS_TIME_MonotonicGet() + elapsedCount;
+
+    SYS_INT_Restore(interruptState);
+
+    return counter64;
+}
+
+uint64_t SYS_TIME_TimestampGet ( void )
+{
+    SYS_TIME_COUNTER_OBJ * counterObj = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
+    uint32_t sequence;
+    uint32_t hwCount;
+    uint32_t hwTimerCurrentValue;
+    uint32_t elapsedCount;
+    uint64_t swCount;
+
+    do
+    {
+        sequence = counterObj->stampSequence;
+        hwCount = counterObj->stamp[sequence & 1U].hwCount;
+        swCount = counterObj->stamp[sequence & 1U].swCount;
+        hwTimerCurrentValue = counterObj->timePlib->timerCounterGet();
+        /* A publication in between may be newer than the hardware count */
+    } while (sequence != counterObj->stampSequence);
+
+    if (hwTimerCurrentValue >= hwCount)
+    {
+        elapsedCount = hwTimerCurrentValue - hwCount;
+    }
+    else
+    {
+        elapsedCount = (SYS_TIME_HW_COUNTER_PERIOD - hwCount) + hwTimerCurrentValue + 1U;
+    }
+
+    return swCount + elapsedCount;
+}
+
 uint32_t SYS_TIME_CounterGet ( void )
 {
     uint32_t counter32;
@@ -733,7 +1052,10 @@ void SYS_TIME_CounterSet ( uint32_t count )
 
     interruptState = SYS_INT_Disable();
 
+    /* Timers keep their expiry, see SYS_TIME_MonotonicGet() */
+    gSystemCounterObj.swCounterShift += (uint64_t)count - gSystemCounterObj.swCounter64;
     gSystemCounterObj.swCounter64 = count;
+    SYS_TIME_StampPublish(gSystemCounterObj.hwTimerPreviousValue, count);
 
     SYS_INT_Restore(interruptState);
 }
@@ -1093,3 +1415,70 @@ SYS_TIME_HANDLE SYS_TIME_CallbackRegisterMS ( SYS_TIME_CALLBACK callback, uintpt
 
     return handle;
 }
+
+static SYS_TIME_HANDLE SYS_TIME_DeferredRegister ( SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t count, SYS_TIME_CALLBACK_TYPE type )
+{
+    SYS_TIME_HANDLE handle = SYS_TIME_HANDLE_INVALID;
+    SYS_TIME_TIMER_OBJ *tmr;
+
+    /* A deferred timer without callback would never queue anything */
+    if ((callback == NULL) || (count == 0U))
+    {
+        return handle;
+    }
+
+    handle = SYS_TIME_TimerObjectCreate(0, count, callback, context, type);
+    if(handle != SYS_TIME_HANDLE_INVALID)
+    {
+        /* Not started yet, the interrupt does not see it */
+        tmr = SYS_TIME_GetTimerObject(handle);
+        tmr->deferred = true;
+        (void) SYS_TIME_TimerStart(handle);
+    }
+
+    return handle;
+}
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterDeferredUS ( SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t us, SYS_TIME_CALLBACK_TYPE type )
+{
+    return SYS_TIME_DeferredRegister(callback, context, SYS_TIME_USToCount(us), type);
+}
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterDeferredMS ( SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t ms, SYS_TIME_CALLBACK_TYPE type )
+{
+    return SYS_TIME_DeferredRegister(callback, context, SYS_TIME_MSToCount(ms), type);
+}
+
+void SYS_TIME_DeferredTasks ( void )
+{
+    uint32_t budget = SYS_TIME_DEFERRED_BUDGET;
+    uint32_t tail = deferredTail;
+    SYS_TIME_DEFERRED_ITEM item;
+    uint64_t latency;
+
+    while ((budget != 0U) && (tail != deferredHead))
+    {
+        SYS_TIME_BARRIER();
+        item = deferredQueue[tail & ((uint32_t)SYS_TIME_DEFERRED_QUEUE_SIZE - 1U)];
+        /* The slot is free again, the callback may restart its timer */
+        SYS_TIME_BARRIER();
+        tail++;
+        deferredTail = tail;
+        budget--;
+
+        latency = SYS_TIME_MonotonicCounter64Get() - item.expiry;
+        deferredStats.run++;
+        deferredStats.latencySum += latency;
+        if (latency > deferredStats.latencyMax)
+        {
+            deferredStats.latencyMax = (latency < UINT32_MAX) ? (uint32_t)latency : UINT32_MAX;
+        }
+
+        item.callback(item.context);
+    }
+}
+
+void SYS_TIME_DeferredStatsGet ( SYS_TIME_DEFERRED_STATS* stats )
+{
+    *stats = deferredStats;
+}
@@ -103,9 +103,29 @@ typedef struct SYS_TIME_TIMER_OBJ_T{
       volatile bool                 tmrElapsedFlag;   /* Set on every timer expiry. Cleared after user reads the status. */
       volatile bool                 tmrElapsed;    /* Set on every timer expiry. Cleared after timer is added back to the list */
       struct SYS_TIME_TIMER_OBJ_T*   tmrNext; /* Next timer */
+      struct SYS_TIME_TIMER_OBJ_T*   tmrExpiredNext; /* Next periodic timer to re-arm after this interrupt */
+      bool                          tmrExpiredQueued; /* TRUE while in the chain of tmrExpiredNext */
       SYS_TIME_HANDLE               tmrHandle; /* Unique handle for object */
+      bool                          deferred; /* callback queued for SYS_TIME_DeferredTasks() */
+#if SYS_TIME_TIMER_HEAP
+      uint64_t                      expiry;    /* SYS_TIME_MonotonicGet() value at which the timer expires */
+      uint16_t                      heapIndex; /* position in the heap + 1, 0 when not in it */
+#endif
 } SYS_TIME_TIMER_OBJ;
 
+/* A callback queued by the interrupt, run by SYS_TIME_DeferredTasks() */
+typedef struct{
+    SYS_TIME_CALLBACK   callback;
+    uintptr_t           context;
+    uint64_t            expiry;    /* SYS_TIME_MonotonicGet() of the interrupt that queued it */
+} SYS_TIME_DEFERRED_ITEM;
+
+/* The 64-bit counter at one hardware count, read by SYS_TIME_TimestampGet() */
+typedef struct{
+    uint32_t            hwCount;
+    uint64_t            swCount;
+} SYS_TIME_STAMP;
+
 
 typedef struct{
     SYS_STATUS status;
@@ -118,6 +138,9 @@ typedef struct{
     volatile uint32_t               hwTimerCompareValue;
     uint32_t                        hwTimerCompareMargin;
     volatile uint64_t               swCounter64;           /* Software 64-bit counter */
+    uint64_t                        swCounterShift;        /* sum of the steps of SYS_TIME_CounterSet() */
+    volatile uint32_t               stampSequence;         /* odd while stamp[0] is written */
+    volatile SYS_TIME_STAMP         stamp[2];              /* two copies of the last published pair */
     uint8_t                         interruptNestingCount;
     bool                            hwTimerIntStatus;
     SYS_TIME_TIMER_OBJ*             tmrActive;
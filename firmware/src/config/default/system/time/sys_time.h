@@ -689,6 +689,41 @@ SYS_TIME_HANDLE SYS_TIME_CallbackRegisterUS ( SYS_TIME_CALLBACK callback, uintpt
 SYS_TIME_HANDLE SYS_TIME_CallbackRegisterMS ( SYS_TIME_CALLBACK callback, uintptr_t context,
                                               uint32_t ms, SYS_TIME_CALLBACK_TYPE type );
 
+// *****************************************************************************
+/* Deferred callbacks
+
+   SYS_TIME_CallbackRegisterDeferredUS/MS() take the same arguments as
+   SYS_TIME_CallbackRegisterUS/MS(), but on expiry the interrupt only queues
+   the callback. SYS_TIME_DeferredTasks(), called from SYS_Tasks(), runs up to
+   SYS_TIME_DEFERRED_BUDGET of them per call in order of expiry. Callbacks
+   registered with the other functions still run in the interrupt, for work
+   that cannot wait for the next SYS_Tasks() round.
+
+   The queue holds SYS_TIME_DEFERRED_QUEUE_SIZE callbacks. When it is full an
+   expiry is dropped and counted, the timer keeps running. A callback that was
+   queued runs even if its timer is stopped or destroyed meanwhile.
+*/
+
+typedef struct
+{
+    uint32_t queued;        /* callbacks queued by the interrupt */
+    uint32_t dropped;       /* expiries lost, the queue was full */
+    uint32_t maxDepth;      /* most callbacks waiting at once */
+    uint32_t run;           /* callbacks run by SYS_TIME_DeferredTasks() */
+    uint64_t latencySum;    /* counter ticks from the interrupt to the call */
+    uint32_t latencyMax;
+} SYS_TIME_DEFERRED_STATS;
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterDeferredUS ( SYS_TIME_CALLBACK callback, uintptr_t context,
+                                                      uint32_t us, SYS_TIME_CALLBACK_TYPE type );
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterDeferredMS ( SYS_TIME_CALLBACK callback, uintptr_t context,
+                                                      uint32_t ms, SYS_TIME_CALLBACK_TYPE type );
+
+void SYS_TIME_DeferredTasks ( void );
+
+void SYS_TIME_DeferredStatsGet ( SYS_TIME_DEFERRED_STATS* stats );
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -824,6 +859,25 @@ uint32_t SYS_TIME_CounterGet ( void );
 
 uint64_t SYS_TIME_Counter64Get ( void );
 
+// *****************************************************************************
+/* Lock-free 64-bit counter
+
+   SYS_TIME_TimestampGet() returns the same value as SYS_TIME_Counter64Get()
+   without disabling interrupts, for timestamps taken by interrupt handlers
+   and tasks on every event. Whenever the 64-bit counter moves on (the core
+   timer interrupt, a timer start, SYS_TIME_CounterSet()) the pair of
+   hardware count and 64-bit count is published twice, and a sequence number
+   tells readers which copy is not being written. A reader adds the hardware
+   count elapsed since its copy, and reads again only when the sequence
+   changed meanwhile. Interrupt handlers do not nest, so a reader in a
+   handler never reads twice, and no reader ever waits for a writer.
+
+   The value lies between the hardware count at the call and at the return,
+   in tasks and handlers alike.
+*/
+
+uint64_t SYS_TIME_TimestampGet ( void );
+
 // *****************************************************************************
 /* Function:
     void SYS_TIME_CounterSet ( uint32_t count )
@@ -73,7 +73,8 @@
 void SYS_Tasks ( void )
 {
     /* Maintain system services */
-    
+    /* SYS_TIME callbacks deferred out of the core timer interrupt */
+    SYS_TIME_DeferredTasks();
 
 
     /* Maintain Device Drivers */
@@ -82,10 +83,19 @@ void SYS_Tasks ( void )
     /* Maintain Middleware & Other Libraries */
     
 
+    /* Console rate: start-up, auto-baud and rate switch */
+    APP_BAUD_Tasks();
+
     /* Maintain the application's state machine. */
         /* Call Application task APP. */
     APP_Tasks();
 
+    /* Console shell: bounded work per call, answers after the log records */
+    APP_SHELL_Tasks();
+
+    /* Lowest priority: format and write the deferred log records */
+    APP_LOG_Tasks();
+
 
 
 
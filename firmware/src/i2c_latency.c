@@ -0,0 +1,171 @@
+/*******************************************************************************
+  I2C Latency Instrumentation
+
+  File Name:
+    i2c_latency.c
+
+  Summary:
+    Per stage latency statistics of I2C transfers (see i2c_latency.h).
+*******************************************************************************/
+
+#include <string.h>
+#include "device.h"
+#include "i2c_latency.h"
+
+static const char* const i2cLatStageNames[I2C_LAT_STAGE_NUMBER] =
+{
+    "queue", "start-isr", "isr-isr", "bus", "stop-plib", "plib-client", "total"
+};
+
+#if I2C_LATENCY_ENABLE
+
+// points of the transfer in flight
+typedef struct
+{
+    uint32_t submit;
+    uint32_t start;
+    uint32_t isr;
+    uint32_t stop;
+    uint32_t plibCb;
+    // which of the above belong to this transfer
+    bool submitValid;
+    bool startValid;
+    bool isrValid;
+    bool stopValid;
+    bool plibCbValid;
+} I2C_LAT_RECORD;
+
+static I2C_LAT_RECORD i2cLatRecord;
+static I2C_LAT_STATS i2cLatStats[I2C_LAT_STAGE_NUMBER];
+
+static void I2C_LAT_Sample(I2C_LAT_STAGE stage, uint32_t ticks)
+{
+    I2C_LAT_STATS* stats = &i2cLatStats[stage];
+    uint32_t bucket = 31u - (uint32_t)__builtin_clz(ticks | 1u);
+
+    if (bucket >= I2C_LAT_BUCKETS)
+    {
+        bucket = I2C_LAT_BUCKETS - 1u;
+    }
+    stats->histogram[bucket]++;
+    if ((stats->count == 0u) || (ticks < stats->min))
+    {
+        stats->min = ticks;
+    }
+    if (ticks > stats->max)
+    {
+        stats->max = ticks;
+    }
+    stats->sum += ticks;
+    stats->count++;
+}
+
+void I2C_LAT_TransferBegin(uint32_t submitTicks)
+{
+    uint32_t now = _CP0_GET_COUNT();
+
+    I2C_LAT_Sample(I2C_LAT_STAGE_QUEUE, now - submitTicks);
+    i2cLatRecord = (I2C_LAT_RECORD){ .submit = submitTicks, .submitValid = true };
+}
+
+void I2C_LAT_Mark(I2C_LAT_POINT point)
+{
+    uint32_t now = _CP0_GET_COUNT();
+    I2C_LAT_RECORD* rec = &i2cLatRecord;
+
+    switch (point)
+    {
+        case I2C_LAT_POINT_START:
+            // also the start of every further item of a batch
+            rec->start = now;
+            rec->startValid = true;
+            rec->isrValid = false;
+            rec->stopValid = false;
+            rec->plibCbValid = false;
+            break;
+
+        case I2C_LAT_POINT_ISR:
+            if (rec->isrValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_ISR_ISR, now - rec->isr);
+            }
+            else if (rec->startValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_START_ISR, now - rec->start);
+            }
+            else
+            {
+                // not part of a transfer the PLIB started
+                break;
+            }
+            rec->isr = now;
+            rec->isrValid = true;
+            break;
+
+        case I2C_LAT_POINT_STOP:
+            if (rec->startValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_BUS, now - rec->start);
+            }
+            rec->stop = now;
+            rec->stopValid = true;
+            break;
+
+        case I2C_LAT_POINT_PLIB_CB:
+            if (rec->stopValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_STOP_PLIB, now - rec->stop);
+            }
+            // the transfer is off the bus, a late ISR mark must not extend it
+            rec->startValid = false;
+            rec->isrValid = false;
+            rec->stopValid = false;
+            rec->plibCb = now;
+            rec->plibCbValid = true;
+            break;
+
+        case I2C_LAT_POINT_CLIENT_CB:
+            if (rec->plibCbValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_PLIB_CLIENT, now - rec->plibCb);
+            }
+            if (rec->submitValid)
+            {
+                I2C_LAT_Sample(I2C_LAT_STAGE_TOTAL, now - rec->submit);
+            }
+            *rec = (I2C_LAT_RECORD){ 0 };
+            break;
+
+        default:
+            break;
+    }
+}
+
+#endif
+
+bool I2C_LAT_StatsGet(I2C_LAT_STAGE stage, I2C_LAT_STATS* stats)
+{
+#if I2C_LATENCY_ENABLE
+    if ((stage < I2C_LAT_STAGE_NUMBER) && (stats != NULL))
+    {
+        *stats = i2cLatStats[stage];
+        return true;
+    }
+#else
+    (void)stage;
+    (void)stats;
+#endif
+    return false;
+}
+
+void I2C_LAT_StatsReset(void)
+{
+#if I2C_LATENCY_ENABLE
+    memset(i2cLatStats, 0, sizeof(i2cLatStats));
+#endif
+}
+
+const char* I2C_LAT_StageName(I2C_LAT_STAGE stage)
+{
+    return (stage < I2C_LAT_STAGE_NUMBER) ? i2cLatStageNames[stage] : "?";
+}
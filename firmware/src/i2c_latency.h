@@ -0,0 +1,109 @@
+/*******************************************************************************
+  I2C Latency Instrumentation Header File
+
+  File Name:
+    i2c_latency.h
+
+  Summary:
+    Interrupt-to-completion latency of the I2C stack, in CP0 core timer ticks.
+
+  Description:
+    The DRV_I2C driver and the I2C1 PLIB mark the key points of every transfer
+    with _CP0_GET_COUNT(): transfer add, hand-over to the PLIB, START, every
+    I2C1 interrupt entry, STOP, the PLIB callback and the client event
+    handler. The time between consecutive points is accumulated per stage as
+    min/max/avg and a log2 histogram.
+
+    Only one transfer is on the bus at a time, so the points of the transfer
+    in flight are kept in a single record. All marks except the transfer add
+    run in the I2C1 interrupt or with it disabled.
+
+    The core timer runs at SYSCLK/2, one tick is 2 SYSCLK cycles (41.7 ns at
+    48 MHz). Stages up to 2^32 ticks (~179 s) are measured correctly.
+
+    Disabled (I2C_LATENCY_ENABLE 0, the default) the marks compile to nothing
+    and DRV_I2C_TRANSFER_OBJ keeps its size.
+*******************************************************************************/
+
+#ifndef _I2C_LATENCY_H
+#define _I2C_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+#ifndef I2C_LATENCY_ENABLE
+#define I2C_LATENCY_ENABLE 0
+#endif
+
+// points marked by the PLIB and the driver, see I2C_LAT_MARK()
+typedef enum
+{
+    I2C_LAT_POINT_START = 0,    // PLIB generates the START condition
+    I2C_LAT_POINT_ISR,          // entry of I2C_1_InterruptHandler
+    I2C_LAT_POINT_STOP,         // PLIB generates the STOP condition
+    I2C_LAT_POINT_PLIB_CB,      // driver PLIB callback entered
+    I2C_LAT_POINT_CLIENT_CB,    // client event handler about to be called
+} I2C_LAT_POINT;
+
+typedef enum
+{
+    I2C_LAT_STAGE_QUEUE = 0,    // transfer add -> handed to the PLIB
+    I2C_LAT_STAGE_START_ISR,    // START -> first I2C1 interrupt
+    I2C_LAT_STAGE_ISR_ISR,      // between I2C1 interrupts of one transfer
+    I2C_LAT_STAGE_BUS,          // START -> STOP
+    I2C_LAT_STAGE_STOP_PLIB,    // STOP -> PLIB callback
+    I2C_LAT_STAGE_PLIB_CLIENT,  // PLIB callback -> client event handler
+    I2C_LAT_STAGE_TOTAL,        // transfer add -> client event handler
+    I2C_LAT_STAGE_NUMBER
+} I2C_LAT_STAGE;
+
+// bucket i counts samples with 2^i <= ticks < 2^(i+1) (bucket 0 includes 0),
+// the last one everything above
+#define I2C_LAT_BUCKETS 20u
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[I2C_LAT_BUCKETS];
+} I2C_LAT_STATS;
+
+#if I2C_LATENCY_ENABLE
+
+/* Called by the driver when it hands a transfer added at submitTicks to the
+   PLIB. For a batch only before its first item: the other items are measured
+   from START on and the total runs to the client event handler of the batch. */
+void I2C_LAT_TransferBegin(uint32_t submitTicks);
+
+void I2C_LAT_Mark(I2C_LAT_POINT point);
+
+#define I2C_LAT_MARK(point) I2C_LAT_Mark(point)
+
+#else
+
+#define I2C_LAT_MARK(point) do { } while (0)
+
+#endif
+
+/* Copy of the statistics of one stage. Taken with interrupts enabled the copy
+   can mix two samples. Returns false for an invalid stage or when the
+   instrumentation is compiled out. */
+bool I2C_LAT_StatsGet(I2C_LAT_STAGE stage, I2C_LAT_STATS* stats);
+
+void I2C_LAT_StatsReset(void);
+
+const char* I2C_LAT_StageName(I2C_LAT_STAGE stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_LATENCY_H */